@@ -24,6 +24,7 @@
 #include "math/MathTypes.h"
 
 #include "physics/PhysicsWorld.h"
+#include "system/JobManager.h"
 
 namespace hpl {
 
@@ -37,6 +38,9 @@ namespace hpl {
 	#define eAIFreePathFlag_SkipDynamic	 (0x00000002)
 	#define eAIFreePathFlag_SkipVolatile (0x00000004)
 
+	#define AI_NODE_CACHE_MAGIC_NUMBER	0x4E494148
+	#define AI_NODE_CACHE_VERSION		2
+
 	
 	//--------------------------------
 	class cAINode;
@@ -74,6 +78,7 @@ namespace hpl {
 	private:
 		tString msName;
 		int mlID;
+		int mlIndex;
 		cVector3f mvPosition;
 		void *mpUserData;
 
@@ -132,6 +137,25 @@ namespace hpl {
 	//--------------------------------
 	class cAINodeContainer;
 
+	/**
+	 * Tests free paths for a range of node pairs when compiling a container.
+	 */
+	class cAINodeEdgeJob : public iJob
+	{
+	public:
+		void Execute(int alThreadIndex);
+
+		cAINodeContainer *mpContainer;
+		const cVector2l *mpPairs;
+		char *mpResults;
+		int mlNumOfPairs;
+
+	private:
+		cAINodeRayCallback mRayCallback;
+	};
+
+	//--------------------------------
+
 	class cAINodeIterator
 	{
 	public:
@@ -159,6 +183,7 @@ namespace hpl {
 	class cAINodeContainer
 	{
 	friend class cAINodeIterator;
+	friend class cAINodeEdgeJob;
 	public:
 		cAINodeContainer(	const tString& asName,const tString &asNodeName,
 							cWorld *apWorld, const cVector3f &avCollideSize);
@@ -203,7 +228,7 @@ namespace hpl {
 
 
 		/**
-		 * Compile the added nodes.
+		 * Compile the added nodes. Each node pair in reach is tested once, spread over the job manager of the physics world.
 		 */
 		void Compile();
 
@@ -264,15 +289,25 @@ namespace hpl {
 
 
 		/**
-		 * Saves all the node connections to file.
+		 * Saves all the node connections to a binary cache file, stamped with hashes of the nodes and the static geometry.
 		 */
 		void SaveToFile(const tWString &asFile);
 		/**
 		* Loads all node connections from file. Only to be done after all nodes are loaded.
+		* \param abAllowUnstamped If old XML files (that has no stamp to check) may be loaded.
+		* \return false if the file could not be loaded or does not match the current nodes or geometry. No edges are added then.
 		*/
-		void LoadFromFile(const tWString &asFile);
+		bool LoadFromFile(const tWString &asFile, bool abAllowUnstamped=true);
+
+		unsigned int GetNodeSetHash();
+		unsigned int GetStaticGeometryHash();
 
 	private:
+		bool FreePath(const cVector3f &avStart, const cVector3f &avEnd, int alRayNum, tAIFreePathFlag aFlags, 
+						iAIFreePathCallback *apCallback, cAINodeRayCallback *apRayCallback);
+		bool LoadFromXmlFile(const tWString &asFile);
+		void ClearEdges();
+
 		cVector2l GetGridPosFromLocal(const cVector2f &avLocalPos);
 		cAIGridNode* GetGrid(const cVector2l& avPos);
 
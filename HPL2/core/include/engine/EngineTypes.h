@@ -30,7 +30,8 @@ namespace hpl {
 
 	enum eHplAPI
 	{
-		eHplAPI_OpenGL
+		eHplAPI_OpenGL,
+		eHplAPI_Null,	// No drawing and no GL context, used for benchmarking the renderer on the CPU.
 	};
 
 	//---------------------------------------
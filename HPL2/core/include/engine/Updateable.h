@@ -28,40 +28,42 @@ namespace hpl {
 	class iUpdateable
 	{
 	public:
-		iUpdateable(const tString& asName) : msName(asName){}
+		iUpdateable(const tString& asName) : msName(asName), mlUnusedMessages(0){}
 		virtual ~iUpdateable() {}
 
-		virtual void OnPostBufferSwap(){}
+		//The default implementations mark the message as unused, so cUpdater can stop sending it.
 
-		virtual void OnStart(){}
+		virtual void OnPostBufferSwap(){ SetMessageUnused(eUpdateableMessage_OnPostBufferSwap);}
 
-		virtual void OnDraw(float afFrameTime){}
-		virtual void OnPostRender(float afFrameTime){}
+		virtual void OnStart(){ SetMessageUnused(eUpdateableMessage_OnStart);}
+
+		virtual void OnDraw(float afFrameTime){ SetMessageUnused(eUpdateableMessage_OnDraw);}
+		virtual void OnPostRender(float afFrameTime){ SetMessageUnused(eUpdateableMessage_OnPostRender);}
 		
-		virtual void PreUpdate(float afTimeStep){}
-		virtual void Update(float afTimeStep){}
-		virtual void PostUpdate(float afTimeStep){}
+		virtual void PreUpdate(float afTimeStep){ SetMessageUnused(eUpdateableMessage_PreUpdate);}
+		virtual void Update(float afTimeStep){ SetMessageUnused(eUpdateableMessage_Update);}
+		virtual void PostUpdate(float afTimeStep){ SetMessageUnused(eUpdateableMessage_PostUpdate);}
 
-		virtual void OnPauseUpdate(float afTimeStep){}
+		virtual void OnPauseUpdate(float afTimeStep){ SetMessageUnused(eUpdateableMessage_OnPauseUpdate);}
 
-		virtual void OnQuit(){}
-		virtual void OnExit(){}
+		virtual void OnQuit(){ SetMessageUnused(eUpdateableMessage_OnQuit);}
+		virtual void OnExit(){ SetMessageUnused(eUpdateableMessage_OnExit);}
 
-		virtual void Reset(){}
+		virtual void Reset(){ SetMessageUnused(eUpdateableMessage_Reset);}
 
 		virtual void OnEnterContainer(const tString& asOldContainer){}
 		virtual void OnLeaveContainer(const tString& asNewContainer){}
 
-		virtual void AppGotInputFocus(){}
-		virtual void AppGotMouseFocus(){}
-		virtual void AppGotVisibility(){}
+		virtual void AppGotInputFocus(){ SetMessageUnused(eUpdateableMessage_AppGotInputFocus);}
+		virtual void AppGotMouseFocus(){ SetMessageUnused(eUpdateableMessage_AppGotMouseFocus);}
+		virtual void AppGotVisibility(){ SetMessageUnused(eUpdateableMessage_AppGotVisibility);}
 
-		virtual void AppLostInputFocus(){}
-		virtual void AppLostMouseFocus(){}
-		virtual void AppLostVisibility(){}
+		virtual void AppLostInputFocus(){ SetMessageUnused(eUpdateableMessage_AppLostInputFocus);}
+		virtual void AppLostMouseFocus(){ SetMessageUnused(eUpdateableMessage_AppLostMouseFocus);}
+		virtual void AppLostVisibility(){ SetMessageUnused(eUpdateableMessage_AppLostVisibility);}
 
-		virtual void AppDeviceWasPlugged(){}
-		virtual void AppDeviceWasRemoved(){}
+		virtual void AppDeviceWasPlugged(){ SetMessageUnused(eUpdateableMessage_AppDeviceWasPlugged);}
+		virtual void AppDeviceWasRemoved(){ SetMessageUnused(eUpdateableMessage_AppDeviceWasRemoved);}
 
 		void RunMessage(eUpdateableMessage aMessage, float afX)
 		{
@@ -113,8 +115,16 @@ namespace hpl {
 		
 		const tString& GetName(){ return msName;}
 
+		/**
+		 * True if the callback for the message is not implemented (the default version has been called).
+		 */
+		bool IsMessageUnused(eUpdateableMessage aMessage){ return (mlUnusedMessages & (1 << aMessage))!=0;}
+
 	private:
+		void SetMessageUnused(eUpdateableMessage aMessage){ mlUnusedMessages |= (1 << aMessage);}
+
 		tString msName;
+		unsigned int mlUnusedMessages;
 	};
 };
 
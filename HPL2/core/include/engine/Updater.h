@@ -20,8 +20,7 @@
 #ifndef HPL_UPDATER_H
 #define HPL_UPDATER_H
 
-#include <map>
-#include <list>
+#include <vector>
 
 #include "engine/EngineTypes.h"
 #include "system/SystemTypes.h"
@@ -31,11 +30,29 @@ namespace hpl {
 	class iUpdateable;
 	class iLowLevelSystem;
 
-	typedef std::list<iUpdateable*> tUpdateableList;
-	typedef tUpdateableList::iterator tUpdateableListIt;
+	typedef std::vector<iUpdateable*> tUpdateableVec;
+	typedef tUpdateableVec::iterator tUpdateableVecIt;
 
-	typedef std::map<tString, tUpdateableList> tUpdateContainerMap;
-	typedef tUpdateContainerMap::iterator tUpdateContainerMapIt;
+	//------------------------------------------
+
+	/**
+	 * All updateables in a container, and for each message only those that implement it.
+	 * An updateable stays in a message list until the default (empty) callback is found to be called.
+	 */
+	class cUpdateContainer
+	{
+	public:
+		void Add(iUpdateable* apUpdate);
+		void RemoveUnused(eUpdateableMessage aMessage);
+
+		tString msName;
+		tUpdateableVec mvUpdateables;
+		tUpdateableVec mvMessageUpdateables[eUpdateableMessage_LastEnum];
+	};
+
+	typedef std::vector<cUpdateContainer*> tUpdateContainerVec;
+
+	//------------------------------------------
 
 	class cUpdater
 	{
@@ -54,6 +71,15 @@ namespace hpl {
 		 * \return 
 		 */
 		bool SetContainer(tString asContainer);
+		/**
+		 * Sets the active update container from an id got from GetContainerId.
+		 */
+		bool SetContainer(int alId);
+
+		/**
+		 * Gets the id of a container, -1 if not found.
+		 */
+		int GetContainerId(const tString& asName);
 
 		/**
 		 * Gets the name of the current container in use.
@@ -82,14 +108,17 @@ namespace hpl {
 		bool AddGlobalUpdate(iUpdateable* apUpdate);
 	
 	private:
-		tString msCurrentUpdates;
+		void RunMessageInContainer(cUpdateContainer *apContainer, eUpdateableMessage aMessage, float afX, bool abStopAtContainerChange);
 
-        tUpdateContainerMap m_mapUpdateContainer;
+		tUpdateContainerVec mvUpdateContainers;
+		std::vector<int> mvSortedContainerIds;
 
 		iLowLevelSystem *mpLowLevelSystem;
 		
-		tUpdateableList *mpCurrentUpdates;
-		tUpdateableList mlstGlobalUpdateableList;
+		int mlCurrentContainer;
+		cUpdateContainer mGlobalContainer;
+
+		int mlMessageDepth;
 	};
 };
 #endif // HPL_UPDATER_H
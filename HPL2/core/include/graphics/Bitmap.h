@@ -84,6 +84,12 @@ namespace hpl {
 		void SetPixel(int alImage, int alMipMapLevel, const cVector3l& avPixelPos, unsigned char* apPixelData);
 		void GetPixel(int alImage, int alMipMapLevel, const cVector3l& avPixelPos, unsigned char* apDestPixelData);
 
+		/**
+		 * Creates a new bitmap that fits inside avMaxSize (keeping aspect) using a box filter.
+		 * Only works on uncompressed 2D data with byte channels. Returns NULL if not possible.
+		 */
+		cBitmap* CreateDownscaledCopy(const cVector2l& avMaxSize, int alImage=0, int alMipMap=0);
+
 		
 	private:
 		void CopyPixel(	unsigned char* apDest, ePixelFormat aDestFormat, 
@@ -135,6 +135,8 @@ namespace hpl {
 
 		tVector3fVec mvTransformedBases;
 		tMatrixfVec mvMatrices;
+
+		tIntVec mvClipTriangles;
 	};
 
 };
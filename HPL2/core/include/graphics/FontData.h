@@ -91,6 +91,11 @@ namespace hpl {
 		inline unsigned short GetLastChar(){ return mlLastChar;}
 
 		inline const cVector2f& GetSizeRatio()const{ return mvSizeRatio;}
+
+		/**
+		 * Unique for every font created, so cached data can tell a font from an earlier one at the same address.
+		 */
+		inline unsigned int GetFontId()const{ return mlFontId;}
 		
 		/**
 		 * Draw a string.
@@ -156,6 +161,8 @@ namespace hpl {
 
 		cVector2f mvSizeRatio;
 
+		unsigned int mlFontId;
+
 		cGlyph* CreateGlyph(cFrameSubImage* apImage, const cVector2l &avOffset,const cVector2l &avSize,
 							const cVector2l& avFontSize, int alAdvance);
 		void AddGlyph(cGlyph *apGlyph);
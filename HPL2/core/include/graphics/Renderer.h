@@ -25,6 +25,7 @@
 #include "scene/SceneTypes.h"
 
 #include "graphics/RenderFunctions.h"
+#include "system/LinearAllocator.h"
 
 namespace hpl {
 
@@ -56,15 +57,43 @@ namespace hpl {
 		iRenderableContainerNode *mpNode;
 		iOcclusionQuery *mpQuery;
 		bool mbObjectsRendered;
+		cNodeOcclusionPair *mpNext;
 	};
 
-	typedef std::list<cNodeOcclusionPair> tNodeOcclusionPairList;
-	typedef tNodeOcclusionPairList::iterator tNodeOcclusionPairListIt;
+	/**
+	 * Queue of pairs, the pairs are allocated from the frame allocator of the renderer and are never freed one by one.
+	 */
+	class cNodeOcclusionPairQueue
+	{
+	public:
+		cNodeOcclusionPairQueue() : mpFirst(NULL), mpLast(NULL) {}
+
+		bool IsEmpty(){ return mpFirst==NULL;}
+		cNodeOcclusionPair* GetFirst(){ return mpFirst;}
+
+		void Add(cNodeOcclusionPair *apPair)
+		{
+			apPair->mpNext = NULL;
+			if(mpLast)	mpLast->mpNext = apPair;
+			else		mpFirst = apPair;
+			mpLast = apPair;
+		}
+		void RemoveFirst()
+		{
+			mpFirst = mpFirst->mpNext;
+			if(mpFirst==NULL) mpLast = NULL;
+		}
+
+	private:
+		cNodeOcclusionPair *mpFirst;
+		cNodeOcclusionPair *mpLast;
+	};
 
 	//---------------------------------------------
 
-	typedef std::multimap<void*, cOcclusionQueryObject*> tOcclusionQueryObjectMap;
-	typedef tOcclusionQueryObjectMap::iterator tOcclusionQueryObjectMapIt;
+	typedef std::pair<void*, cOcclusionQueryObject*> tOcclusionQueryObjectPair;
+	typedef std::vector<tOcclusionQueryObjectPair> tOcclusionQueryObjectPairVec;
+	typedef tOcclusionQueryObjectPairVec::iterator tOcclusionQueryObjectPairVecIt;
 
 	//---------------------------------------------
 
@@ -140,7 +169,8 @@ namespace hpl {
 
 		int mlCurrentOcclusionObject;
 		std::vector<cOcclusionQueryObject*> mvOcclusionObjectPool;
-		tOcclusionQueryObjectMap m_setOcclusionObjects;
+		tOcclusionQueryObjectPairVec mvOcclusionObjects;	//Sorted by source when first searched
+		bool mbOcclusionObjectsSorted;
 
 		std::vector<cFogAreaRenderData> mvFogRenderData;
 
@@ -351,7 +381,7 @@ namespace hpl {
 		int RenderAndAddNodeObjects(iRenderableContainerNode *apNode, tRenderCHCObjectCallbackFunc apRenderCallback, tRenderableFlag alNeededFlags);
 		
 		void PushNodeChildrenToStack(tRendererSortedNodeSet& a_setNodeStack, iRenderableContainerNode *apNode, int alNeededFlags);
-		void AddAndRenderNodeOcclusionQuery(tNodeOcclusionPairList *apList, iRenderableContainerNode *apNode, bool abObjectsRendered);
+		void AddAndRenderNodeOcclusionQuery(cNodeOcclusionPairQueue *apQueue, iRenderableContainerNode *apNode, bool abObjectsRendered);
 
 		bool CheckShadowCasterContributesToView(iRenderable *apObject);
 		void GetShadowCastersIterative(iRenderableContainerNode *apNode, eCollision aPrevCollision);
@@ -481,6 +511,12 @@ namespace hpl {
 
 		std::vector<cShadowMapData*> mvShadowMapData[eShadowMapResolution_LastEnum];
 
+		/**
+		 * Temporary data for the current frame. Reset at the start of BeginRendering, which includes nested reflection
+		 * rendering, so data from it must not be kept across such a call.
+		 */
+		cLinearAllocator mFrameAllocator;
+
 		float mfTempAlpha;
 
         //Static variables
@@ -310,7 +310,8 @@ namespace hpl {
 		iGpuProgram *mpEdgeSmooth_UnpackDepthProgram;
 		iGpuProgram *mpEdgeSmooth_RenderProgram;
 
-		std::vector<cDeferredLight*> mvTempDeferredLights;
+		std::vector<cDeferredLight*> mvTempDeferredLights;	//Data is in the frame allocator
+		std::vector<iLight*> mvPrevVisibleLights;			//Sorted
 		std::vector<cDeferredLight*> mvSortedLights[eDeferredLightList_LastEnum];
 
 		iGpuProgram *mpSkyBoxProgram; 
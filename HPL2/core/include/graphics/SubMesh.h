@@ -90,12 +90,18 @@ namespace hpl {
 		void SetIsCollideShape(bool abX){mbCollideShape = abX;}
 		bool IsCollideShape(){ return mbCollideShape;}
 
-		const cTriEdge& GetEdge(int alIndex) const{ return mvEdges[alIndex];}
-		int GetEdgeNum(){ return (int)mvEdges.size();}
+		/**
+		 * Edge and triangle data is only created when first asked for. Destroy it when no longer
+		 * needed, it is not used for rendering.
+		 */
+		const cTriEdge& GetEdge(int alIndex){ return (*GetEdgeVecPtr())[alIndex];}
+		int GetEdgeNum(){ return (int)GetEdgeVecPtr()->size();}
 
-		tTriEdgeVec* GetEdgeVecPtr(){ return &mvEdges;}
+		tTriEdgeVec* GetEdgeVecPtr();
 
-		tTriangleDataVec* GetTriangleVecPtr(){ return &mvTriangles;}
+		tTriangleDataVec* GetTriangleVecPtr();
+
+		void DestroyTriangleData();
 
 		void SetDoubleSided(bool abX){ mbDoubleSided = abX;}
 		bool GetDoubleSided(){ return mbDoubleSided;}
@@ -135,6 +141,8 @@ namespace hpl {
 
 		tTriEdgeVec mvEdges;
 		tTriangleDataVec mvTriangles;
+		bool mbEdgesCreated;
+		bool mbTrianglesCreated;
 
 		cVector3f mvModelScale;
 
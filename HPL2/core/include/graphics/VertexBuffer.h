@@ -29,6 +29,7 @@ namespace hpl {
 	
 	class cBoundingVolume;
 	class iLowLevelGraphics;
+	class cTriangleBVH;
 
 	//-----------------------------------------------------
 
@@ -43,11 +44,12 @@ namespace hpl {
 			mpLowLevelGraphics(apLowLevelGraphics),
 			mDrawType(aDrawType), mUsageType(aUsageType), 
 			mlReservedVtxSize(alReserveVtxSize), mlReservedIdxSize(alReserveIdxSize),
-			mlElementNum(-1) {}
+			mlElementNum(-1), mpTriangleBVH(NULL) {}
 		
-		virtual ~iVertexBuffer(){}
+		virtual ~iVertexBuffer(){ DestroyTriangleBVH(); }
 
 		inline eVertexBufferType GetType() const { return mType; }
+		inline eVertexBufferUsageType GetUsageType() const { return mUsageType; }
 
 		virtual void CreateElementArray(	eVertexBufferElement aType, eVertexBufferElementFormat aFormat,
 											int alElementNum, int alProgramVarIndex=0)=0;
@@ -109,6 +111,13 @@ namespace hpl {
 		int GetElementNum(){ return mlElementNum;}
 
 		tVertexElementFlag GetVertexElementFlags(){ return mVertexFlags;}
+
+		/**
+		 * Triangle hierarchy over positions and indices, used for line picking. Built on first call.
+		 * It is destroyed whenever positions or indices are updated, so only worth using on static buffers.
+		 */
+		cTriangleBVH* GetTriangleBVH();
+		void DestroyTriangleBVH();
 	
 	protected:
 		iLowLevelGraphics* mpLowLevelGraphics;
@@ -124,6 +133,8 @@ namespace hpl {
 		int mlElementNum;
 
 		bool mbTangents;
+
+		cTriangleBVH *mpTriangleBVH;
 	};
 
 };
@@ -67,6 +67,7 @@ namespace hpl {
 	{
 		friend class cGuiSet;
 		friend class cGuiRenderObjectCompare;
+		friend class cGuiTextGlyphCompare;
 	public:
 		cGuiGfxElement(cGui* apGui);
 		~cGuiGfxElement();
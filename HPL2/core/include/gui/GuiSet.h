@@ -21,6 +21,8 @@
 #define HPL_GUI_SET_H
 
 #include <list>
+#include <map>
+#include <vector>
 #include "gui/GuiTypes.h"
 #include "graphics/GraphicsTypes.h"
 
@@ -75,11 +77,61 @@ namespace hpl {
     
 	//---------------------------------------------
 	
+	/**
+	 * A laid out glyph, relative to the start of the text.
+	 */
+	class cGuiTextGlyph
+	{
+	public:
+		cGuiGfxElement *mpGfx;
+		cVector2f mvOffset;
+		cVector2f mvSize;
+	};
+
+	typedef std::vector<cGuiTextGlyph> tGuiTextGlyphVec;
+
+	class cGuiTextGlyphCompare
+	{
+	public:
+		bool operator()(const cGuiTextGlyph& aGlyphA, const cGuiTextGlyph& aGlyphB) const;
+	};
+
+	/**
+	 * The glyphs of a text at a certain size, grouped into runs that use the same texture.
+	 */
+	class cGuiTextLayout
+	{
+	public:
+		unsigned int mlFontId;
+		float mfLength;
+		cRect2f mRect;
+		int mlLastUsedFrame;
+
+		tGuiTextGlyphVec mvGlyphs;
+		tIntVec mvRunStarts;
+	};
+
+	class cGuiTextLayoutKey
+	{
+	public:
+		iFontData *mpFont;
+		cVector2f mvSize;
+		tWString msText;
+
+		bool operator<(const cGuiTextLayoutKey& aOther) const;
+	};
+
+	typedef std::map<cGuiTextLayoutKey, cGuiTextLayout*> tGuiTextLayoutMap;
+	typedef tGuiTextLayoutMap::iterator tGuiTextLayoutMapIt;
+
+	//---------------------------------------------
+
 	class cGuiClipRegion;
 	class cGuiRenderObject
 	{
 	public:
-		cGuiRenderObject() : mpGfx(NULL), mvPos(0), mvSize(0), mColor(0,0), mpCustomMaterial(NULL), mpClipRegion(NULL), mbRotated(false), mfAngle(0.0f), mvPivot(0.0f)
+		cGuiRenderObject() : mpGfx(NULL), mvPos(0), mvSize(0), mColor(0,0), mpCustomMaterial(NULL), mpClipRegion(NULL), mbRotated(false), mfAngle(0.0f), mvPivot(0.0f),
+							mpTextGlyphs(NULL), mlTextGlyphNum(0)
 		{}
 
 		cGuiGfxElement *mpGfx;
@@ -92,6 +144,10 @@ namespace hpl {
 		bool mbRotated;
 		float mfAngle;
 		cVector3f mvPivot;
+
+		//If set, the object is a run of glyphs drawn with mvPos as origin.
+		const cGuiTextGlyph *mpTextGlyphs;
+		int mlTextGlyphNum;
 	};
 
 	class cGuiRenderObjectCompare
@@ -481,6 +537,10 @@ namespace hpl {
 									const cVector2f& avSize, const cVector3f& avPosition,
 									const cColor& aColor, eGuiMaterial aMaterial,
 									eFontAlign aAlign);
+
+		cGuiTextLayout* GetTextLayout(const wchar_t* apString, iFontData *apFont, const cVector2f& avSize);
+		void CreateTextLayout(cGuiTextLayout *apLayout, const wchar_t* apString, iFontData *apFont, const cVector2f& avSize);
+		void DestroyUnusedTextLayouts();
 								
 
 		void RenderClipRegion();
@@ -541,6 +601,10 @@ namespace hpl {
 
 		tGuiRenderObjectSet m_setRenderObjects;
 
+		tGuiTextLayoutMap m_mapTextLayouts;
+		cGuiTextLayoutKey mTempTextLayoutKey;
+		int mlTextLayoutFrame;
+
 		int mlPopupCount;
 		float mfLastPopUpZ;
 
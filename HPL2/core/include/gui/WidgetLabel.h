@@ -64,6 +64,7 @@ namespace hpl {
 		/////////////////////////
 		// Own Funcs
 		void DrawText(float afTimeStep, cGuiClipRegion *apClipRegion);
+		void UpdateWordWrapRows(float afRowHeight);
 
 		/////////////////////////
 		// Implemented functions
@@ -93,6 +94,12 @@ namespace hpl {
 		float mfWaitToScrollTime;
 		bool mbScrollingDown;
 
+		tWStringVec mvWordWrapRows;
+		bool mbWordWrapRowsUpdated;
+		float mfWordWrapRowsWidth;
+		cVector2f mvWordWrapRowsFontSize;
+		iFontData *mpWordWrapRowsFont;
+
 		float mfBackgroundZ;
 		cGuiGfxElement *mpGfxBackground;
 
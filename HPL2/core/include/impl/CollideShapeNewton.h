@@ -58,6 +58,8 @@ namespace hpl {
 		void SaveToSerializedData(cBinaryBuffer* apBinBuffer);
 		void CreateFromSerializedData(cBinaryBuffer* apBinBuffer);
 
+		unsigned int GetGeometryHash();
+
 		NewtonCollision* GetNewtonCollision(){ return mpNewtonCollision;}
 
 	private:
@@ -65,6 +67,9 @@ namespace hpl {
 		NewtonWorld *mpNewtonWorld;
 
 		tCollideShapeVec mvSubShapes;
+
+		bool mbGeometryHashCalculated;
+		unsigned int mlGeometryHash;
 	};
 };
 #endif // HPL_COLLIDE_SHAPE_NEWTON_H
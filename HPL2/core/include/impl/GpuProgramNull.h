@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HPL_GPU_PROGRAM_NULL_H
+#define HPL_GPU_PROGRAM_NULL_H
+
+#include "graphics/GPUShader.h"
+#include "graphics/GPUProgram.h"
+
+namespace hpl {
+
+	class cLowLevelGraphicsNull;
+
+	//-----------------------------------------------------
+
+	class cGpuShaderNull : public iGpuShader
+	{
+	public:
+		cGpuShaderNull(const tString& asName, eGpuShaderType aType, eGpuProgramFormat aProgramFormat);
+		~cGpuShaderNull();
+
+		bool Reload(){ return false;}
+		void Unload(){}
+		void Destroy(){}
+
+		bool SamplerNeedsTextureUnitSetup(){ return false;}
+
+		bool CreateFromFile(const tWString& asFile, const tString& asEntry="main", bool abPrintInfoIfFail=true);
+		bool CreateFromString(const char *apStringData, const tString& asEntry="main", bool abPrintInfoIfFail=true){ return true;}
+	};
+
+	//-----------------------------------------------------
+
+	/**
+	 * Program that never compiles anything. Variables get an id each by name and binds and sets are
+	 * counted by the null graphics.
+	 */
+	class cGpuProgramNull : public iGpuProgram
+	{
+	public:
+		cGpuProgramNull(const tString& asName, eGpuProgramFormat aProgramFormat, cLowLevelGraphicsNull* apLowLevelGraphics);
+		~cGpuProgramNull();
+
+		bool Link(){ return true;}
+
+		void Bind();
+		void UnBind(){}
+
+		bool CanAccessAPIMatrix(){ return true;}
+
+		bool SetSamplerToUnit(const tString& asSamplerName, int alUnit){ return true;}
+
+		int GetVariableId(const tString& asName);
+		bool GetVariableAsId(const tString& asName, int alId){ return true;}
+
+		bool SetInt(int alVarId, int alX);
+		bool SetFloat(int alVarId, float afX);
+		bool SetVec2f(int alVarId, float afX,float afY);
+		bool SetVec3f(int alVarId, float afX,float afY,float afZ);
+		bool SetVec4f(int alVarId, float afX,float afY,float afZ, float afW);
+		bool SetMatrixf(int alVarId, const cMatrixf& aMtx);
+		bool SetMatrixf(int alVarId, eGpuShaderMatrix aType, eGpuShaderMatrixOp aOp);
+
+	private:
+		cLowLevelGraphicsNull* mpLowLevelGraphics;
+
+		tStringVec mvVariableNames;
+	};
+};
+#endif // HPL_GPU_PROGRAM_NULL_H
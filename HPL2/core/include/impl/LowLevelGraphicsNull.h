@@ -0,0 +1,326 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HPL_LOWLEVELGRAPHICS_NULL_H
+#define HPL_LOWLEVELGRAPHICS_NULL_H
+
+#include "graphics/LowLevelGraphics.h"
+#include "math/MathTypes.h"
+
+namespace hpl {
+
+	//-------------------------------------------------
+
+	/**
+	 * Counts of the calls made to the null graphics. Used to measure what the renderer sends to the GPU.
+	 */
+	class cNullGraphicsCounters
+	{
+	public:
+		cNullGraphicsCounters(){ Reset(); }
+
+		void Reset();
+		void Add(const cNullGraphicsCounters& aCounters);
+
+		int mlDrawCalls;
+		int mlDrawnTriangles;
+		int mlStateChanges;
+		int mlMatrixChanges;
+		int mlTextureBinds;
+		int mlProgramBinds;
+		int mlProgramVariableSets;
+		int mlVertexBufferBinds;
+		int mlFrameBufferBinds;
+		int mlFrameBufferClears;
+		int mlOcclusionQueries;
+	};
+
+	//-------------------------------------------------
+
+	/**
+	 * Graphics that does not draw anything and does not need a GL context. All resources are created
+	 * without any GPU data and all calls are counted. Used to run the renderer without a GPU, for
+	 * instance when benchmarking.
+	 */
+	class cLowLevelGraphicsNull : public iLowLevelGraphics
+	{
+	public:
+		cLowLevelGraphicsNull();
+		~cLowLevelGraphicsNull();
+
+		/////////////////////////////////////////////////////
+		/////////////// GENERAL SETUP ///////////////////////
+		/////////////////////////////////////////////////////
+
+		bool Init(	int alWidth, int alHeight, int alDisplay, int alBpp, int abFullscreen, int alMultisampling,
+					eGpuProgramFormat aGpuProgramFormat,const tString& asWindowCaption,
+					const cVector2l &avWindowPos);
+
+		eGpuProgramFormat GetGpuProgramFormat(){ return mGpuProgramFormat;}
+
+		int GetCaps(eGraphicCaps aType);
+
+		void ShowCursor(bool abX){}
+
+		void SetWindowGrab(bool abX){}
+
+		void SetRelativeMouse(bool abX){}
+
+		void SetWindowCaption(const tString &asName){}
+
+		bool GetWindowMouseFocus(){ return true;}
+
+		bool GetWindowInputFocus(){ return true;}
+
+		bool GetWindowIsVisible(){ return true;}
+
+		bool GetFullscreenModeActive() { return false; }
+
+		void SetVsyncActive(bool abX, bool abAdaptive){}
+
+		void SetMultisamplingActive(bool abX){}
+
+		void SetGammaCorrection(float afX){ mfGammaCorrection = afX;}
+		float GetGammaCorrection(){ return mfGammaCorrection;}
+
+		int GetMultisampling(){ return 0;}
+
+		cVector2f GetScreenSizeFloat();
+		const cVector2l& GetScreenSizeInt();
+		
+		/////////////////////////////////////////////////////
+		/////////////// DATA CREATION //////////////////////
+		/////////////////////////////////////////////////////
+
+		iFontData* CreateFontData(const tString &asName);
+
+		iTexture* CreateTexture(const tString &asName, eTextureType aType, eTextureUsage aUsage);
+
+		iVertexBuffer* CreateVertexBuffer(	eVertexBufferType aType,
+											eVertexBufferDrawType aDrawType,
+											eVertexBufferUsageType aUsageType,
+											int alReserveVtxSize=0,int alReserveIdxSize=0);
+
+		iGpuProgram* CreateGpuProgram(const tString& asName);
+		iGpuShader* CreateGpuShader(const tString& asName, eGpuShaderType aType);
+
+		iFrameBuffer* CreateFrameBuffer(const tString& asName);
+		iDepthStencilBuffer* CreateDepthStencilBuffer(const cVector2l& avSize, int alDepthBits, int alStencilBits);
+
+		iOcclusionQuery* CreateOcclusionQuery();
+		
+		/////////////////////////////////////////////////////
+		/////////// FRAME BUFFER OPERATIONS ///////
+		/////////////////////////////////////////////////////
+	
+		void ClearFrameBuffer(tClearFrameBufferFlag aFlags);
+
+		void SetClearColor(const cColor& aCol){ AddStateChange();}
+		void SetClearDepth(float afDepth){ AddStateChange();}
+		void SetClearStencil(int alVal){ AddStateChange();}
+		
+		void CopyFrameBufferToTexure(	iTexture* apTex, const cVector2l &avPos,
+									const cVector2l &avSize, const cVector2l &avTexOffset=0){}
+		cBitmap* CopyFrameBufferToBitmap(const cVector2l &avScreenPos=0, const cVector2l &avScreenSize=-1);
+		
+		void WaitAndFinishRendering(){}
+		void FlushRendering(){}
+		void SwapBuffers();
+		
+		void SetCurrentFrameBuffer(iFrameBuffer* apFrameBuffer, const cVector2l &avPos = 0, const cVector2l& avSize = -1);
+		iFrameBuffer* GetCurrentFrameBuffer() { return mpFrameBuffer; }
+
+		void SetFrameBufferDrawTargets(int *apTargets, int alNumOfTargets){ AddStateChange();}
+		
+		/////////////////////////////////////////////////////
+		/////////// RENDER STATE ////////////////////////////
+		/////////////////////////////////////////////////////
+
+		void SetColorWriteActive(bool abR,bool abG,bool abB,bool abA){ AddStateChange();}
+		void SetDepthWriteActive(bool abX){ AddStateChange();}
+
+		void SetCullActive(bool abX){ AddStateChange();}
+		void SetCullMode(eCullMode aMode){ AddStateChange();}
+
+		void SetDepthTestActive(bool abX){ AddStateChange();}
+		void SetDepthTestFunc(eDepthTestFunc aFunc){ AddStateChange();}
+
+		void SetAlphaTestActive(bool abX){ AddStateChange();}
+		void SetAlphaTestFunc(eAlphaTestFunc aFunc,float afRef){ AddStateChange();}
+
+		void SetStencilActive(bool abX){ AddStateChange();}
+		void SetStencilWriteMask(unsigned int alMask){ AddStateChange();}
+		void SetStencil(eStencilFunc aFunc,int alRef, unsigned int aMask,
+						eStencilOp aFailOp,eStencilOp aZFailOp,eStencilOp aZPassOp){ AddStateChange();}
+		void SetStencilTwoSide(	eStencilFunc aFrontFunc,eStencilFunc aBackFunc,
+								int alRef, unsigned int aMask,
+								eStencilOp aFrontFailOp,eStencilOp aFrontZFailOp,eStencilOp aFrontZPassOp,
+								eStencilOp aBackFailOp,eStencilOp aBackZFailOp,eStencilOp aBackZPassOp){ AddStateChange();}
+		
+		void SetScissorActive(bool abX){ AddStateChange();}
+		void SetScissorRect(const cVector2l& avPos, const cVector2l& avSize){ AddStateChange();}
+
+		void SetClipPlane(int alIdx, const cPlanef& aPlane);
+		cPlanef GetClipPlane(int alIdx);
+		void SetClipPlaneActive(int alIdx, bool abX){ AddStateChange();}
+
+		void SetColor(const cColor &aColor){ AddStateChange();}
+
+		void SetBlendActive(bool abX){ AddStateChange();}
+		void SetBlendFunc(eBlendFunc aSrcFactor, eBlendFunc aDestFactor){ AddStateChange();}
+		void SetBlendFuncSeparate(	eBlendFunc aSrcFactorColor, eBlendFunc aDestFactorColor,
+									eBlendFunc aSrcFactorAlpha, eBlendFunc aDestFactorAlpha){ AddStateChange();}
+
+		void SetPolygonOffsetActive(bool abX){ AddStateChange();}
+		void SetPolygonOffset(float afBias,float afSlopeScaleBias){ AddStateChange();}
+
+		/////////////////////////////////////////////////////
+		/////////// MATRIX //////////////////////////////////
+		/////////////////////////////////////////////////////
+
+		void PushMatrix(eMatrix aMtxType){}
+		void PopMatrix(eMatrix aMtxType){ ++mFrameCounters.mlMatrixChanges;}
+		void SetIdentityMatrix(eMatrix aMtxType){ ++mFrameCounters.mlMatrixChanges;}
+
+		void SetMatrix(eMatrix aMtxType, const cMatrixf& a_mtxA){ ++mFrameCounters.mlMatrixChanges;}
+
+		void SetOrthoProjection(const cVector2f& avSize, float afMin, float afMax){ ++mFrameCounters.mlMatrixChanges;}
+		void SetOrthoProjection(const cVector3f& avMin, const cVector3f& avMax){ ++mFrameCounters.mlMatrixChanges;}
+
+		/////////////////////////////////////////////////////
+		/////////// TEXTURE OPERATIONS ///////////////////////
+		/////////////////////////////////////////////////////
+
+		void SetTexture(unsigned int alUnit,iTexture* apTex){ ++mFrameCounters.mlTextureBinds;}
+		void SetActiveTextureUnit(unsigned int alUnit){ AddStateChange();}
+		void SetTextureEnv(eTextureParam aParam, int alVal){ AddStateChange();}
+		void SetTextureConstantColor(const cColor &aColor){ AddStateChange();}
+
+		
+		/////////////////////////////////////////////////////
+		/////////// DRAWING ///////////////////////////////
+		/////////////////////////////////////////////////////
+
+		void DrawTriangle(tVertexVec& avVtx){ AddDrawCall(1);}
+
+		void DrawQuad(	const cVector3f &avPos,const cVector2f &avSize, const cColor& aColor=cColor(1,1)){ AddDrawCall(2);}
+		void DrawQuad(	const cVector3f &avPos,const cVector2f &avSize,
+						const cVector2f &avMinTexCoord,const cVector2f &avMaxTexCoord,
+						const cColor& aColor=cColor(1,1)){ AddDrawCall(2);}
+		void DrawQuad(	const cVector3f &avPos,const cVector2f &avSize,
+						const cVector2f &avMinTexCoord0,const cVector2f &avMaxTexCoord0,
+						const cVector2f &avMinTexCoord1,const cVector2f &avMaxTexCoord1,
+						const cColor& aColor=cColor(1,1)){ AddDrawCall(2);}
+		
+		void DrawQuad(const tVertexVec &avVtx){ AddDrawCall(2);}
+		void DrawQuad(const tVertexVec &avVtx, const cColor aCol){ AddDrawCall(2);}
+		void DrawQuad(const tVertexVec &avVtx,const float afZ){ AddDrawCall(2);}
+		void DrawQuad(const tVertexVec &avVtx,const float afZ,const cColor &aCol){ AddDrawCall(2);}
+		void DrawQuadMultiTex(const tVertexVec &avVtx,const tVector3fVec &avExtraUvs){ AddDrawCall(2);}
+
+		void DrawLine(const cVector3f& avBegin, const cVector3f& avEnd, cColor aCol){ AddDrawCall(0);}
+		void DrawLine(const cVector3f& avBegin, const cColor& aBeginCol, const cVector3f& avEnd, const cColor& aEndCol){ AddDrawCall(0);}
+
+		void DrawBoxMinMax(const cVector3f& avMin, const cVector3f& avMax, cColor aCol){ AddDrawCall(0);}
+		void DrawSphere(const cVector3f& avPos, float afRadius, cColor aCol){ AddDrawCall(0);}
+		void DrawSphere(const cVector3f& avPos, float afRadius, cColor aColX, cColor aColY, cColor aColZ){ AddDrawCall(0);}
+
+		void DrawLineQuad(const cRect2f& aRect, float afZ, cColor aCol){ AddDrawCall(0);}
+		void DrawLineQuad(const cVector3f &avPos,const cVector2f &avSize, cColor aCol){ AddDrawCall(0);}
+				
+		/////////////////////////////////////////////////////
+		/////////// VERTEX BATCHING /////////////////////////
+		/////////////////////////////////////////////////////
+
+		void AddVertexToBatch(const cVertex *apVtx){ ++mlBatchVertexCount;}
+		void AddVertexToBatch(const cVertex *apVtx, const cVector3f* avTransform){ ++mlBatchVertexCount;}
+		void AddVertexToBatch(const cVertex *apVtx, const cMatrixf* aMtx){ ++mlBatchVertexCount;}
+
+		void AddVertexToBatch_Size2D(const cVertex *apVtx, const cVector3f* avTransform,
+										const cColor* apCol,const float& mfW, const float& mfH){ ++mlBatchVertexCount;}
+
+		void AddVertexToBatch_Raw(	const cVector3f& avPos, const cColor &aColor,
+									const cVector3f& avTex){ ++mlBatchVertexCount;}
+
+
+		void AddTexCoordToBatch(unsigned int alUnit,const cVector3f *apCoord){}
+		void SetBatchTextureUnitActive(unsigned int alUnit,bool abActive){}
+
+		void AddIndexToBatch(int alIndex){ ++mlBatchIndexCount;}
+
+		void FlushTriBatch(tVtxBatchFlag aTypeFlags, bool abAutoClear=true);
+		void FlushQuadBatch(tVtxBatchFlag aTypeFlags, bool abAutoClear=true);
+		void ClearBatch();
+		
+		/////////////////////////////////////////////////////
+		/////////// IMPLEMENTION SPECIFICS /////////////////
+		/////////////////////////////////////////////////////
+
+		/**
+		 * Counters for the frame being drawn. Reset at SwapBuffers.
+		 */
+		const cNullGraphicsCounters& GetFrameCounters(){ return mFrameCounters;}
+		/**
+		 * Counters for the last frame that SwapBuffers was called for.
+		 */
+		const cNullGraphicsCounters& GetLastFrameCounters(){ return mLastFrameCounters;}
+		/**
+		 * Counters for all frames since start or last ResetCounters.
+		 */
+		const cNullGraphicsCounters& GetTotalCounters(){ return mTotalCounters;}
+		int GetFrameCount(){ return mlFrameCount;}
+		void ResetCounters();
+
+		/**
+		 * The sample count all occlusion queries return. 0 makes everything tested count as occluded.
+		 */
+		void SetOcclusionQuerySampleCount(unsigned int alX){ mlOcclusionQuerySampleCount = alX;}
+		unsigned int GetOcclusionQuerySampleCount(){ return mlOcclusionQuerySampleCount;}
+
+		inline void AddDrawCall(int alTriangles){ ++mFrameCounters.mlDrawCalls; mFrameCounters.mlDrawnTriangles += alTriangles;}
+		inline void AddStateChange(){ ++mFrameCounters.mlStateChanges;}
+		inline void AddProgramBind(){ ++mFrameCounters.mlProgramBinds;}
+		inline void AddProgramVariableSet(){ ++mFrameCounters.mlProgramVariableSets;}
+		inline void AddVertexBufferBind(){ ++mFrameCounters.mlVertexBufferBinds;}
+		inline void AddOcclusionQuery(){ ++mFrameCounters.mlOcclusionQueries;}
+
+	private:
+		cVector2l mvScreenSize;
+		eGpuProgramFormat mGpuProgramFormat;
+		float mfGammaCorrection;
+
+		iFrameBuffer* mpFrameBuffer;
+		cVector2l mvFrameBufferPos;
+		cVector2l mvFrameBufferSize;
+
+		cPlanef mvClipPlanes[kMaxClipPlanes];
+
+		unsigned int mlOcclusionQuerySampleCount;
+
+		int mlBatchVertexCount;
+		int mlBatchIndexCount;
+
+		cNullGraphicsCounters mFrameCounters;
+		cNullGraphicsCounters mLastFrameCounters;
+		cNullGraphicsCounters mTotalCounters;
+		int mlFrameCount;
+	};
+};
+#endif // HPL_LOWLEVELGRAPHICS_NULL_H
@@ -52,6 +52,8 @@ namespace hpl {
 		void SetNumberOfThreads(int alThreads);
 		int GetNumberOfThreads();
 
+		int GetMaxQueryThreads();
+
 		iCollideShape* CreateNullShape();
 		iCollideShape* CreateBoxShape(const cVector3f &avSize, cMatrixf* apOffsetMtx);
 		iCollideShape* CreateSphereShape(const cVector3f &avRadii, cMatrixf* apOffsetMtx);
@@ -95,10 +97,13 @@ namespace hpl {
 							bool abCalcDist, bool abCalcNormal, bool abCalcPoint,
 							bool abUsePrefilter = false);
 
+		bool CheckRayBodyIntersection(	iPhysicsBody *apBody, const cVector3f &avOrigin, const cVector3f& avEnd, 
+										float *apT=NULL);
+
 		bool CheckShapeCollision(	iCollideShape* apShapeA, const cMatrixf& a_mtxA,
 						iCollideShape* apShapeB, const cMatrixf& a_mtxB,
 						cCollideData & aCollideData, int alMaxPoints,
-						bool abCorrectNormalDirection);
+						bool abCorrectNormalDirection, int alThreadIndex=0);
 		
 		void RenderShapeDebugGeometry(	iCollideShape *apShape, const cMatrixf& a_mtxTransform, 
 										iLowLevelGraphics *apLowLevel, const cColor& aColor);
@@ -106,11 +111,17 @@ namespace hpl {
 
 		NewtonWorld* GetNewtonWorld(){ return mpNewtonWorld;}
 	private:
+		class cTempCollideBuffers
+		{
+		public:
+			float* mpPoints;
+			float* mpNormals;
+			float* mpDepths;
+		};
+
 		NewtonWorld *mpNewtonWorld;
 
-		float* mpTempPoints;
-		float* mpTempNormals;
-		float* mpTempDepths;
+		std::vector<cTempCollideBuffers> mvTempBuffers;
 
 		cVector3f mvWorldSizeMin;
 		cVector3f mvWorldSizeMax;
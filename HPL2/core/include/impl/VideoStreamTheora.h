@@ -22,6 +22,7 @@
 
 #include "graphics/VideoStream.h"
 #include "resources/VideoLoader.h"
+#include "system/Thread.h"
 
 #include <theora/theora.h>
 
@@ -29,8 +30,14 @@ namespace hpl {
 
 	//-----------------------------------------
 	class  cVideoStreamTheora_Loader;
-
-	class cVideoStreamTheora : public iVideoStream
+	class iMutex;
+	class iSemaphore;
+
+	/**
+	 * Packets are decoded and converted to RGBA on a decoder thread owned by the stream. Update only advances the time
+	 * and wakes the decoder, CopyToTexture uploads the newest finished frame.
+	 */
+	class cVideoStreamTheora : public iVideoStream, public iThreadClass
 	{
 	public:
 		cVideoStreamTheora(const tString& asName, cVideoStreamTheora_Loader* apLoader);
@@ -51,8 +58,14 @@ namespace hpl {
 
 		void CopyToTexture(iTexture *apTexture);
 
+		/**
+		 * Run by the decoder thread, do not call.
+		 */
+		void UpdateThread();
+
 	private:
-		void DrawFrameToBuffer();
+		bool DecodeToTime(float afTime);
+		void DrawFrameToBuffer(unsigned char *apDestBuffer);
 		int BufferData(FILE *pFile ,ogg_sync_state *apOggSynchState);
 		void QueuePage(ogg_page *apPage);
 		bool GetHeaders();
@@ -68,8 +81,20 @@ namespace hpl {
 		bool mbPlaying;
 
 		float mfTime;
-
-		unsigned char *mpFrameBuffer;
+		float mfLastTimeStep;
+
+		iThread *mpDecoderThread;
+		iMutex *mpMutex;
+		iSemaphore *mpDecodeSemaphore;
+		bool mbExiting;
+		bool mbResetRequested;
+
+		//Three frames, one is written by the decoder, one is the newest finished and one is used by CopyToTexture.
+		unsigned char *mvFrameBuffers[3];
+		int mlDecodeFrame;
+		int mlReadyFrame;
+		int mlUploadFrame;
+		bool mbNewFrameReady;
 		
 		ogg_sync_state   mOggSyncState;
 		ogg_stream_state mTheoraStreamState;
@@ -90,19 +115,11 @@ namespace hpl {
 
 	class cVideoStreamTheora_Loader : public iVideoLoader
 	{
-	friend class cVideoStreamTheora;
 	public:
 		cVideoStreamTheora_Loader();
 		~cVideoStreamTheora_Loader();
 		
 		iVideoStream* LoadVideo(const tWString& asName);
-	
-	private:
-		unsigned char* mpYuvToR;
-		unsigned char* mpYuvToB;
-		
-		unsigned short* mpYuv_G_UV;
-		unsigned char* mpYuv_G_Y_UV;
 	};
 
 	//-----------------------------------------
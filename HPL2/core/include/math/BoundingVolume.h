@@ -100,6 +100,12 @@ namespace hpl {
 		//Debug:
 		void DrawEdges(const cVector3f& avLightPos,float afLightRange, iLowLevelGraphics *apLowLevelGraphics);
 		void UpdateSize();
+
+		/**
+		 * Updates all the volumes that have changed in one pass, same as calling UpdateSize on each.
+		 * Volumes that are not changed are skipped.
+		 */
+		static void UpdateSizes(cBoundingVolume **apVolumes, size_t alNum);
 		
 		cMatrixf m_mtxTransform;
 
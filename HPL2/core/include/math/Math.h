@@ -82,6 +82,13 @@ namespace hpl {
 		 */
 		static void Randomize(int alSeed = -1);
 
+		/**
+		 * Makes the rand funcs on the calling thread use a generator of their own instead of rand(), 
+		 * which must only be used by the main thread. Used by jobs, with a seed from the thread that queues them.
+		 * \param alSeed the seed, 0 = go back to using rand().
+		 */
+		static void SetThreadRandomSeed(unsigned int alSeed);
+
 		//////////////////////////////////////////////////////
 		////////// BIT OPERATIONS ////////////////////////
 		//////////////////////////////////////////////////////
@@ -878,10 +885,13 @@ namespace hpl {
 
 		/**
 		* Checks intersection between line and a mesh. For speed reasons the matrix is INVERSE!
+		* Static buffers are checked using the cached triangle hierarchy of the buffer.
+		* \param apBarycentric barycentric (u,v) of the hit, weights for the second and third vertex of the triangle.
 		*/
 		static bool CheckLineTriVertexBufferIntersection(	const cVector3f& avLineStart, const cVector3f& avLineEnd,
 															const cMatrixf& a_mtxInvMeshMtx, iVertexBuffer *apVtxBuffer,
-															cVector3f *apIntersectionPos, float *apT, int *apTriIndex, bool abSkipBackfacing=true);
+															cVector3f *apIntersectionPos, float *apT, int *apTriIndex, bool abSkipBackfacing=true,
+															cVector2f *apBarycentric=NULL);
 
 		//////////////////////////////////////////////////////
 		////////// QUATERNIONS ///////////////////////////////
@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HPL_TRIANGLE_BVH_H
+#define HPL_TRIANGLE_BVH_H
+
+#include "math/MathTypes.h"
+
+namespace hpl {
+
+	//-----------------------------------------------
+
+	class cTriangleBVHHit
+	{
+	public:
+		cTriangleBVHHit() : mfT(0), mlTriIndex(-1), mvBarycentric(0) {}
+
+		/** Position along the line, 0 = start and 1 = end. */
+		float mfT;
+		/** Index of the first vertex index of the triangle, same as the brute force mesh checks. */
+		int mlTriIndex;
+		/** Barycentric coordinate (u,v) of the hit, weights for vertex 1 and 2 of the triangle. */
+		cVector2f mvBarycentric;
+	};
+
+	//-----------------------------------------------
+
+	class cTriangleBVHNode
+	{
+	public:
+		cVector3f mvMin;
+		cVector3f mvMax;
+		/** If leaf, first triangle. Else index of first child, second child comes right after. */
+		int mlFirst;
+		/** Number of triangles, 0 means an inner node. */
+		int mlCount;
+		int mlSplitAxis;
+	};
+
+	//-----------------------------------------------
+
+	/**
+	 * Bounding volume hierarchy over the triangles of an index/vertex array.
+	 * Positions are copied at build time, so the hierarchy must be rebuilt if the vertex data changes.
+	 */
+	class cTriangleBVH
+	{
+	public:
+		cTriangleBVH();
+		~cTriangleBVH();
+
+		void Build(const unsigned int* apIndexArray, int alIndexNum, const float* apVertexArray, int alVtxStride);
+		void Clear();
+
+		/**
+		 * Finds the closest intersection along the line. All coordinates are in the local space of the triangles.
+		 */
+		bool CheckLineIntersection(	const cVector3f& avLineStart, const cVector3f& avLineEnd, 
+									cTriangleBVHHit *apHit, bool abSkipBackfacing=true) const;
+
+		/**
+		 * Adds the index of every triangle whose bounds overlap the box to the vector. Same index convention as cTriangleBVHHit.
+		 * The order is not sorted.
+		 */
+		void FindTrianglesInBox(const cVector3f& avMin, const cVector3f& avMax, std::vector<int>& avTriIndices) const;
+
+		int GetTriangleNum() const { return (int)mvTriIndices.size(); }
+		int GetNodeNum() const { return (int)mvNodes.size(); }
+
+	private:
+		void BuildNode(int alNodeIdx, int alStart, int alEnd, std::vector<int>& avOrder, const std::vector<cVector3f>& avCentroids);
+		
+		std::vector<cTriangleBVHNode> mvNodes;
+		std::vector<cVector3f> mvTriVertices;
+		std::vector<int> mvTriIndices;
+	};
+
+	//-----------------------------------------------
+
+};
+#endif // HPL_TRIANGLE_BVH_H
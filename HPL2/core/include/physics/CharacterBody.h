@@ -71,12 +71,46 @@ namespace hpl {
 		cCharacterBodyCollidePush(iCharacterBody *apCharBody);
 
 		void OnCollision(iPhysicsBody *apBody, cCollideData *apCollideData);
+		/**
+		 * Same as OnCollision, but with the character at avCharPosition instead of its current position.
+		 */
+		void OnCollisionAtPosition(iPhysicsBody *apBody, cCollideData *apCollideData, const cVector3f& avCharPosition);
 
 		iCharacterBody *mpCharBody;
 	};
 	
 	//------------------------------------------------
 
+	/**
+	 * Saves collisions so that the real callback can be called after a parallel resolve.
+	 */
+	class cCharacterBodyCollideDefer : public iPhysicsWorldCollisionCallback
+	{
+	public:
+		cCharacterBodyCollideDefer(iCharacterBody *apCharBody);
+
+		void OnCollision(iPhysicsBody *apBody, cCollideData *apCollideData);
+
+		iCharacterBody *mpCharBody;
+		iPhysicsWorldCollisionCallback *mpCallback;
+	};
+
+	//------------------------------------------------
+
+	class cCharacterBodyDeferredCallback
+	{
+	public:
+		iPhysicsWorldCollisionCallback *mpCollideCallback; //If NULL, then it is a hit ground callback.
+		iPhysicsBody *mpBody;
+		cCollideData mCollideData;
+		cVector3f mvCharPosition;
+		cVector3f mvHitGroundVelocity;
+	};
+
+	typedef std::vector<cCharacterBodyDeferredCallback> tCharacterBodyDeferredCallbackVec;
+
+	//------------------------------------------------
+
 	class cCharacterBodyRay : public iPhysicsRayCallback
 	{
 	public:
@@ -96,6 +130,7 @@ namespace hpl {
 	class iCharacterBody
 	{
 	friend class cCharacterBodyCollideGravity;
+	friend class cCharacterBodyCollideDefer;
 	public:
 		iCharacterBody(const tString &asName, iPhysicsWorld *apWorld, const cVector3f avSize);
 		virtual ~iCharacterBody();
@@ -120,6 +155,28 @@ namespace hpl {
 
 		void Update(float afTimeStep);
 
+		/**
+		 * The steps of Update(), calling them in order is the same as calling Update().
+		 * PreUpdate only changes the body itself. ResolveCollisions only reads from the world when abDeferCallbacks is true, 
+		 * anything that changes other bodies or calls user code is then saved and run in PostUpdate, with the contacts and 
+		 * character position as they were when found. A body that turns off its connected body (see GetDisablesConnectedBody)
+		 * does that in ResolveCollisions and can therefore not defer callbacks.
+		 * \param alThreadIndex the index used for collision queries, see iPhysicsWorld::GetMaxQueryThreads
+		 */
+		void PreUpdate(float afTimeStep);
+		void ResolveCollisions(float afTimeStep, int alThreadIndex, bool abDeferCallbacks);
+		void PostUpdate(float afTimeStep);
+
+		/**
+		 * True if the connected body is turned off while the body resolves collisions.
+		 */
+		bool GetDisablesConnectedBody(){ return mpConnectedBody && mbConnectionCollision==false;}
+
+		/**
+		 * Gets the box that the body can possibly touch during ResolveCollisions. Only valid after PreUpdate.
+		 */
+		void GetResolveBounds(float afTimeStep, cVector3f &avMin, cVector3f &avMax);
+
 		///////////////////////////////////////
 		//Helpers
 
@@ -379,6 +436,8 @@ namespace hpl {
 
 		void EnableBodiesAroundCharacter();
 
+		void RunDeferredCallbacks();
+
 		bool CheckCollision(cVector3f *apPushBackVector, const cVector3f& avPos, iPhysicsWorldCollisionCallback *apCallback,int alShapeIdx=-1);
 
 		tString msName;
@@ -529,6 +588,11 @@ namespace hpl {
 		cCharacterBodyCollideGravity *mpCollideGravityCallback;
 		cCharacterBodyCollidePush *mpCollidePushCallback;
 		cCharacterBodyRay *mpRayCallback;
+		cCharacterBodyCollideDefer *mpCollideDeferCallback;
+
+		int mlQueryThreadIndex;
+		bool mbDeferCallbacks;
+		tCharacterBodyDeferredCallbackVec mvDeferredCallbacks;
 
 		iPhysicsMaterial *mpGravityCollideMaterial;
 
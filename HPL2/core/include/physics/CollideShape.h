@@ -61,6 +61,12 @@ namespace hpl {
 		float GetVolume(){ return mfVolume;}
 
 		cBoundingVolume& GetBoundingVolume(){ return mBoundingVolume;}
+
+		/**
+		 * A hash of the shape's geometry (type, size, offset, mesh data and sub shapes). Used to check if
+		 * data computed from the shape is still valid.
+		 */
+		virtual unsigned int GetGeometryHash()=0;
 	protected:
 		cVector3f mvSize;
 		eCollideShapeType mType;
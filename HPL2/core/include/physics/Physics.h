@@ -35,6 +35,7 @@ namespace hpl {
 	class cResources;
 	class iHapticSurface;
 	class cHaptic;
+	class cSystem;
 
 	//------------------------------------------------
 
@@ -67,7 +68,7 @@ namespace hpl {
 		cPhysics(iLowLevelPhysics *apLowLevelPhysics);
 		~cPhysics();
 
-		void Init(cResources *apResources);
+		void Init(cResources *apResources, cSystem *apSystem);
 
 		void Update(float afTimeStep);
 
@@ -104,6 +105,7 @@ namespace hpl {
 
 		iLowLevelPhysics *mpLowLevelPhysics;
 		cResources *mpResources;
+		cSystem *mpSystem;
 
 		tPhysicsWorldList mlstWorlds;
 		tSurfaceDataMap m_mapSurfaceData;
@@ -110,6 +110,8 @@ namespace hpl {
 	class iPhysicsWorldCollisionCallback
 	{
 	public:
+		virtual ~iPhysicsWorldCollisionCallback(){}
+
 		virtual void OnCollision(iPhysicsBody *apBody, cCollideData *apCollideData)=0;
 	};
 
@@ -49,6 +49,8 @@ namespace hpl {
 
 	class cWorld;
 	class cBoundingVolume;
+	class cJobManager;
+	class iJob;
 	
 	typedef std::list<iCollideShape*> tCollideShapeList;
 	typedef tCollideShapeList::iterator tCollideShapeListIt;
@@ -76,6 +78,26 @@ namespace hpl {
 
 	typedef std::map<tString, iPhysicsMaterial*> tPhysicsMaterialMap;
 	typedef tPhysicsMaterialMap::iterator tPhysicsMaterialMapIt;
+
+	//------------------------------------------
+	
+	/**
+	 * The data a shape (or compound of shapes) is created from. Equal keys give equal shapes.
+	 */
+	class cCollideShapeCacheKey
+	{
+	public:
+		void AddShape(eCollideShapeType aType, const cVector3f& avSize, const cMatrixf& a_mtxOffset);
+
+		bool IsEmpty() const { return mvData.empty(); }
+		bool operator<(const cCollideShapeCacheKey& aKey) const { return mvData < aKey.mvData; }
+
+	private:
+		std::vector<float> mvData;
+	};
+
+	typedef std::map<cCollideShapeCacheKey, iCollideShape*> tCollideShapeCacheMap;
+	typedef tCollideShapeCacheMap::iterator tCollideShapeCacheMapIt;
 		
 	typedef cSTLMapIterator<iPhysicsMaterial*, tPhysicsMaterialMap, tPhysicsMaterialMapIt> cPhysicsMaterialIterator;
 	
@@ -114,6 +136,25 @@ namespace hpl {
 		virtual void SetNumberOfThreads(int alThreads)=0;
 		virtual int GetNumberOfThreads()=0;
 
+		/**
+		 * Max number of threads that can query collisions at the same time, each using its own thread index.
+		 */
+		virtual int GetMaxQueryThreads()=0;
+
+		void SetJobManager(cJobManager *apJobManager){ mpJobManager = apJobManager;}
+		cJobManager* GetJobManager(){ return mpJobManager;}
+
+		/**
+		 * If character bodies that cannot touch each other during a step should have their collisions resolved in parallel.
+		 * Only has an effect if a job manager is set.
+		 * This changes the order of the character update. All bodies do their pre update first (which only changes the body
+		 * itself), then the parallel bodies are resolved and post updated, and last the other bodies are resolved and post updated 
+		 * in list order. Callbacks that look at other characters can therefore see them at a different point of their update
+		 * than when updated one by one.
+		 */
+		void SetParallelCharacterUpdate(bool abX){ mbParallelCharacterUpdate = abX;}
+		bool GetParallelCharacterUpdate(){ return mbParallelCharacterUpdate;}
+
 		//! @}
 
 		//########################################################################################
@@ -140,6 +181,17 @@ namespace hpl {
 		virtual iCollideShape* CreateCompundShape(tCollideShapeVec &avShapes)=0;
 		virtual iCollideShape* CreateStaticSceneShape(tCollideShapeVec &avShapes, tMatrixfVec *apMatrices)=0;
 		void DestroyShape(iCollideShape *apShape);
+
+		/**
+		 * Returns a shape earlier added with an equal key, or NULL if there is none. The cache does not count as
+		 * a user, so the shape is removed when the last body using it is destroyed and must be given to a body right away.
+		 */
+		iCollideShape* GetCachedShape(const cCollideShapeCacheKey& aKey);
+		void AddCachedShape(const cCollideShapeCacheKey& aKey, iCollideShape *apShape);
+		int GetCachedShapeNum(){ return (int)m_mapCachedShapes.size();}
+
+		void SetShapeCacheActive(bool abX){ mbShapeCacheActive = abX;}
+		bool GetShapeCacheActive(){ return mbShapeCacheActive;}
 		
 		//! @}
 		
@@ -187,6 +239,11 @@ namespace hpl {
 		void DestroyBody(iPhysicsBody* apBody);
 		iPhysicsBody *GetBody(const tString &asName);
 		cPhysicsBodyIterator GetBodyIterator();
+		/**
+		 * Updates the bounding volumes of all bodies. Bounding volumes are updated when first read, so this must be
+		 * called before bodies are queried from other threads.
+		 */
+		void UpdateBodyBoundingVolumes();
 
 		virtual iCharacterBody *CreateCharacterBody(const tString &asName, const cVector3f &avSize)=0;
 		void DestroyCharacterBody(iCharacterBody* apBody);
@@ -237,6 +294,14 @@ namespace hpl {
 							bool abCalcDist, bool abCalcNormal, bool abCalcPoint,
 							bool abUsePrefilter=false)=0;
 
+		/**
+		 * Checks a ray against a single body, no callbacks are called. Use with GetBodiesInBV when
+		 * many rays are cast in the same area.
+		 * \param apT set to where along the ray (0-1) the hit is.
+		 */
+		virtual bool CheckRayBodyIntersection(	iPhysicsBody *apBody, const cVector3f &avOrigin, const cVector3f& avEnd, 
+												float *apT=NULL)=0;
+
 		virtual void RenderShapeDebugGeometry(	iCollideShape *apShape, const cMatrixf& a_mtxTransform, 
 												iLowLevelGraphics *apLowLevel, const cColor& aColor)=0;
 		
@@ -245,7 +310,7 @@ namespace hpl {
 		virtual bool CheckShapeCollision(	iCollideShape* apShapeA, const cMatrixf& a_mtxA,
 										iCollideShape* apShapeB, const cMatrixf& a_mtxB,
 										cCollideData & aCollideData, int alMaxPoints,
-										bool abCorrectNormalDirection)=0;
+										bool abCorrectNormalDirection, int alThreadIndex=0)=0;
 
 		bool CheckShapeWorldCollision(	cVector3f *apPushVector,
 										iCollideShape* apShape, const cMatrixf& a_mtxTransform,
@@ -255,7 +320,8 @@ namespace hpl {
 										bool abCollideCharacter=true,
 										int alMinPushStrength=0,
 										tFlag alCollideFlags = eFlagBit_All, 
-										bool abDebug=false);
+										bool abDebug=false,
+										int alThreadIndex=0);
 		
 		void DestroyAll();
 
@@ -263,8 +329,17 @@ namespace hpl {
 		void SetWorld(cWorld *apWorld){ mpWorld = apWorld;}
 		//! @}
 
+		/**
+		 * Called by the parallel character update, do not use.
+		 */
+		void ResolveCharacterBodiesForThread(int alThreadIndex);
+
 	protected:
+		void UpdateCharacterBodies(float afTimeStep);
+
 		tCollideShapeList mlstShapes;
+		tCollideShapeCacheMap m_mapCachedShapes;
+		bool mbShapeCacheActive;
 		tPhysicsBodyList mlstBodies;
 		tPhysicsBodySet m_setUpdateBodies;
 		tCharacterBodyList mlstCharBodies;
@@ -274,7 +349,18 @@ namespace hpl {
 		tPhysicsRopeList mlstRopes;
 		cWorld *mpWorld;
 
-		std::vector<iPhysicsBody*> mvTempBodies;
+		std::vector< std::vector<iPhysicsBody*> > mvTempBodies; //One per query thread
+		std::vector<cBoundingVolume*> mvTempBoundingVolumes;
+
+		cJobManager *mpJobManager;
+		bool mbParallelCharacterUpdate;
+		std::vector<iJob*> mvCharacterResolveJobs;
+		std::vector<iCharacterBody*> mvParallelCharBodies;
+		std::vector<iCharacterBody*> mvSerialCharBodies;
+		std::vector<cVector3f> mvCharBodySweptMin;
+		std::vector<cVector3f> mvCharBodySweptMax;
+		float mfCharacterResolveTimeStep;
+		int mlCharacterResolveThreads;
 
 		bool mbLogDebug;
 
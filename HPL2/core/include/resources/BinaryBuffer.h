@@ -25,6 +25,11 @@
 #include "graphics/GraphicsTypes.h"
 
 namespace hpl {
+
+	class cJobManager;
+
+	//------------------------------------------
+
 	class cBinaryBuffer
 	{
 	public:
@@ -109,20 +114,40 @@ namespace hpl {
 		/**
 		* Compresses the data from apSrcData to current pos. Compression level is 0 - 9, where 0 is no compression. -1 = default (recommended basically) compression.
 		* If abWriteDataSize is true, then the first 4 bytes, will be a 32bit int with the size of the compressed data.
+		* Data larger than one block is split into blocks that are compressed in parallel (if block compression is on), else a single zlib stream is written.
 		*/
 		bool CompressAndAdd(char *apSrcData, size_t alSize, int alCompressionLevel=-1, bool abWriteDataSize=false);
 
 		/**
-		* Decompresses the data from apSrcData to current pos.
+		* Decompresses the data from apSrcData to current pos. Both block and single stream data can be decompressed.
 		*/
 		bool DecompressAndAdd(char *apSrcData, size_t alSize);
 
+		/**
+		* Gets the number of blocks in compressed data, 0 if it is a single zlib stream.
+		*/
+		static int GetCompressedBlockNum(const char *apSrcData, size_t alSize);
+		/**
+		* Decompresses a single block to current pos, the source must be block compressed.
+		*/
+		bool DecompressBlockAndAdd(const char *apSrcData, size_t alSize, int alBlock);
+
 		/**
 		* Decompresses the data from a source buffer, beginning at the current position. If abSizeDataWritten is false, it stops at EOF and assumes size has not been writen. If true, it will assume that the first 4 bytes is the size of the data.
 		* It also updates the current postion in the data for SrcBuffer
 		*/
 		bool DecompressAndAddFromBuffer(cBinaryBuffer *apSrcBuffer, bool abSizeDataWritten);
 
+		/**
+		* Sets the job manager used to compress and decompress blocks in parallel. If NULL, blocks are done one by one.
+		*/
+		static void SetJobManager(cJobManager *apJobManager){ mpJobManager = apJobManager;}
+		/**
+		* If false, CompressAndAdd always writes a single zlib stream (that older versions can read).
+		*/
+		static void SetUseBlockCompression(bool abX){ mbUseBlockCompression = abX;}
+		static bool GetUseBlockCompression(){ return mbUseBlockCompression;}
+
 		////////////////////////////////
 		// ENCRYPTION
 		////////////////////////////////
@@ -237,6 +262,9 @@ namespace hpl {
 
 		void InitAndAllocData();
 
+		bool CompressBlocksAndAdd(char *apSrcData, size_t alSize, int alCompressionLevel);
+		bool DecompressBlocksAndAdd(const char *apSrcData, size_t alSize);
+
 		tWString msFile;
 
 		char *mpData;
@@ -245,6 +273,9 @@ namespace hpl {
 		size_t mlReservedDataSize;
 
 		size_t mlCRCStartPos;
+
+		static cJobManager *mpJobManager;
+		static bool mbUseBlockCompression;
 	};
 
 };
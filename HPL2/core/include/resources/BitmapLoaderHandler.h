@@ -35,6 +35,7 @@ namespace hpl {
 	class iBitmapLoader;
 	class cResources;
 	class cGraphics;
+	class iMutex;
 	
 	//------------------------------------------------------------
 
@@ -44,6 +45,10 @@ namespace hpl {
 		cBitmapLoaderHandler(cResources* apResources, cGraphics* apGraphics);
 		~cBitmapLoaderHandler();
 
+		/**
+		 * Load and save can be called from any thread. The loaders are not thread safe (DevIL has global state),
+		 * so calls are done one at a time.
+		 */
 		cBitmap* LoadBitmap(const tWString& asFile, tBitmapLoadFlag aFlags);
 		bool SaveBitmap(cBitmap* apBitmap, const tWString& asFile, tBitmapSaveFlag aFlags);
 
@@ -52,6 +57,8 @@ namespace hpl {
 
 		cResources* mpResources;
 		cGraphics* mpGraphics;
+
+		iMutex* mpLoaderMutex;
 	};
 
 };
@@ -21,6 +21,7 @@
 #define HPL_LANGUAGE_FILE_H
 
 #include <map>
+#include <vector>
 #include "system/SystemTypes.h"
 
 namespace hpl {
@@ -55,6 +56,54 @@ namespace hpl {
 
 	//--------------------------------
 
+	/**
+	 * The contents of a single language file, as read from xml or a compiled file.
+	 */
+	class cLanguageFileDir
+	{
+	public:
+		tString msPath;
+		bool mbAddSubDirs;
+	};
+
+	class cLanguageFileEntry
+	{
+	public:
+		tString msName;
+		size_t mlTextStart;
+		size_t mlTextLength;
+	};
+
+	class cLanguageFileCategory
+	{
+	public:
+		tString msName;
+		std::vector<cLanguageFileEntry> mvEntries;
+	};
+
+	class cLanguageFileData
+	{
+	public:
+		std::vector<cLanguageFileDir> mvDirs;
+		std::vector<cLanguageFileCategory> mvCategories;
+		tWString mwsText;	///< All the entry texts after each other
+	};
+
+	//--------------------------------
+
+	class cLanguageLookupSlot
+	{
+	public:
+		unsigned int mlHash;
+		const tString *mpCategory;
+		const tString *mpName;
+		cLanguageEntry *mpEntry;
+	};
+
+	typedef std::vector<cLanguageLookupSlot> tLanguageLookupSlotVec;
+
+	//--------------------------------
+
 	class cLanguageFile
 	{
 	public:
@@ -66,12 +115,32 @@ namespace hpl {
 		const tWString& Translate(const tString& asCat, const tString& asName);
 
 		tLanguageCategoryMap* GetCategoryMap(){ return &m_mapCategories;}
+
+		/**
+		 * If a compiled binary version is loaded (and saved when missing or out of date) next to each language file.
+		 */
+		static void SetUseCompiledFiles(bool abX){ mbUseCompiledFiles = abX;}
+		static bool GetUseCompiledFiles(){ return mbUseCompiledFiles;}
         
 	private:
+		bool LoadXmlFile(const tWString& asPath, cLanguageFileData *apData);
+		bool LoadCompiledFile(const tWString& asCompiledPath, const tWString& asSourcePath, cLanguageFileData *apData);
+		void SaveCompiledFile(const tWString& asCompiledPath, const tWString& asSourcePath, cLanguageFileData *apData);
+		void AddData(cLanguageFileData *apData, bool abAddResourceDirs, const tWString& asAltPath);
+		
+		void DecodeText(const tString& asString, tWString& asDest);
+
+		void BuildLookupTable();
+		unsigned int GetLookupHash(const tString& asCat, const tString& asName);
+
 		tLanguageCategoryMap m_mapCategories;	
+		tLanguageLookupSlotVec mvLookupTable;
+		unsigned int mlLookupMask;
 		tWString mwsEmpty;
 
 		cResources *mpResources;
+
+		static bool mbUseCompiledFiles;
 	};
 
 };
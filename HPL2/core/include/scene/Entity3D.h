@@ -81,6 +81,10 @@ namespace hpl {
 		void SetWorldMatrix(const cMatrixf& a_mtxWorldTransform);
 
 		void SetTransformUpdated(bool abUpdateCallbacks = true);
+		/**
+		 * Calls OnTransformUpdate for all callbacks, for when SetTransformUpdated was called without them.
+		 */
+		void RunTransformUpdateCallbacks();
 		bool GetTransformUpdated();
 
 		int GetTransformUpdateCount();
@@ -215,6 +215,11 @@ namespace hpl {
 		void SetSourceRadius(float afX){ mfSourceRadius = afX;}
 
 		void UpdateLight(float afTimeStep);
+		/**
+		 * Updates fading and flickering without calling anything outside of the light (setters, sounds, particles, etc),
+		 * this is instead done in the following UpdateLogic. Can be run from a worker thread.
+		 */
+		void UpdateFadeAndFlicker(float afTimeStep);
 
 		void SetWorld(cWorld *apWorld){ mpWorld = apWorld;}
 
@@ -224,6 +229,11 @@ namespace hpl {
 		void OnFlickerOn();
 		void OnSetDiffuse();
 
+		void SetFadeRadius(float afX);
+		void SetFadeDiffuseColor(const cColor& aColor);
+		void RunFlickerEvent(bool abOn);
+		void ApplyFadeAndFlicker();
+
         virtual void ExtraXMLProperties(TiXmlElement *apMainElem){}
 		virtual void UpdateBoundingVolume()=0;
 		
@@ -293,6 +303,14 @@ namespace hpl {
 		bool mbFlickerOn;
 		float mfFlickerTime;
 		float mfFlickerStateLength;
+
+		///////////////////////////
+		//Deferred fade and flicker
+		bool mbDeferFadeAndFlicker;
+		bool mbFadeAndFlickerUpdated;
+		float mfPrevRadius;
+		cColor mPrevDiffuseColor;
+		tFlag mlFlickerEvents;
 	};
 
 	typedef std::list<iLight*> tLightList;
@@ -42,6 +42,7 @@ namespace hpl {
 	class cSubMesh;
 	class cMeshEntity;
 	class cAnimation;
+	class cAnimationTrack;
 	class cAnimationState;
 	class cNodeState;
 	class cBone;
@@ -62,6 +63,22 @@ namespace hpl {
 
 	//------------------------------------------
 
+	/**
+	 * The animation state values a skeleton pose was calculated from.
+	 */
+	class cAnimationPoseInput
+	{
+	public:
+		bool mbActive;
+		bool mbLoop;
+		float mfWeight;
+		float mfTimePos;
+	};
+
+	typedef std::vector<cAnimationPoseInput> tAnimationPoseInputVec;
+
+	//------------------------------------------
+
 	class cMeshEntityCallback
 	{
 	public:
@@ -194,6 +211,39 @@ namespace hpl {
 
 		void UpdateLogic(float afTimeStep);
 
+		/**
+		 * True if the animation pose can be calculated on its own, without touching other entities or physics.
+		 */
+		bool CanUpdateAnimationPoseInParallel();
+		/**
+		 * Sets the bone index of all tracks in the active animations. Must be done on the main thread before
+		 * UpdateAnimationPose is run from a worker, as the tracks are shared by all entities using the animation.
+		 */
+		void SetupAnimationTrackIndices();
+		/**
+		 * Calculates the skeleton pose from the animations. Can be run from a worker thread (as long as other threads 
+		 * do not use this entity) and must then be followed by UpdateLogic, which does the rest of the update.
+		 * The animation states are not changed, they are updated in UpdateLogic. If the states have been changed
+		 * in between (by a script or event), UpdateLogic throws the pose away and calculates it again.
+		 */
+		void UpdateAnimationPose(float afTimeStep);
+
+		/**
+		 * Sets how often the skeleton pose is calculated. 1 = every update, 2 = every second update and so on, 0 = never.
+		 * The pose is held in between, but animation time and events are still updated every time.
+		 */
+		void SetAnimationUpdateInterval(int alX){ mlAnimationUpdateInterval = alX;}
+		int GetAnimationUpdateInterval(){ return mlAnimationUpdateInterval;}
+
+		/**
+		 * The last render frame count (see iRenderer::GetRenderFrameCount) any of the sub meshes were rendered.
+		 */
+		int GetLastRenderFrameCount();
+		/**
+		 * True if any entities are attached to the bones. These can be seen even if the mesh itself is not.
+		 */
+		bool HasBoneEntityChildren();
+
 		void UpdateGraphicsForFrame(float afFrameTime);
 
 		void SetBody(iPhysicsBody* apBody){ mpBody = apBody;}
@@ -207,6 +257,12 @@ namespace hpl {
 
 		void CreateNodes();
 
+		bool UpdateSkeletonPose(float afTimeStep, bool abAnimationActive, bool abUpdateStates);
+		void SetupAnimationTrackIndex(cAnimationTrack *apTrack);
+		void UpdateAnimationStates(float afTimeStep);
+		bool IsAnimationPoseFrame();
+		void SaveAnimationPoseInputs();
+		bool AnimationPoseInputsChanged();
 		void UpdateNodeMatrixRec(cNode3D *apNode);
 
 		void HandleAnimationEvent(cAnimationEvent *apEvent);
@@ -266,6 +322,17 @@ namespace hpl {
 		bool mbUpdatedBones;
 		bool mbHasUpdatedAnimation;
 
+		bool mbAnimationPoseUpdated;
+		bool mbAnimationPoseActive;
+		bool mbAnimationPoseTransformUpdated;
+		tAnimationPoseInputVec mvAnimationPoseInputs;
+
+		bool mbHasAnimationPose;
+		int mlAnimationUpdateInterval;
+		int mlAnimationUpdateCount;
+		int mlBoneMatricesUpdateCount;
+		int mlBoneChildrenTransformCount;
+
 		tNodeStateVec mvNodeStates;
 		tNodeStateIndexMap m_mapNodeStateIndices;
 
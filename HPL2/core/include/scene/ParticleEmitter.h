@@ -173,7 +173,12 @@ namespace hpl {
 							cVector3f avSize, cGraphics* apGraphics,cResources *apResources);
 		virtual ~iParticleEmitter();
 
-		void UpdateLogic(float afTimeStep);
+		/**
+		 * If abDeferCallbacks is true, the entity callbacks (render container) are not called until RunDeferredCallbacks,
+		 * so that the update can be run in a job.
+		 */
+		void UpdateLogic(float afTimeStep, bool abDeferCallbacks=false);
+		void RunDeferredCallbacks();
 
 		void Render(){}
 
@@ -239,6 +244,7 @@ namespace hpl {
 
 		bool mbUpdateGfx;
 		bool mbUpdateBV;
+		bool mbCallbacksDeferred;
 
 		iVertexBuffer *mpVtxBuffer;
 
@@ -72,7 +72,7 @@ namespace hpl {
 
 	//------------------------------------
 
-	class cParticleEmitterData_UserData : public iParticleEmitterData, public iPhysicsRayCallback
+	class cParticleEmitterData_UserData : public iParticleEmitterData
 	{
 	friend class cParticleEmitter_UserData;
 	public:
@@ -88,12 +88,6 @@ namespace hpl {
 									cVector3f *apPosVec);
 
 	private:
-        bool OnIntersect(iPhysicsBody *pBody,cPhysicsRayParams *apParams);
-		float mfShortestDist;
-		bool mbIntersected;
-		cVector3f *mpIntersectNormal;
-		cVector3f *mpIntersectPos;
-
 		///////// GENERAL /////////////
 
 		// NEW
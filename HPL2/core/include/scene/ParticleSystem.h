@@ -84,7 +84,11 @@ namespace hpl {
 		bool IsVisible(){ return mbIsVisible;}
 		void SetVisible(bool abVisible);
 
-		void UpdateLogic(float afTimeStep);
+		/**
+		 * See iParticleEmitter::UpdateLogic.
+		 */
+		void UpdateLogic(float afTimeStep, bool abDeferCallbacks=false);
+		void RunDeferredCallbacks();
 
 		bool IsDead();
 		bool IsDying();
@@ -136,6 +136,7 @@ namespace hpl {
 		cRCNode_DynBoxTree *mpCheckForFitTempNode;
 
 		tRenderableSet m_setObjectsToUpdate;
+		std::vector<cBoundingVolume*> mvObjectsToUpdateBVs;
 
 		cDynBoxTreeObjectCallback *mpObjectCalllback;
 
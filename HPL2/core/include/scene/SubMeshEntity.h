@@ -97,9 +97,14 @@ namespace hpl {
 		
 		void UpdateLogic(float afTimeStep);
 
+		/**
+		 * For skinned meshes the triangle data is created from the current pose when asked for. Destroy it
+		 * when no longer needed.
+		 */
 		cTriangleData& GetTriangle(int alIndex);
 		int GetTriangleNum();
 		tTriangleDataVec* GetTriangleVecPtr();
+		void DestroyTriangleData();
 
 		void SetUpdateBody(bool abX);
 		bool GetUpdateBody();
@@ -120,12 +125,14 @@ namespace hpl {
 		cMaterialManager* mpMaterialManager;
 
 		iVertexBuffer* mpDynVtxBuffer;
-		tTriangleDataVec mvDynTriangles;
+		tTriangleDataVec* mpDynTriangles;
+		int mlDynTrianglesBoneMatricesCount;
 
 		cSubMeshEntityBodyUpdate* mpEntityCallback;
 		bool mbUpdateBody;
 
 		bool mbGraphicsUpdated;
+		int mlSkinnedBoneMatricesCount;
 
 		char mlStaticNullMatrixCount;
 		void *mpUserData;
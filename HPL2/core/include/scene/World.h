@@ -74,6 +74,7 @@ namespace hpl {
 	class cXmlElement;
 	class cEntFile;
 	class cDummyRenderable;
+	class cWorldUpdateJob;
 	
 
 	//-------------------------------------------------------------------
@@ -234,6 +235,20 @@ namespace hpl {
 		///// MESH ENTITY METHODS ////////////////////
 		
 		cMeshEntity* CreateMeshEntity(const tString &asName,cMesh *apMesh, bool abStatic=false);
+
+		/**
+		 * Animated skeleton meshes that are visible are updated every update within afHalfRateDist and every second beyond.
+		 * Meshes not seen lately are updated every second update within afFrozenDist and not at all beyond.
+		 */
+		void SetAnimationLODActive(bool abX){ mbAnimationLODActive = abX;}
+		bool GetAnimationLODActive(){ return mbAnimationLODActive;}
+		void SetAnimationLODDistances(float afHalfRateDist, float afFrozenDist){ mfAnimationLODHalfRateDist = afHalfRateDist; mfAnimationLODFrozenDist = afFrozenDist;}
+		float GetAnimationLODHalfRateDist(){ return mfAnimationLODHalfRateDist;}
+		float GetAnimationLODFrozenDist(){ return mfAnimationLODFrozenDist;}
+		/**
+		 * Set by the scene each time the world is rendered.
+		 */
+		void SetAnimationLODCameraPosition(const cVector3f& avPos){ mvAnimationLODCameraPos = avPos; mbAnimationLODCameraSet = true;}
 		void DestroyMeshEntity(cMeshEntity* apMesh);
 		cMeshEntity* GetDynamicMeshEntity(const tString& asName);
 		
@@ -364,6 +379,9 @@ namespace hpl {
 		void UpdateLights(float afTimeStep);
 		void UpdateSoundEntities(float afTimeStep);
 
+		void RunUpdateJobs(int alType, int alNum, float afTimeStep);
+		void UpdateAnimationLOD(cMeshEntity *apEntity);
+
 		tString msName;
 		tWString msFilePath;
 		bool mbActive;
@@ -415,6 +433,17 @@ namespace hpl {
 
 		int mlSoundCreationIDCount;
 
+		bool mbAnimationLODActive;
+		float mfAnimationLODHalfRateDist;
+		float mfAnimationLODFrozenDist;
+		cVector3f mvAnimationLODCameraPos;
+		bool mbAnimationLODCameraSet;
+
+		std::vector<cWorldUpdateJob*> mvUpdateJobs;
+		std::vector<cMeshEntity*> mvTempUpdateMeshEntities;
+		std::vector<cParticleSystem*> mvTempUpdateParticleSystems;
+		std::vector<iLight*> mvTempUpdateLights;
+
 		//tSoundEntityList mlstSoundEntityPool;<-Debugging
 
 		tEntFileList mlstEntFileCache;
@@ -21,6 +21,7 @@
 #define HPL_SOUNDHANDLER_H
 
 #include <list>
+#include <vector>
 
 #include "system/SystemTypes.h"
 #include "math/MathTypes.h"
@@ -28,12 +29,14 @@
 #include "engine/EngineTypes.h"
 
 #include "physics/PhysicsWorld.h"
+#include "system/JobManager.h"
 
 namespace hpl {
 	
 	class iLowLevelSound;
 	class iSoundChannel;
 	class cWorld;
+	class iTimer;
 
 	//----------------------------------------
 
@@ -62,6 +65,41 @@ namespace hpl {
 
 	//----------------------------------------
 
+	class cSoundOcclusionQuery
+	{
+	public:
+		cVector3f mvStart;
+		cVector3f mvEnd;
+		bool mbBlocked;
+	};
+
+	typedef std::vector<cSoundOcclusionQuery> tSoundOcclusionQueryVec;
+
+	//----------------------------------------
+
+	/**
+	 * Casts the rays for a range of occlusion queries, each job has its own ray callback.
+	 */
+	class cSoundOcclusionJob : public iJob
+	{
+	public:
+		cSoundOcclusionJob();
+		~cSoundOcclusionJob();
+
+		void Execute(int alThreadIndex);
+
+		iPhysicsWorld *mpPhysicsWorld;
+		cSoundOcclusionQuery *mpQueries;
+		int mlNumOfQueries;
+		double mfTime;
+
+	private:
+		cSoundRayCallback mRayCallback;
+		iTimer *mpTimer;
+	};
+
+	//----------------------------------------
+
 	////////////////////////////////////////////////////
 	//////////// SOUND ENTRY ///////////////////////////
 	////////////////////////////////////////////////////
@@ -74,6 +112,7 @@ namespace hpl {
 	
 	class cSoundEntry
 	{
+	friend class cSoundHandler;
 	public:
 		cSoundEntry(const tString& asName, iSoundChannel* apSound, float afVolume,
 					eSoundEntryType aType, bool ab3D,
@@ -143,6 +182,10 @@ namespace hpl {
 		float mfBlockFadeDest;
 		float mfBlockFadeSpeed;
 
+		bool mbBlocked;
+		int mlLastOcclusionQueryFrame;
+		int mlOcclusionQuery;
+
 		bool mbStream;
 		bool mbStopDisabled;
 
@@ -252,10 +295,31 @@ namespace hpl {
 		tSoundEntryList* GetEntryList();
 		
 		bool CheckSoundIsBlocked(const cVector3f& avSoundPosition);
+
+		/**
+		 * Sets the number of frames between each time a sound is checked for being blocked.
+		 */
+		void SetOcclusionQueryInterval(int alX){ mlOcclusionQueryInterval = alX;}
+		int GetOcclusionQueryInterval(){ return mlOcclusionQueryInterval;}
+		/**
+		 * Sets the max number of blocking checks done in a frame, sounds that do not fit are checked in the coming frames.
+		 */
+		void SetMaxOcclusionQueriesPerFrame(int alX){ mlMaxOcclusionQueriesPerFrame = alX;}
+		int GetMaxOcclusionQueriesPerFrame(){ return mlMaxOcclusionQueriesPerFrame;}
+
+		int GetOcclusionQueriesLastFrame(){ return mlOcclusionQueriesLastFrame;}
+		/**
+		 * Time in ms spent on blocking checks last frame, summed over all threads.
+		 */
+		double GetOcclusionQueryTimeLastFrame(){ return mfOcclusionQueryTimeLastFrame;}
 	
 	private:
 		cSoundEntry* GetEntry(const tString& asName);
 
+		bool AddOcclusionQuery(cSoundEntry *apEntry, const cVector3f& avSoundPosition);
+		void UpdateOcclusionQueries();
+		void CastOcclusionRays(iPhysicsWorld *apPhysicsWorld);
+
 		iLowLevelSound* mpLowLevelSound;
 		cResources* mpResources;
 
@@ -269,6 +333,15 @@ namespace hpl {
 
 		cSoundRayCallback mSoundRayCallback;
 
+		tSoundOcclusionQueryVec mvOcclusionQueries;
+		std::vector<cSoundOcclusionJob*> mvOcclusionJobs;
+		cJobCounter mOcclusionJobCounter;
+
+		int mlOcclusionQueryInterval;
+		int mlMaxOcclusionQueriesPerFrame;
+		int mlOcclusionQueriesLastFrame;
+		double mfOcclusionQueryTimeLastFrame;
+
 		int mlCount;
 		int mlIdCount;
 
@@ -0,0 +1,187 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HPL_JOB_MANAGER_H
+#define HPL_JOB_MANAGER_H
+
+#include <vector>
+#include <deque>
+#include <list>
+
+#include "system/Thread.h"
+
+namespace hpl {
+
+	//------------------------------------------
+
+	class iMutex;
+	class iSemaphore;
+	class cJobManager;
+
+	//------------------------------------------
+
+	//Thread index of the main thread, the only thread besides the workers that runs jobs.
+	#define kJobThreadIndex_Main 0
+	//Thread index of any other thread. Such a thread never runs queued jobs, it only waits for them.
+	#define kJobThreadIndex_None -1
+
+	//------------------------------------------
+
+	class iJob
+	{
+	public:
+		virtual ~iJob(){}
+
+		/**
+		 * Runs the job. Called from one of the workers or from the main thread while it waits on jobs.
+		 * Each index is only used by one thread, so it can be used to pick per thread data. A job must not keep
+		 * such data in use while it waits on other jobs, since the thread runs queued jobs while waiting.
+		 * \param alThreadIndex kJobThreadIndex_Main for the main thread, 1 to number of workers otherwise. 
+		 * kJobThreadIndex_None if the job is run directly by some other thread.
+		 */
+		virtual void Execute(int alThreadIndex)=0;
+	};
+
+	//------------------------------------------
+
+	/**
+	 * Keeps track of how many jobs added with the counter that are not done yet.
+	 * Should only be changed and checked through cJobManager. A counter can also be used as a dependency,
+	 * see cJobManager::AddDependentJob.
+	 */
+	class cJobCounter
+	{
+	friend class cJobManager;
+	public:
+		cJobCounter() : mlCount(0) {}
+
+	private:
+		int mlCount;
+	};
+
+	//------------------------------------------
+
+	class cJobWorker : public iThreadClass
+	{
+	public:
+		cJobWorker(cJobManager *apManager, int alThreadIndex);
+		~cJobWorker();
+
+		void UpdateThread();
+
+		iThread* GetThread(){ return mpThread;}
+
+	private:
+		cJobManager *mpManager;
+		iThread *mpThread;
+		int mlThreadIndex;
+	};
+
+	//------------------------------------------
+
+	/**
+	 * A fixed pool of workers that run jobs. Each thread has its own queue, jobs added from a job
+	 * go to the queue of the thread running it and idle threads steal jobs from the other queues.
+	 */
+	class cJobManager
+	{
+	friend class cJobWorker;
+	public:
+		/**
+		 * \param alNumOfWorkers Number of worker threads created. If 0, all jobs are run by the thread waiting for them.
+		 */
+		cJobManager(int alNumOfWorkers);
+		~cJobManager();
+
+		/**
+		 * Queues a job. The job must be valid until the counter has reached zero.
+		 * \param alThreadIndex The thread index of the calling job (as given to iJob::Execute). If < 0, the job is 
+		 * put in the queues in a round robin fashion.
+		 */
+		void AddJob(iJob *apJob, cJobCounter *apCounter, int alThreadIndex=-1);
+		/**
+		 * Queues a job that is not started until all jobs of apDependency are done.
+		 */
+		void AddDependentJob(iJob *apJob, cJobCounter *apCounter, cJobCounter *apDependency);
+
+		/**
+		 * Blocks until all jobs added with the counter are done. As long as there are queued jobs, they are run
+		 * by the calling thread, when there are none it sleeps until the last job is done.
+		 * \param alThreadIndex The thread index of the caller. kJobThreadIndex_Main if called from the main thread
+		 * outside of a job and kJobThreadIndex_None from any other thread that is not a worker. A thread with
+		 * kJobThreadIndex_None does not run any jobs, so there must be workers.
+		 */
+		void WaitForCounter(cJobCounter *apCounter, int alThreadIndex);
+		bool CounterIsDone(cJobCounter *apCounter);
+
+		int GetNumOfWorkers(){ return (int)mvWorkers.size();}
+		/**
+		 * Number of threads that can run jobs, including the waiting thread.
+		 */
+		int GetNumOfThreads(){ return (int)mvWorkers.size()+1;}
+	
+	private:
+		class cQueuedJob
+		{
+		public:
+			cQueuedJob(iJob *apJob, cJobCounter *apCounter) : mpJob(apJob), mpCounter(apCounter), mpDependency(0) {}
+			cQueuedJob(iJob *apJob, cJobCounter *apCounter, cJobCounter *apDependency) : 
+					mpJob(apJob), mpCounter(apCounter), mpDependency(apDependency) {}
+
+			iJob *mpJob;
+			cJobCounter *mpCounter;
+			cJobCounter *mpDependency;
+		};
+
+		class cJobQueue
+		{
+		public:
+			std::deque<cQueuedJob> mdqJobs;
+			iMutex *mpMutex;
+		};
+
+		class cCounterWaiter
+		{
+		public:
+			cJobCounter *mpCounter;
+			iSemaphore *mpSemaphore;
+		};
+
+		void QueueJob(const cQueuedJob& aJob, int alThreadIndex);
+		bool RunNextJob(int alThreadIndex);
+		bool PopJob(int alQueue, bool abFront, cQueuedJob *apJob);
+		void SleepUntilCounterIsDone(cJobCounter *apCounter);
+
+		std::vector<cJobWorker*> mvWorkers;
+		std::vector<cJobQueue*> mvQueues;
+		std::list<cQueuedJob> mlstDependentJobs;
+		std::list<cCounterWaiter> mlstCounterWaiters;
+		std::vector<iSemaphore*> mvFreeWaiterSemaphores;
+		int mlNextQueue;
+
+		iMutex *mpMutex;
+		iSemaphore *mpJobSemaphore;
+		bool mbExiting;
+	};
+
+	//------------------------------------------
+
+};
+#endif // HPL_JOB_MANAGER_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_LINEAR_ALLOCATOR_H
+#define HPL_LINEAR_ALLOCATOR_H
+
+#include <vector>
+#include <new>
+#include <stddef.h>
+
+namespace hpl {
+
+	//---------------------------------------
+
+	class cLinearAllocatorBlock
+	{
+	public:
+		char *mpData;
+		size_t mlSize;
+		size_t mlUsed;
+	};
+
+	//---------------------------------------
+
+	/**
+	 * Hands out memory by moving a position forward in a block, everything is freed at once with Reset.
+	 * No destructors are called, so it is only meant for plain data that lives until the next reset.
+	 */
+	class cLinearAllocator
+	{
+	public:
+		cLinearAllocator(size_t alBlockSize=64*1024);
+		~cLinearAllocator();
+
+		void* Allocate(size_t alSize, size_t alAlign=16);
+
+		template<class T> T* Create()
+		{
+			return new(Allocate(sizeof(T))) T();
+		}
+
+		template<class T> T* CreateArray(size_t alNum)
+		{
+			T *pArray = static_cast<T*>(Allocate(sizeof(T)*alNum));
+			for(size_t i=0; i<alNum; ++i) new(&pArray[i]) T();
+			return pArray;
+		}
+
+		/**
+		 * Frees all allocations. If more than one block was used they are replaced by one large block,
+		 * so the same amount of data fits without any new allocations next time.
+		 */
+		void Reset();
+
+		size_t GetUsedSize();
+		size_t GetReservedSize();
+
+	private:
+		void AddBlock(size_t alMinSize);
+
+		size_t mlBlockSize;
+		std::vector<cLinearAllocatorBlock> mvBlocks;
+		size_t mlCurrentBlock;
+	};
+
+	//---------------------------------------
+
+};
+#endif // HPL_LINEAR_ALLOCATOR_H
@@ -45,6 +45,25 @@ namespace hpl {
 	
 	//------------------------------------
 
+	#define kMemoryStatsMaxTags 64
+
+	/**
+	 * Allocation statistics for all allocations made from source files in one directory (the tag).
+	 */
+	class cMemoryStatsTag
+	{
+	public:
+		size_t mlFrameAllocCount;
+		size_t mlFrameAllocBytes;
+		size_t mlFrameFreeCount;
+
+		size_t mlTotalAllocCount;
+		size_t mlTotalAllocBytes;
+		size_t mlTotalFreeCount;
+	};
+
+	//------------------------------------
+
 	class cMemoryManager
 	{
 	public:
@@ -92,9 +111,61 @@ namespace hpl {
 
 		static int GetCreationCount(){ return mlCreationCount;}
 
+		////////////////////////////////
+		// Statistics (MEMORY_MANAGER_STATS)
+		// Cheap tracking of allocation counts and bytes per subsystem tag, taken from the directory
+		// of the allocating source file. Frees are counted for the tag of the deleting file, so alloc
+		// and free numbers are only roughly net. Counters are kept per thread and summed once per frame.
+
+		static void* AddStatsAllocation(void *apData, const char* apFile, int alLine, size_t alMemory);
+		static void* UpdateStatsAllocation(void *apOldData, void *apNewData, const char* apFile, int alLine, size_t alMemory);
+		static void AddStatsFree(const void *apData, const char* apFile);
+
+		template<class T>
+		static void StatsDelete(T* apData, const char* apFileString)
+		{
+			AddStatsFree(apData, apFileString);
+			delete apData;
+		}
+
+		template<class T>
+		static void StatsDeleteArray(T* apData, const char* apFileString)
+		{
+			AddStatsFree(apData, apFileString);
+			delete[] apData;
+		}
+
+		template<class T>
+		static void StatsFree(T* apData, const char* apFileString)
+		{
+			AddStatsFree(apData, apFileString);
+			free(apData);
+		}
+
+		/**
+		 * Sums up the counters of all threads and calculates the numbers for the last frame. Call once per frame.
+		 */
+		static void UpdateFrameStats();
+		/**
+		 * Logs the numbers per tag and the call sites with most sampled bytes.
+		 */
+		static void LogFrameStats();
+
+		static int GetStatsTagNum();
+		static const char* GetStatsTagName(int alIdx);
+		static const cMemoryStatsTag& GetStatsTag(int alIdx);
+
+		/**
+		 * Every n:th allocation on a thread has its call site saved, 0 turns sampling off.
+		 */
+		static void SetStatsSampleRate(int alX){ mlStatsSampleRate = alX;}
+		static int GetStatsSampleRate(){ return mlStatsSampleRate;}
+
 	private:
 		static bool mbLogCreation;
 		static int mlCreationCount;
+
+		static int mlStatsSampleRate;
 	};
 
 	//------------------------------------
@@ -122,6 +193,29 @@ namespace hpl {
 	#define hplFree(data) \
 			hpl::cMemoryManager::RemoveAndFree(data,__FILE__,__LINE__)
 
+#elif defined(MEMORY_MANAGER_STATS)
+
+	#define hplNew(classType, constructor) \
+			( classType *)hpl::cMemoryManager::AddStatsAllocation(new classType constructor ,__FILE__,__LINE__,sizeof(classType))
+
+	#define hplNewArray(classType, amount) \
+			( classType *) hpl::cMemoryManager::AddStatsAllocation(new classType [ amount ] ,__FILE__,__LINE__,(amount) * sizeof(classType))
+
+	#define hplMalloc(amount) \
+			hpl::cMemoryManager::AddStatsAllocation(malloc( amount ) ,__FILE__,__LINE__,(amount))
+
+	#define hplRealloc(data, amount) \
+			hpl::cMemoryManager::UpdateStatsAllocation(data, realloc( data, amount ) ,__FILE__,__LINE__,(amount))
+
+	#define hplDelete(data) \
+			hpl::cMemoryManager::StatsDelete(data,__FILE__)
+		
+	#define hplDeleteArray(data) \
+			hpl::cMemoryManager::StatsDeleteArray(data,__FILE__)
+
+	#define hplFree(data) \
+			hpl::cMemoryManager::StatsFree(data,__FILE__)
+
 #else
 	#define hplNew(classType, constructor) \
 			new classType constructor 
@@ -30,6 +30,7 @@ namespace hpl {
 	class iThread;
 	class iThreadClass;
 	class iMutex;
+	class iSemaphore;
 
 	//-----------------------------------------
 
@@ -143,6 +144,13 @@ namespace hpl {
 		static iThread* CreateThread(iThreadClass* apThreadClass);
 
 		static iMutex* CreateMutEx(); // If you name this method CreateMutex strange stuff will happen :S
+
+		static iSemaphore* CreateSemaPhore(unsigned int alInitialCount=0); // Same as above, CreateSemaphore is a Win32 macro.
+
+		/**
+		 * Returns the number of logical cores available, always at least 1.
+		 */
+		static int GetNumberOfCores();
 	
 	private:
         static void CreateMessageBoxBase(eMsgBoxType eType, const wchar_t* asCaption, const wchar_t* fmt, va_list ap);
@@ -254,6 +254,12 @@ namespace hpl {
 	{
 	public:
 		virtual tString Serialize_GetTopClass(){ return "";}
+
+		/**
+		 * If this returns an element, it is copied into the save instead of saving the members again.
+		 * The element must be the one SaveToElement created for this class earlier.
+		 */
+		virtual const TiXmlElement* Serialize_GetCachedElement(){ return NULL;}
 	};
 
 	//-------------------------------------------------
@@ -255,6 +255,19 @@ namespace hpl {
 		static void UIntStringToArray(unsigned int *apArray, const char* apString,int alSize);
 		static void FloatStringToArray(float *apArray, const char* apString,int alSize);
 
+		/**
+		 * Parses values separated by ' ', '\n', '\r', '\t' or ',' straight into an array, without any allocations.
+		 * \param alMaxSize max number of values to parse.
+		 * \param apStringEnd if not NULL, set to where parsing stopped, so parsing can be continued.
+		 * \return number of values parsed.
+		 */
+		static int ParseFloatArray(float *apArray, int alMaxSize, const char* apString, const char** apStringEnd=NULL);
+		static int ParseIntArray(int *apArray, int alMaxSize, const char* apString, const char** apStringEnd=NULL);
+		/**
+		 * Number of values in a string separated as in ParseFloatArray.
+		 */
+		static int GetValueCount(const char* apString);
+
 		static int CountCharsInString(const tString& aString, const tString& aChar);
 		static int CountCharsInStringW(const tWString& aString, const tWString& aChar);
 		
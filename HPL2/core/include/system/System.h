@@ -24,6 +24,7 @@ namespace hpl {
 
 	class iLowLevelSystem;
 	class cLogicTimer;
+	class cJobManager;
 
 	class cSystem
 	{
@@ -39,9 +40,15 @@ namespace hpl {
 		 * \return 
 		 */
 		cLogicTimer * CreateLogicTimer(unsigned int alUpdatesPerSec);
+
+		/**
+		 * The worker pool shared by all modules. Has one worker less than the number of cores, since the main thread helps out.
+		 */
+		cJobManager* GetJobManager(){ return mpJobManager;}
 	
 	private:
         iLowLevelSystem *mpLowLevelSystem;
+		cJobManager *mpJobManager;
 	};
 
 };
@@ -26,6 +26,8 @@
 #include "system/Platform.h"
 
 #include "math/Math.h"
+#include "physics/CollideShape.h"
+#include "resources/BinaryBuffer.h"
 
 
 #include "impl/tinyXML/tinyxml.h"
@@ -125,6 +127,28 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// EDGE JOB
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cAINodeEdgeJob::Execute(int alThreadIndex)
+	{
+		//Uses its own ray callback so jobs can cast at the same time.
+		tAIFreePathFlag flag = eAIFreePathFlag_SkipDynamic | eAIFreePathFlag_SkipVolatile;
+		for(int i=0; i<mlNumOfPairs; ++i)
+		{
+			cAINode *pNodeA = mpContainer->mvNodes[mpPairs[i].x];
+			cAINode *pNodeB = mpContainer->mvNodes[mpPairs[i].y];
+
+			bool bFree = mpContainer->FreePath(pNodeA->GetPosition(), pNodeB->GetPosition(),-1,flag,NULL,&mRayCallback);
+			mpResults[i] = bFree ? 1 : 0;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -290,6 +314,7 @@ namespace hpl {
 		pNode->mlID = alID;
 		pNode->mvPosition = avPosition;
 		pNode->mpUserData = apUserData;
+		pNode->mlIndex = (int)mvNodes.size();
 
 		mvNodes.push_back(pNode);
 		m_mapNodesByName.insert(tAINodeNameMap::value_type(asName,pNode));
@@ -338,64 +363,105 @@ namespace hpl {
 		}
 	};
 
+	class cSortNodePairs
+	{
+	public:
+		bool operator()(const cVector2l &aA, const cVector2l &aB)
+		{
+			if(aA.x != aB.x) return aA.x < aB.x;
+			return aA.y < aB.y;
+		}
+	};
+
 	void cAINodeContainer::Compile()
 	{
 		BuildNodeGridMap();
 
-		tAINodeVecIt CurrentNodeIt = mvNodes.begin();
-		for(; CurrentNodeIt != mvNodes.end(); ++CurrentNodeIt)
+		////////////////////////////////////////
+		//Collect the node pairs that are close enough. The free path test gives the same
+		//result in both directions, so each pair is only tested once.
+		std::vector<cVector2l> vPairs;
+		for(size_t i=0; i<mvNodes.size(); ++i)
 		{
-			cAINode *pNode = *CurrentNodeIt;
-			
-			////////////////////////////////////////
-			//Add the ends that are connected to the node.
-			/*Log("Node %s checks: ",pNode->GetName().c_str());
-			tAINodeVecIt EndNodeIt = mvNodes.begin();
-			for(; EndNodeIt != mvNodes.end(); ++EndNodeIt)
+			cAINode *pNode = mvNodes[i];
+
+			cAINodeIterator nodeIt = GetNodeIterator(pNode->mvPosition,mfMaxEndDistance*1.5f);
+			while(nodeIt.HasNext())
 			{
-				cAINode *pEndNode = *EndNodeIt;
+				cAINode *pEndNode = nodeIt.Next();
 
-				if(pEndNode == pNode) continue;				
+				if(pEndNode == pNode) continue;
 				float fDist = cMath::Vector3Dist(pNode->mvPosition, pEndNode->mvPosition);
 				if(fDist > mfMaxEndDistance*2) continue;
-				Log("'%s'(%f) ",pEndNode->GetName().c_str(),fDist);
 
 				float fHeight = fabs(pNode->mvPosition.y - pEndNode->mvPosition.y);
+				if(fHeight > mfMaxHeight) continue;
 
-				if(	fHeight <= mfMaxHeight &&
-				FreePath(pNode->mvPosition, pEndNode->mvPosition,-1,eAIFreePathFlag_SkipDynamic))
-				{
-				pNode->AddEdge(pEndNode);	
-				Log("Added!");
-				}
-				Log(", ");
+				vPairs.push_back(cVector2l(	cMath::Min(pNode->mlIndex, pEndNode->mlIndex), 
+											cMath::Max(pNode->mlIndex, pEndNode->mlIndex)) );
 			}
-			Log("\n");*/
-			//Log("Node %s checks: ",pNode->GetName().c_str());
-			cAINodeIterator nodeIt = GetNodeIterator(pNode->mvPosition,mfMaxEndDistance*1.5f);
-			while(nodeIt.HasNext())
+		}
+		std::sort(vPairs.begin(), vPairs.end(), cSortNodePairs());
+		vPairs.erase(std::unique(vPairs.begin(), vPairs.end()), vPairs.end());
+
+		////////////////////////////////////////
+		//Test the pairs, split among the job threads
+		std::vector<char> vResults(vPairs.size(), 0);
+		int lNumOfPairs = (int)vPairs.size();
+		if(lNumOfPairs > 0)
+		{
+			iPhysicsWorld *pPhysicsWorld = mpWorld->GetPhysicsWorld();
+			cJobManager *pJobManager = pPhysicsWorld ? pPhysicsWorld->GetJobManager() : NULL;
+
+			const int lMinPairsPerJob = 32;
+			int lNumOfJobs = 1;
+			if(pJobManager && pJobManager->GetNumOfWorkers()>0)
+				lNumOfJobs = cMath::Min(pJobManager->GetNumOfThreads()*4, (lNumOfPairs + lMinPairsPerJob-1) / lMinPairsPerJob);
+
+			std::vector<cAINodeEdgeJob> vJobs(lNumOfJobs);
+			int lPairsPerJob = (lNumOfPairs + lNumOfJobs-1) / lNumOfJobs;
+			for(int i=0; i<lNumOfJobs; ++i)
 			{
-				cAINode *pEndNode = nodeIt.Next();
+				int lStart = cMath::Min(i*lPairsPerJob, lNumOfPairs);
 
-                if(pEndNode == pNode) continue;				
-				float fDist = cMath::Vector3Dist(pNode->mvPosition, pEndNode->mvPosition);
-				if(fDist > mfMaxEndDistance*2) continue;
-				//Log("'%s'(%f) ",pEndNode->GetName().c_str(),fDist);
-                				
-				float fHeight = fabs(pNode->mvPosition.y - pEndNode->mvPosition.y);
-				
-				tAIFreePathFlag flag = eAIFreePathFlag_SkipDynamic | eAIFreePathFlag_SkipVolatile;
-				if(	fHeight <= mfMaxHeight &&
-					FreePath(pNode->mvPosition, pEndNode->mvPosition,-1,flag))
-				{
-					pNode->AddEdge(pEndNode);	
-					//Log("Added!");
-				}
-				//Log(", ");
+				vJobs[i].mpContainer = this;
+				vJobs[i].mpPairs = &vPairs[0] + lStart;
+				vJobs[i].mpResults = &vResults[0] + lStart;
+				vJobs[i].mlNumOfPairs = cMath::Min(lPairsPerJob, lNumOfPairs - lStart);
 			}
-			//Log("\n");
 
-			
+			if(lNumOfJobs == 1)
+			{
+				vJobs[0].Execute(kJobThreadIndex_Main);
+			}
+			else
+			{
+				//Bounding volumes are updated when read, so make sure the jobs only read them.
+				pPhysicsWorld->UpdateBodyBoundingVolumes();
+
+				cJobCounter counter;
+				for(int i=0; i<lNumOfJobs; ++i) pJobManager->AddJob(&vJobs[i], &counter);
+				pJobManager->WaitForCounter(&counter, kJobThreadIndex_Main);
+			}
+		}
+
+		////////////////////////////////////////
+		//Add edges in both directions
+		for(size_t i=0; i<vPairs.size(); ++i)
+		{
+			if(vResults[i]==0) continue;
+
+			cAINode *pNodeA = mvNodes[vPairs[i].x];
+			cAINode *pNodeB = mvNodes[vPairs[i].y];
+			pNodeA->AddEdge(pNodeB);
+			pNodeB->AddEdge(pNodeA);
+		}
+
+		tAINodeVecIt CurrentNodeIt = mvNodes.begin();
+		for(; CurrentNodeIt != mvNodes.end(); ++CurrentNodeIt)
+		{
+			cAINode *pNode = *CurrentNodeIt;
+
 			///////////////////////////////////////
 			//Sort nodes and remove unwanted ones.
 			std::sort(pNode->mvEdges.begin(), pNode->mvEdges.end(), cSortEndNodes());
@@ -510,6 +576,14 @@ namespace hpl {
 	
 	bool cAINodeContainer::FreePath(const cVector3f &avStart, const cVector3f &avEnd, int alRayNum, 
 									tAIFreePathFlag aFlags,iAIFreePathCallback *apCallback)
+	{
+		return FreePath(avStart, avEnd, alRayNum, aFlags, apCallback, mpRayCallback);
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cAINodeContainer::FreePath(const cVector3f &avStart, const cVector3f &avEnd, int alRayNum, 
+									tAIFreePathFlag aFlags,iAIFreePathCallback *apCallback, cAINodeRayCallback *apRayCallback)
 	{
 		iPhysicsWorld *pPhysicsWorld = mpWorld->GetPhysicsWorld();
 		if(pPhysicsWorld==NULL) return true;
@@ -532,7 +606,7 @@ namespace hpl {
 		const float fHalfHeight = mvSize.y * 0.4f;
 		
 		//Setup ray callback
-		mpRayCallback->SetFlags(aFlags);
+		apRayCallback->SetFlags(aFlags);
 
 		//Iterate through all the rays.
 		for(int i=0; i< alRayNum; ++i)
@@ -541,12 +615,12 @@ namespace hpl {
 			cVector3f vStart = vStartCenter + vAdd;
 			cVector3f vEnd = vEndCenter + vAdd;
 
-			mpRayCallback->Reset(); 
-			mpRayCallback->mpCallback = apCallback;
+			apRayCallback->Reset(); 
+			apRayCallback->mpCallback = apCallback;
 
-			pPhysicsWorld->CastRay(mpRayCallback,vStart,vEnd,false,false,false,true);
+			pPhysicsWorld->CastRay(apRayCallback,vStart,vEnd,false,false,false,true);
 			
-			if(mpRayCallback->Intersected()) return false;
+			if(apRayCallback->Intersected()) return false;
 		}
 
 		return true;
@@ -556,56 +630,203 @@ namespace hpl {
 	
 	void cAINodeContainer::SaveToFile(const tWString &asFile)
 	{
-		TiXmlDocument* pXmlDoc = hplNew( TiXmlDocument,() );
-		
-		TiXmlElement *pRootElem = static_cast<TiXmlElement*>(pXmlDoc->InsertEndChild(TiXmlElement("AINodes")));
-
+		cBinaryBuffer binBuff(asFile);
+
+		////////////////////////////////////////
+		// Header
+		binBuff.AddInt32(AI_NODE_CACHE_MAGIC_NUMBER);
+		binBuff.AddInt32(AI_NODE_CACHE_VERSION);
+		binBuff.AddInt32((int)mvNodes.size());
+		binBuff.AddInt32((int)GetNodeSetHash());
+		binBuff.AddInt32((int)GetStaticGeometryHash());
+
+		////////////////////////////////////////
+		// Edges, as node index and distance
 		for(size_t i=0; i< mvNodes.size(); ++i)
 		{
 			cAINode * pNode = mvNodes[i];
-			TiXmlElement *pNodeElem = static_cast<TiXmlElement*>(pRootElem->InsertEndChild(TiXmlElement("Node")));
-
-			pNodeElem->SetAttribute("Name", pNode->GetName().c_str());
-			pNodeElem->SetAttribute("ID", cString::ToString(pNode->GetID()).c_str());
 
+			binBuff.AddInt32(pNode->GetEdgeNum());
 			for(int edge =0; edge < pNode->GetEdgeNum(); ++edge)
 			{
 				cAINodeEdge *pEdge = pNode->GetEdge(edge);
-				TiXmlElement *pEdgeElem = static_cast<TiXmlElement*>(pNodeElem->InsertEndChild(TiXmlElement("Edge")));
-
-				pEdgeElem->SetAttribute("Node", pEdge->mpNode->GetName().c_str());
-				tString sDistance = cString::ToString(pEdge->mfDistance);
-				pEdgeElem->SetAttribute("Distance", sDistance.c_str());
+				binBuff.AddInt32(pEdge->mpNode->mlIndex);
+				binBuff.AddFloat32(pEdge->mfDistance);
 			}
 		}
 
-		FILE *pFile = cPlatform::OpenFile(asFile, _W("w+"));
-		if(pFile==NULL || pXmlDoc->SaveFile(pFile)==false)
+		if(binBuff.Save()==false)
 		{
-			Error("Couldn't save XML file %s\n",asFile.c_str());
-			hplDelete(pXmlDoc);
-			return;
+			Error("Couldn't save AI node file %s\n",cString::To8Char(asFile).c_str());
 		}
-		fclose(pFile);
-		hplDelete(pXmlDoc);
 	}
-	
+
 	//-----------------------------------------------------------------------
-	
-	void cAINodeContainer::LoadFromFile(const tWString &asFile)
+
+	bool cAINodeContainer::LoadFromFile(const tWString &asFile, bool abAllowUnstamped)
 	{
 		BuildNodeGridMap();
 
+		cBinaryBuffer binBuff(asFile);
+		if(binBuff.Load()==false) return false;
+
+		////////////////////////////////////////
+		// Header, files without the magic number are old XML files.
+		if(binBuff.GetSize() < sizeof(int)*5 || binBuff.GetInt32() != AI_NODE_CACHE_MAGIC_NUMBER)
+		{
+			if(abAllowUnstamped==false) return false;
+			return LoadFromXmlFile(asFile);
+		}
+
+		if(binBuff.GetInt32() != AI_NODE_CACHE_VERSION) return false;
+
+		int lNodeNum = binBuff.GetInt32();
+		unsigned int lNodeSetHash = (unsigned int)binBuff.GetInt32();
+		unsigned int lGeometryHash = (unsigned int)binBuff.GetInt32();
+
+		if(lNodeNum != (int)mvNodes.size() || lNodeSetHash != GetNodeSetHash())
+		{
+			Log("AI nodes in '%s' have changed\n",cString::To8Char(asFile).c_str());
+			return false;
+		}
+		if(lGeometryHash != GetStaticGeometryHash())
+		{
+			Log("Static geometry for '%s' has changed\n",cString::To8Char(asFile).c_str());
+			return false;
+		}
+
+		////////////////////////////////////////
+		// Edges
+		for(size_t i=0; i< mvNodes.size(); ++i)
+		{
+			cAINode *pNode = mvNodes[i];
+
+			int lEdgeNum = binBuff.GetPos() + sizeof(int) <= binBuff.GetSize() ? binBuff.GetInt32() : -1;
+			if(lEdgeNum < 0 || binBuff.GetPos() + lEdgeNum*sizeof(int)*2 > binBuff.GetSize())
+			{
+				Warning("AI node file '%s' is corrupt\n",cString::To8Char(asFile).c_str());
+				ClearEdges();
+				return false;
+			}
+
+			pNode->mvEdges.resize(lEdgeNum);
+			for(int edge=0; edge<lEdgeNum; ++edge)
+			{
+				int lIndex = binBuff.GetInt32();
+				float fDistance = binBuff.GetFloat32();
+				if(lIndex < 0 || lIndex >= lNodeNum)
+				{
+					Warning("AI node file '%s' is corrupt\n",cString::To8Char(asFile).c_str());
+					ClearEdges();
+					return false;
+				}
+
+				cAINodeEdge &Edge = pNode->mvEdges[edge];
+				Edge.mpNode = mvNodes[lIndex];
+				Edge.mfDistance = fDistance;
+				Edge.mfSqrDistance = fDistance*fDistance;
+			}
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static unsigned int HashData(unsigned int alHash, const void *apData, size_t alSize)
+	{
+		//FNV-1a
+		const unsigned char *pData = (const unsigned char*)apData;
+		for(size_t i=0; i<alSize; ++i)
+		{
+			alHash ^= pData[i];
+			alHash *= 16777619u;
+		}
+		return alHash;
+	}
+
+	static const unsigned int kHashStart = 2166136261u;
+
+	//-----------------------------------------------------------------------
+
+	unsigned int cAINodeContainer::GetNodeSetHash()
+	{
+		unsigned int lHash = kHashStart;
+
+		//Properties that change the edges
+		lHash = HashData(lHash, mvSize.v, sizeof(float)*3);
+		lHash = HashData(lHash, &mlMaxNodeEnds, sizeof(int));
+		lHash = HashData(lHash, &mlMinNodeEnds, sizeof(int));
+		lHash = HashData(lHash, &mfMaxEndDistance, sizeof(float));
+		lHash = HashData(lHash, &mfMaxHeight, sizeof(float));
+		char lAtCenter = mbNodeIsAtCenter ? 1 : 0;
+		lHash = HashData(lHash, &lAtCenter, 1);
+
+		for(size_t i=0; i< mvNodes.size(); ++i)
+		{
+			cAINode *pNode = mvNodes[i];
+			lHash = HashData(lHash, pNode->msName.c_str(), pNode->msName.size());
+			lHash = HashData(lHash, &pNode->mlID, sizeof(int));
+			lHash = HashData(lHash, pNode->mvPosition.v, sizeof(float)*3);
+		}
+
+		return lHash;
+	}
+
+	//-----------------------------------------------------------------------
+
+	unsigned int cAINodeContainer::GetStaticGeometryHash()
+	{
+		iPhysicsWorld *pPhysicsWorld = mpWorld->GetPhysicsWorld();
+		if(pPhysicsWorld==NULL) return 0;
+
+		////////////////////////////////////////
+		// Hash the bodies that block when compiling (see cAINodeRayCallback::BeforeIntersect).
+		// The body hashes are summed so the order bodies are created in does not matter.
+		unsigned int lHash = 0;
+		cPhysicsBodyIterator it = pPhysicsWorld->GetBodyIterator();
+		while(it.HasNext())
+		{
+			iPhysicsBody *pBody = it.Next();
+			if(pBody->GetCollideCharacter()==false || pBody->GetMass() > 0 || pBody->IsCharacter() || pBody->IsVolatile()) continue;
+
+			unsigned int lBodyHash = kHashStart;
+			lBodyHash = HashData(lBodyHash, pBody->GetName().c_str(), pBody->GetName().size());
+			lBodyHash = HashData(lBodyHash, pBody->GetWorldMatrix().v, sizeof(float)*16);
+
+			iCollideShape *pShape = pBody->GetShape();
+			if(pShape)
+			{
+				unsigned int lShapeHash = pShape->GetGeometryHash();
+				lBodyHash = HashData(lBodyHash, &lShapeHash, sizeof(unsigned int));
+			}
+
+			lHash += lBodyHash;
+		}
+
+		return lHash;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+	
+	bool cAINodeContainer::LoadFromXmlFile(const tWString &asFile)
+	{
 		FILE *pFile = cPlatform::OpenFile(asFile, _W("rb"));
-		if(pFile==NULL) return;
-		
+		if(pFile==NULL) return false;
+
 		TiXmlDocument* pXmlDoc = hplNew( TiXmlDocument, () );
 		if(pXmlDoc->LoadFile(pFile)==false)
 		{
 			Warning("Couldn't open XML file %s\n",cString::To8Char(asFile).c_str());
 			fclose(pFile);
 			hplDelete(pXmlDoc);
-			return;
+			return false;
 		}
 		fclose(pFile);
 
@@ -618,7 +839,7 @@ namespace hpl {
 			int alID = cString::ToInt(pNodeElem->Attribute("ID"),-1);
 
 			cAINode *pNode = GetNodeFromID(alID);
-            
+
 			TiXmlElement *pEdgeElem = pNodeElem->FirstChildElement("Edge");
 			for(; pEdgeElem != NULL; pEdgeElem = pEdgeElem->NextSiblingElement("Edge"))
 			{
@@ -635,15 +856,18 @@ namespace hpl {
 		}
 
 		hplDelete(pXmlDoc);
+		return true;
 	}
+
 	//-----------------------------------------------------------------------
-	
-	//////////////////////////////////////////////////////////////////////////
-	// PRIVATE METHODS
-	//////////////////////////////////////////////////////////////////////////
+
+	void cAINodeContainer::ClearEdges()
+	{
+		for(size_t i=0; i< mvNodes.size(); ++i) mvNodes[i]->mvEdges.clear();
+	}
 
 	//-----------------------------------------------------------------------
-	
+
 	cVector2l cAINodeContainer::GetGridPosFromLocal(const cVector2f &avLocalPos)
 	{
 		cVector2l vGridPos;
@@ -173,6 +173,7 @@ namespace hpl {
 		switch(aApi)
 		{
 			case eHplAPI_OpenGL: pGameSetup = hplNew(cSDLEngineSetup, (alHplModuleFlags) ); break;
+			case eHplAPI_Null: pGameSetup = hplNew(cSDLEngineSetup, (alHplModuleFlags, eHplAPI_Null) ); break;
 		}
 
 		return hplNew( cEngine,  (pGameSetup,alHplModuleFlags, apVars) ); 
@@ -301,7 +302,7 @@ namespace hpl {
 						apVars->mSound.mbLowLevelLogging);
 
 		//Init physics
-		mpPhysics->Init(mpResources);
+		mpPhysics->Init(mpResources, mpSystem);
 
 		//Init AI
 		mpAI->Init();
@@ -522,6 +523,7 @@ namespace hpl {
 				
 				//Log("Swap done: %d\n", cPlatform::GetApplicationTime());
 				mpUpdater->RunMessage(eUpdateableMessage_OnPostBufferSwap);
+				cMemoryManager::UpdateFrameStats();
 				bSwappedOnce =true;
 				if(mbRenderOnce) continue;
 			}
@@ -25,6 +25,39 @@
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// UPDATE CONTAINER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cUpdateContainer::Add(iUpdateable* apUpdate)
+	{
+		mvUpdateables.push_back(apUpdate);
+		for(int i=0; i<eUpdateableMessage_LastEnum; ++i)
+		{
+			if(apUpdate->IsMessageUnused((eUpdateableMessage)i)) continue;
+			mvMessageUpdateables[i].push_back(apUpdate);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cUpdateContainer::RemoveUnused(eUpdateableMessage aMessage)
+	{
+		tUpdateableVec &vUpdateables = mvMessageUpdateables[aMessage];
+
+		size_t lCount=0;
+		for(size_t i=0; i<vUpdateables.size(); ++i)
+		{
+			if(vUpdateables[i]->IsMessageUnused(aMessage)) continue;
+			vUpdateables[lCount++] = vUpdateables[i];
+		}
+		vUpdateables.resize(lCount);
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -33,8 +66,8 @@ namespace hpl {
 
 	cUpdater::cUpdater(iLowLevelSystem *apLowLevelSystem)
 	{
-		mpCurrentUpdates = NULL;
-		msCurrentUpdates = "";
+		mlCurrentContainer = -1;
+		mlMessageDepth = 0;
 
 		mpLowLevelSystem = apLowLevelSystem;
 	}
@@ -43,6 +76,7 @@ namespace hpl {
 
 	cUpdater::~cUpdater()
 	{
+		STLDeleteAll(mvUpdateContainers);
 	}
 
 	//-----------------------------------------------------------------------
@@ -55,22 +89,12 @@ namespace hpl {
 
 	void cUpdater::BroadcastMessageToAll(eUpdateableMessage aMessage, float afX)
 	{
-		for(tUpdateableListIt it = mlstGlobalUpdateableList.begin();it!=mlstGlobalUpdateableList.end();++it)
-		{
-			iUpdateable *pUpdateable = *it;
-			pUpdateable->RunMessage(aMessage, afX);
-		}
+		RunMessageInContainer(&mGlobalContainer, aMessage, afX, false);
 
-		tUpdateContainerMapIt contIt = m_mapUpdateContainer.begin();
-		for(; contIt != m_mapUpdateContainer.end(); ++contIt)
+		//Containers are sent the message in name order.
+		for(size_t i=0; i<mvSortedContainerIds.size(); ++i)
 		{
-			tUpdateableList *pUpdateList = &contIt->second;
-			
-			for(tUpdateableListIt it = pUpdateList->begin();it!=pUpdateList->end();++it)
-			{
-				iUpdateable *pUpdateable = *it;
-				pUpdateable->RunMessage(aMessage, afX);	
-			}
+			RunMessageInContainer(mvUpdateContainers[mvSortedContainerIds[i]], aMessage, afX, false);
 		}
 	}
 
@@ -78,57 +102,11 @@ namespace hpl {
 
 	void cUpdater::RunMessage(eUpdateableMessage aMessage, float afX)
 	{
-		if(aMessage != eUpdateableMessage_Update)
-		{
-			for(tUpdateableListIt it = mlstGlobalUpdateableList.begin();it!=mlstGlobalUpdateableList.end();++it)
-			{
-				iUpdateable *pUpdateable = *it;
-				pUpdateable->RunMessage(aMessage, afX);
-			}
+		RunMessageInContainer(&mGlobalContainer, aMessage, afX, false);
 
-			if(mpCurrentUpdates)
-			{
-				tUpdateableList *pCurrentUpdateContainer = mpCurrentUpdates;
-				for(tUpdateableListIt it = mpCurrentUpdates->begin();it!=mpCurrentUpdates->end();++it)
-				{
-					iUpdateable *pUpdateable = *it;
-					pUpdateable->RunMessage(aMessage, afX);	
-					
-					//In case the container is change, do not do any more updating.
-					if(mpCurrentUpdates != pCurrentUpdateContainer) break;;
-				}
-			}
-		}
-		else
+		if(mlCurrentContainer >= 0)
 		{
-			for(tUpdateableListIt it = mlstGlobalUpdateableList.begin();it!=mlstGlobalUpdateableList.end();++it)
-			{
-				iUpdateable *pUpdateable = *it;
-				//Log("pUpdateable %d, ", pUpdateable);
-				//Log("'%s'\n", pUpdateable->GetName().c_str());
-
-				START_TIMING_EX(pUpdateable->GetName().c_str(),game)
-				pUpdateable->RunMessage(aMessage, afX);
-				STOP_TIMING(game)
-			}
-
-			if(mpCurrentUpdates)
-			{
-				tUpdateableList *pCurrentUpdateContainer = mpCurrentUpdates;
-				for(tUpdateableListIt it = mpCurrentUpdates->begin();it!=mpCurrentUpdates->end();++it)
-				{
-					iUpdateable *pUpdateable = *it;
-					//Log("pUpdateable %d, ", pUpdateable);
-					//Log("'%s'\n", pUpdateable->GetName().c_str());
-
-					START_TIMING_EX(pUpdateable->GetName().c_str(),game)
-					pUpdateable->RunMessage(aMessage, afX);	
-					STOP_TIMING(game)
-					
-					//In case the container is change, do not do any more updating.
-					if(mpCurrentUpdates != pCurrentUpdateContainer) break;;
-				}
-			}	
+			RunMessageInContainer(mvUpdateContainers[mlCurrentContainer], aMessage, afX, true);
 		}
 	}
 	
@@ -137,45 +115,41 @@ namespace hpl {
 	
 	bool cUpdater::SetContainer(tString asContainer)
 	{
-		tUpdateContainerMapIt it = m_mapUpdateContainer.find(asContainer);
-		if(it == m_mapUpdateContainer.end()) return false;
+		int lId = GetContainerId(asContainer);
+		if(lId < 0) return false;
 
-		if(&it->second == mpCurrentUpdates) return true;
+		return SetContainer(lId);
+	}
 
-		tString sOldContainer = msCurrentUpdates;
+	//-----------------------------------------------------------------------
 
-		/////////////////////////////////
-		//Determine if the log updater should be active or not
-		msCurrentUpdates = asContainer;
-		/*if(msCurrentUpdates == "Default")
-		{
-			SetUpdateLogActive(true);
-		}
-		else
-		{
-			SetUpdateLogActive(false);
-		}*/
-		//SetUpdateLogActive(true);
+	bool cUpdater::SetContainer(int alId)
+	{
+		if(alId < 0 || alId >= (int)mvUpdateContainers.size()) return false;
+
+		if(alId == mlCurrentContainer) return true;
+
+		cUpdateContainer *pNewContainer = mvUpdateContainers[alId];
+		tString sOldContainer = GetCurrentContainerName();
 
 		/////////////////////////////////
 		// If was a previous container, send leave message
-		if(mpCurrentUpdates)
+		if(mlCurrentContainer >= 0)
 		{
-			for(tUpdateableListIt it = mpCurrentUpdates->begin(); it!=mpCurrentUpdates->end(); ++it)
+			tUpdateableVec &vUpdateables = mvUpdateContainers[mlCurrentContainer]->mvUpdateables;
+			for(size_t i=0; i<vUpdateables.size(); ++i)
 			{
-				iUpdateable *pUpdateable = *it;
-				pUpdateable->OnLeaveContainer(asContainer);
+				vUpdateables[i]->OnLeaveContainer(pNewContainer->msName);
 			}
 		}
 		
-		mpCurrentUpdates = &it->second;
+		mlCurrentContainer = alId;
 
 		/////////////////////////////////
 		// Send enter message
-		for(tUpdateableListIt it = mpCurrentUpdates->begin(); it!=mpCurrentUpdates->end(); ++it)
+		for(size_t i=0; i<pNewContainer->mvUpdateables.size(); ++i)
 		{
-			iUpdateable *pUpdateable = *it;
-			pUpdateable->OnEnterContainer(sOldContainer);
+			pNewContainer->mvUpdateables[i]->OnEnterContainer(sOldContainer);
 		}
 		
 		return true;
@@ -183,23 +157,39 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	tString cUpdater::GetCurrentContainerName()
+	int cUpdater::GetContainerId(const tString& asName)
 	{
-		if(mpCurrentUpdates==NULL) return "";
+		for(size_t i=0; i<mvUpdateContainers.size(); ++i)
+		{
+			if(mvUpdateContainers[i]->msName == asName) return (int)i;
+		}
+		return -1;
+	}
 
-		return msCurrentUpdates;
+	//-----------------------------------------------------------------------
+
+	tString cUpdater::GetCurrentContainerName()
+	{
+		if(mlCurrentContainer < 0) return "";
 
+		return mvUpdateContainers[mlCurrentContainer]->msName;
 	}
 	
 	//-----------------------------------------------------------------------
 
 	bool cUpdater::AddContainer(tString asName)
 	{
-		//Create the value for the map with key and Updateable
-		tUpdateContainerMap::value_type val = tUpdateContainerMap::value_type(
-														asName, tUpdateableList());
-		//Add it to the map
-		m_mapUpdateContainer.insert(val);
+		if(GetContainerId(asName) >= 0) return true;
+
+		cUpdateContainer *pContainer = hplNew( cUpdateContainer, () );
+		pContainer->msName = asName;
+		mvUpdateContainers.push_back(pContainer);
+
+		//Keep the ids sorted by name as well
+		int lId = (int)mvUpdateContainers.size()-1;
+		std::vector<int>::iterator it = mvSortedContainerIds.begin();
+		while(it != mvSortedContainerIds.end() && mvUpdateContainers[*it]->msName < asName) ++it;
+		mvSortedContainerIds.insert(it, lId);
 		
 		return true;
 	}
@@ -213,12 +203,12 @@ namespace hpl {
 			return false;
 		}
 
-		//Search the map for the container name
-		tUpdateContainerMapIt it = m_mapUpdateContainer.find(asContainer);
-		if(it == m_mapUpdateContainer.end()) return false;
+		//Search for the container name
+		int lId = GetContainerId(asContainer);
+		if(lId < 0) return false;
 		
 		//Add the updatable
-		it->second.push_back(apUpdate);
+		mvUpdateContainers[lId]->Add(apUpdate);
 
 		return true;
 	}
@@ -227,7 +217,7 @@ namespace hpl {
 
 	bool cUpdater::AddGlobalUpdate(iUpdateable* apUpdate)
 	{
-		mlstGlobalUpdateableList.push_back(apUpdate);
+		mGlobalContainer.Add(apUpdate);
 		return true;
 	}
 
@@ -239,7 +229,45 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 	
-	
+	void cUpdater::RunMessageInContainer(cUpdateContainer *apContainer, eUpdateableMessage aMessage, float afX, bool abStopAtContainerChange)
+	{
+		//Use index, as updateables might be added during the update.
+		tUpdateableVec &vUpdateables = apContainer->mvMessageUpdateables[aMessage];
+		int lContainer = mlCurrentContainer;
+		bool bFoundUnused = false;
+
+		mlMessageDepth++;
+		for(size_t i=0; i<vUpdateables.size(); ++i)
+		{
+			iUpdateable *pUpdateable = vUpdateables[i];
+			
+			if(aMessage == eUpdateableMessage_Update)
+			{
+				//Log("pUpdateable %d, ", pUpdateable);
+				//Log("'%s'\n", pUpdateable->GetName().c_str());
+
+				START_TIMING_EX(pUpdateable->GetName().c_str(),game)
+				pUpdateable->RunMessage(aMessage, afX);
+				STOP_TIMING(game)
+			}
+			else
+			{
+				pUpdateable->RunMessage(aMessage, afX);
+			}
+
+			if(pUpdateable->IsMessageUnused(aMessage)) bFoundUnused = true;
+			
+			//In case the container is change, do not do any more updating.
+			if(abStopAtContainerChange && mlCurrentContainer != lContainer) break;
+		}
+
+		mlMessageDepth--;
+
+		/////////////////////////////////
+		// Remove the updateables that do not implement the message, so they are not called again.
+		// Not done for messages sent from within another message, since the list might be iterated.
+		if(bFoundUnused && mlMessageDepth==0) apContainer->RemoveUnused(aMessage);
+	}
 
 	//-----------------------------------------------------------------------
 }
@@ -20,6 +20,7 @@
 #include "graphics/Bitmap.h"
 
 #include "system/LowLevelSystem.h"
+#include "math/Math.h"
 
 #include <memory>
 #include <cstring>
@@ -352,6 +353,61 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	cBitmap* cBitmap::CreateDownscaledCopy(const cVector2l& avMaxSize, int alImage, int alMipMap)
+	{
+		if(mbDataIsCompressed || mvSize.z > 1 || mlBytesPerPixel > 4) return NULL;
+
+		//////////////////////////////
+		//Get size, keeping the aspect and never scaling up
+		float fScale = cMath::Min(	(float)avMaxSize.x / (float)mvSize.x,
+									(float)avMaxSize.y / (float)mvSize.y);
+		if(fScale > 1.0f) fScale = 1.0f;
+
+		cVector3l vDestSize(cMath::Max((int)((float)mvSize.x*fScale),1), cMath::Max((int)((float)mvSize.y*fScale),1), 1);
+
+		cBitmap *pDestBmp = hplNew(cBitmap, () );
+		pDestBmp->CreateData(vDestSize, mPixelFormat, 0, 0);
+
+		unsigned char *pSrcData = GetData(alImage, alMipMap)->mpData;
+		unsigned char *pDestData = pDestBmp->GetData(0,0)->mpData;
+		int lBpp = mlBytesPerPixel;
+
+		//////////////////////////////
+		//Box filter, each dest pixel is the average of the source pixels it covers
+		unsigned int vSum[4];
+		for(int y=0; y<vDestSize.y; ++y)
+		{
+			int lSrcY0 = (y * mvSize.y) / vDestSize.y;
+			int lSrcY1 = cMath::Max(((y+1) * mvSize.y) / vDestSize.y, lSrcY0+1);
+
+			for(int x=0; x<vDestSize.x; ++x)
+			{
+				int lSrcX0 = (x * mvSize.x) / vDestSize.x;
+				int lSrcX1 = cMath::Max(((x+1) * mvSize.x) / vDestSize.x, lSrcX0+1);
+
+				for(int i=0; i<lBpp; ++i) vSum[i] = 0;
+
+				for(int sy=lSrcY0; sy<lSrcY1; ++sy)
+				{
+					unsigned char *pSrcPixel = &pSrcData[(sy*mvSize.x + lSrcX0)*lBpp];
+					for(int sx=lSrcX0; sx<lSrcX1; ++sx)
+					{
+						for(int i=0; i<lBpp; ++i) vSum[i] += pSrcPixel[i];
+						pSrcPixel += lBpp;
+					}
+				}
+
+				unsigned int lCount = (unsigned int)((lSrcY1-lSrcY0) * (lSrcX1-lSrcX0));
+				unsigned char *pDestPixel = &pDestData[(y*vDestSize.x + x)*lBpp];
+				for(int i=0; i<lBpp; ++i) pDestPixel[i] = (unsigned char)(vSum[i] / lCount);
+			}
+		}
+
+		return pDestBmp;
+	}
+
+	//-----------------------------------------------------------------------
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHODS
@@ -32,6 +32,9 @@
 #include "resources/AnimationManager.h"
 #include "scene/MeshEntity.h"
 #include "math/Math.h"
+#include "math/TriangleBVH.h"
+
+#include <algorithm>
 
 namespace hpl {
 
@@ -586,9 +589,42 @@ namespace hpl {
 		int lPosStride = pSubMeshVB->GetElementNum(eVertexBufferElement_Position);
 		int lNrmStride = pSubMeshVB->GetElementNum(eVertexBufferElement_Normal);
 
-		// Clip every triangle in submesh
-		for(int j=0;j<pSubMeshVB->GetIndexNum();j+=3)
+		//////////////////////////////////////////////////
+		// Get the triangles that can touch the decal
+		mvClipTriangles.clear();
+		if(pSubMeshVB->GetUsageType() == eVertexBufferUsageType_Static)
+		{
+			//Local space bounds of the decal box, the triangle hierarchy is cached in the vertex buffer.
+			cVector3f vAxes[] = { mvDecalRight, mvDecalUp, mvDecalForward };
+			cVector3f vDecalHalfSize = mvDecalSize*0.5f;
+			cVector3f vLocalMin(100000000.0f), vLocalMax(-100000000.0f);
+			for(int i=0; i<8; ++i)
+			{
+				cVector3f vCorner = mvDecalPosition;
+				for(int j=0; j<3; ++j)
+					vCorner += vAxes[j] * (i & (1<<j) ? vDecalHalfSize.v[j] : -vDecalHalfSize.v[j]);
+				
+				cVector3f vLocalCorner = cMath::MatrixMul(mtxInvSubMeshWorldMatrix, vCorner);
+				vLocalMin = cMath::Vector3Min(vLocalMin, vLocalCorner);
+				vLocalMax = cMath::Vector3Max(vLocalMax, vLocalCorner);
+			}
+
+			pSubMeshVB->GetTriangleBVH()->FindTrianglesInBox(vLocalMin, vLocalMax, mvClipTriangles);
+
+			//Keep mesh order so the result is the same as when clipping all triangles
+			std::sort(mvClipTriangles.begin(), mvClipTriangles.end());
+		}
+		else
+		{
+			mvClipTriangles.reserve(pSubMeshVB->GetIndexNum()/3);
+			for(int j=0;j<pSubMeshVB->GetIndexNum();j+=3)
+				mvClipTriangles.push_back(j);
+		}
+
+		// Clip every triangle in submesh that is near the decal
+		for(size_t tri=0;tri<mvClipTriangles.size();++tri)
 		{
+			int j = mvClipTriangles[tri];
 			cVector3f vTriangle[3];
 			cVector3f vNormal[3];
 			
@@ -62,6 +62,9 @@ namespace hpl {
 	{
 		mpLowLevelGraphics = apLowLevelGraphics;
 		mpResources = NULL;
+
+		static unsigned int lFontIdCount = 0;
+		mlFontId = ++lFontIdCount;
 	}
 	
 	//-----------------------------------------------------------------------
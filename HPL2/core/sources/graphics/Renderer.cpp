@@ -115,6 +115,7 @@ namespace hpl {
 		////////////////////////
 		// Setup data
 		mlCurrentOcclusionObject = 0;
+		mbOcclusionObjectsSorted = true;
 		
 		////////////////////////
 		// Set up General Variables
@@ -268,27 +269,41 @@ namespace hpl {
 		pObject->mpMatrix = apMatrix;
 		pObject->mbDepthTest = abDepthTest;
 
-		m_setOcclusionObjects.insert(tOcclusionQueryObjectMap::value_type(apSource, pObject));
+		mvOcclusionObjects.push_back(tOcclusionQueryObjectPair(apSource, pObject));
+		mbOcclusionObjectsSorted = false;
 
 		++mlCurrentOcclusionObject;
 	}
 	
 	//-----------------------------------------------------------------------
 
+	static bool SortFunc_OcclusionObjectSource(const tOcclusionQueryObjectPair& aPairA, const tOcclusionQueryObjectPair& aPairB)
+	{
+		return aPairA.first < aPairB.first;
+	}
+
 
 	int cRenderSettings::RetrieveOcclusionObjectSamples(iRenderer *apRenderer, void *apSource, int alCustomIndex)
 	{
-		tOcclusionQueryObjectMapIt it = m_setOcclusionObjects.find(apSource);
-		if(it == m_setOcclusionObjects.end()){
+		//////////////////////////////////////
+		//Sort once after all objects are assigned, then binary search
+		if(mbOcclusionObjectsSorted==false)
+		{
+			std::stable_sort(mvOcclusionObjects.begin(), mvOcclusionObjects.end(), SortFunc_OcclusionObjectSource);
+			mbOcclusionObjectsSorted = true;
+		}
+
+		tOcclusionQueryObjectPairVecIt it = std::lower_bound(	mvOcclusionObjects.begin(), mvOcclusionObjects.end(), 
+																tOcclusionQueryObjectPair(apSource, NULL), SortFunc_OcclusionObjectSource);
+		if(it == mvOcclusionObjects.end() || it->first != apSource){
 			if(mbLog) Log(" Could not find source %d custom index %d in occlusion objects set!\n", apSource, alCustomIndex);
 			return 0;
 		}
 
 		//////////////////////////////////////
-		//Get the number of objects with key and get the one with right custom ID
-		size_t lCount = m_setOcclusionObjects.count(apSource);
+		//Get the one with right custom ID among the objects with the source
 		cOcclusionQueryObject* pObject = NULL;
-		for(size_t i=0; i < lCount; ++i)
+		for(; it != mvOcclusionObjects.end() && it->first == apSource; ++it)
 		{
 			cOcclusionQueryObject* pTestObject = it->second;
 			if(pTestObject->mlCustomID == alCustomIndex)
@@ -296,7 +311,6 @@ namespace hpl {
 				pObject = pTestObject;
 				break;
 			}
-			it++;
 		}
 		if(pObject==NULL)
 		{
@@ -342,7 +356,8 @@ namespace hpl {
 	void cRenderSettings::ClearOcclusionObjects(iRenderer *apRenderer)
 	{
 		if(mbLog) Log(" Clearing occlusion queries i settings!\n");
-		m_setOcclusionObjects.clear();
+		mvOcclusionObjects.resize(0);
+		mbOcclusionObjectsSorted = true;
 		for(int i=0; i<mlCurrentOcclusionObject; ++i)
 		{
 			iOcclusionQuery *pQuery = mvOcclusionObjectPool[i]->mpQuery;
@@ -544,6 +559,10 @@ namespace hpl {
 			Log("-----------------  START -------------------------\n");
 		}
 
+		//////////////////////////////////////////
+		//Free last frame's temporary data
+		if(abAtStartOfRendering) mFrameAllocator.Reset();
+
 		//////////////////////////////////////////
 		//Set up variables
 		mfCurrentFrameTime = afFrameTime;
@@ -1005,7 +1024,7 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void iRenderer::AddAndRenderNodeOcclusionQuery(tNodeOcclusionPairList *apList, iRenderableContainerNode *apNode, bool abObjectsRendered)
+	void iRenderer::AddAndRenderNodeOcclusionQuery(cNodeOcclusionPairQueue *apQueue, iRenderableContainerNode *apNode, bool abObjectsRendered)
 	{
 		//DEBUG
 		// Skip using a query and just render the node.
@@ -1018,21 +1037,21 @@ namespace hpl {
 
 		//////////////////////
 		//Create the pair
-		cNodeOcclusionPair noPair;
-		noPair.mpNode = apNode;
-		noPair.mpQuery = GetOcclusionQuery();
-		noPair.mbObjectsRendered = abObjectsRendered;
+		cNodeOcclusionPair *pPair = mFrameAllocator.Create<cNodeOcclusionPair>();
+		pPair->mpNode = apNode;
+		pPair->mpQuery = GetOcclusionQuery();
+		pPair->mbObjectsRendered = abObjectsRendered;
 
-		if(mbLog)Log("CHC: Testing query %d on node: %d\n",noPair.mpQuery, apNode);
+		if(mbLog)Log("CHC: Testing query %d on node: %d\n",pPair->mpQuery, apNode);
 
 		/////////////////////
 		// Render node AABB
-		RenderNodeBoundingBox(apNode, noPair.mpQuery);		
+		RenderNodeBoundingBox(apNode, pPair->mpQuery);		
 		
 		
 		/////////////////////
 		// Add to list
-		apList->push_back(noPair);
+		apQueue->Add(pPair);
 	}
 
 	//-----------------------------------------------------------------------
@@ -1201,7 +1220,7 @@ namespace hpl {
 		pContainers[0] = mpCurrentWorld->GetRenderableContainer(eWorldContainerType_Static);
 		pContainers[1] = mpCurrentWorld->GetRenderableContainer(eWorldContainerType_Dynamic);
 
-		tNodeOcclusionPairList lstNodeOcclusionPairs;
+		cNodeOcclusionPairQueue nodeOcclusionPairs;
 
 		// Set up output variables
 		mpCurrentSettings->mlNumberOfOcclusionQueries =0;
@@ -1248,7 +1267,7 @@ namespace hpl {
 				
 		////////////////////////////
 		//Iterate the nodes on the stack.
-		while(setNodeStack.empty()==false || lstNodeOcclusionPairs.empty()==false)
+		while(setNodeStack.empty()==false || nodeOcclusionPairs.IsEmpty()==false)
 		{
 			//if(mbLog) PrintNodeDebugContents(setNodeStack);
 
@@ -1289,7 +1308,7 @@ namespace hpl {
 															
 					/////////////////////////////////////
 					// Render AABB and add query to list
-					AddAndRenderNodeOcclusionQuery(&lstNodeOcclusionPairs, pNode, bRenderObjects);
+					AddAndRenderNodeOcclusionQuery(&nodeOcclusionPairs, pNode, bRenderObjects);
 					
 					//////////////////////////
 					//Render node objects after AABB so that an object does not occlude its own node.
@@ -1336,9 +1355,9 @@ namespace hpl {
 
 			///////////////////////////
 			//If node-query list is not empty, check if the first query is ready
-			if(lstNodeOcclusionPairs.empty()==false)
+			if(nodeOcclusionPairs.IsEmpty()==false)
 			{
-				cNodeOcclusionPair& noPair = lstNodeOcclusionPairs.front();
+				cNodeOcclusionPair& noPair = *nodeOcclusionPairs.GetFirst();
 
 							
 				//////////////////////////////////////
@@ -1359,7 +1378,7 @@ namespace hpl {
 					int lSampleCount = noPair.mpQuery->GetSampleCount();
 					ReleaseOcclusionQuery(noPair.mpQuery);
 					
-					lstNodeOcclusionPairs.pop_front(); //Makes noPair invalid
+					nodeOcclusionPairs.RemoveFirst(); //Pair memory stays valid until the frame allocator is reset
 
 					if(mbLog)Log("CHC: Fetching query %d on node: %d, samples: %d\n",noPair.mpQuery, pNode, lSampleCount);
 
@@ -202,7 +202,6 @@ namespace hpl {
 
 	cRendererDeferred::~cRendererDeferred()
 	{
-		STLDeleteAll(mvTempDeferredLights);	
 	}
 
 	//-----------------------------------------------------------------------
@@ -1635,7 +1634,7 @@ namespace hpl {
 	{
 		//////////////////////////
 		// Check query results from last frame and clear list.
-		tLightSet setPrevVisibleLights;
+		mvPrevVisibleLights.resize(0);
 		if(mbOcclusionTestLargeLights)
 		{
 			for(size_t i=0; i<mpCurrentSettings->mvLightOcclusionPairs.size(); ++i)
@@ -1644,18 +1643,19 @@ namespace hpl {
 				
 				if(loPair.mlSampleResults > mpCurrentSettings->mlSampleVisiblilityLimit)
 				{
-					setPrevVisibleLights.insert(loPair.mpLight);
+					mvPrevVisibleLights.push_back(loPair.mpLight);
 				}
 			}
+			std::sort(mvPrevVisibleLights.begin(), mvPrevVisibleLights.end());
 
 			mpCurrentSettings->mvLightOcclusionPairs.resize(0);
 		}
         
 
 		//////////////////////////
-		// Clear light list
-		STLDeleteAll_NoClear(mvTempDeferredLights);
+		// Clear light list and get data for all lights in one go (freed when the frame allocator is reset)
 		mvTempDeferredLights.resize(0);
+		cDeferredLight* pLightDataArray = mFrameAllocator.CreateArray<cDeferredLight>(mpCurrentRenderList->GetLightNum());
 
 		////////////////////////////////
 		// Set up variables
@@ -1678,7 +1678,7 @@ namespace hpl {
 		//Iterate all lights in render list
 		for(int i=0; i<mpCurrentRenderList->GetLightNum(); ++i)
 		{
-			cDeferredLight* pLightData = hplNew( cDeferredLight, () );
+			cDeferredLight* pLightData = &pLightDataArray[i];
 			iLight* pLight = mpCurrentRenderList->GetLight(i);
 			eLightType lightType = pLight->GetLightType();
 
@@ -1798,7 +1798,7 @@ namespace hpl {
 
 			///////////////////////////
 			// Only check if light was invisible last frame
-			if(STLObjectExists(setPrevVisibleLights,pLight)) continue;
+			if(std::binary_search(mvPrevVisibleLights.begin(), mvPrevVisibleLights.end(), pLight)) continue;
 
 			////////////////////////////////
 			//Render light shape and make a query
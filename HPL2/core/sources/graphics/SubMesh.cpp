@@ -56,6 +56,9 @@ namespace hpl {
 
 		mbCollideShape = false;
 
+		mbEdgesCreated = false;
+		mbTrianglesCreated = false;
+
 		mpVertexWeights = NULL;
 		mpVertexBones = NULL;
 
@@ -213,6 +216,51 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 
 
+	tTriEdgeVec* cSubMesh::GetEdgeVecPtr()
+	{
+		if(mbEdgesCreated==false && mpVtxBuffer)
+		{
+			mbEdgesCreated = true;
+
+			bool bDoubleSided = false;
+			cMath::CreateEdges(	mvEdges, mpVtxBuffer->GetIndices(), mpVtxBuffer->GetIndexNum(),
+								mpVtxBuffer->GetFloatArray(eVertexBufferElement_Position),
+								mpVtxBuffer->GetElementNum(eVertexBufferElement_Position),
+								mpVtxBuffer->GetVertexNum(), &bDoubleSided);
+		}
+		return &mvEdges;
+	}
+
+	//-----------------------------------------------------------------------
+
+	tTriangleDataVec* cSubMesh::GetTriangleVecPtr()
+	{
+		if(mbTrianglesCreated==false && mpVtxBuffer)
+		{
+			mbTrianglesCreated = true;
+
+			cMath::CreateTriangleData(	mvTriangles, mpVtxBuffer->GetIndices(), mpVtxBuffer->GetIndexNum(),
+										mpVtxBuffer->GetFloatArray(eVertexBufferElement_Position),
+										mpVtxBuffer->GetElementNum(eVertexBufferElement_Position),
+										mpVtxBuffer->GetVertexNum());
+		}
+		return &mvTriangles;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSubMesh::DestroyTriangleData()
+	{
+		//Swap to make sure the memory is released
+		tTriEdgeVec().swap(mvEdges);
+		tTriangleDataVec().swap(mvTriangles);
+
+		mbEdgesCreated = false;
+		mbTrianglesCreated = false;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cSubMesh::Compile()
 	{
 		CheckOneSided();
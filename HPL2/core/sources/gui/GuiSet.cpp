@@ -93,6 +93,32 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 	
 
+	//////////////////////////////////////////////////////////////////////////
+	// TEXT LAYOUT
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cGuiTextLayoutKey::operator<(const cGuiTextLayoutKey& aOther) const
+	{
+		if(mpFont != aOther.mpFont) return mpFont < aOther.mpFont;
+		if(mvSize.x != aOther.mvSize.x) return mvSize.x < aOther.mvSize.x;
+		if(mvSize.y != aOther.mvSize.y) return mvSize.y < aOther.mvSize.y;
+		
+		return msText < aOther.msText;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cGuiTextGlyphCompare::operator()(const cGuiTextGlyph& aGlyphA, const cGuiTextGlyph& aGlyphB) const
+	{
+		if(aGlyphA.mpGfx->mpMaterial != aGlyphB.mpGfx->mpMaterial) return aGlyphA.mpGfx->mpMaterial < aGlyphB.mpGfx->mpMaterial;
+		
+		return aGlyphA.mpGfx->mvTextures[0] < aGlyphB.mpGfx->mvTextures[0];
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// RENDER OBJECT
 	//////////////////////////////////////////////////////////////////////////
@@ -279,6 +305,8 @@ namespace hpl {
 		mlPopupCount =0;
 		mfLastPopUpZ = 20;
 
+		mlTextLayoutFrame = 0;
+
 		mvDrawOffset =0;
 
 		mfContextMenuZ = 500;
@@ -353,6 +381,8 @@ namespace hpl {
 		}
 		mbDestroyingSet = false;
 
+		STLMapDeleteAll(m_mapTextLayouts);
+
 		ClearGlobalShortcuts();
 	}
 
@@ -574,6 +604,9 @@ namespace hpl {
 	void cGuiSet::ClearRenderObjects()
 	{
 		m_setRenderObjects.clear();
+
+		//No render object points to a text layout now, so unused ones can be removed.
+		DestroyUnusedTextLayouts();
 	}
 
 	//-----------------------------------------------------------------------
@@ -1457,19 +1490,107 @@ namespace hpl {
 										const cColor& aColor, eGuiMaterial aMaterial,
 										eFontAlign aAlign)
 	{
-		int lCount =0;
-		cVector3f vPos = avPosition;
+		if(mpCurrentClipRegion==NULL) return;
+		if(mpCurrentClipRegion->mRect.w ==0 || mpCurrentClipRegion->mRect.h==0) return;
+
+		cGuiTextLayout *pLayout = GetTextLayout(apString, apFont, avSize);
+		if(pLayout->mvGlyphs.empty()) return;
+
+		cVector3f vPos = avPosition + mvDrawOffset;
 
 		//////////////////////////////////////////////////////
 		// Change position depending on the alignment
 		if(aAlign == eFontAlign_Center){
-			vPos.x -= apFont->GetLength(avSize, apString)/2;
+			vPos.x -= pLayout->mfLength/2;
 		}
 		else if(aAlign == eFontAlign_Right)
 		{
-			vPos.x -= apFont->GetLength(avSize, apString);
+			vPos.x -= pLayout->mfLength;
+		}
+
+		//////////////////////////////////////////////////////
+		// Check if the text is inside clip region
+		if(mpCurrentClipRegion->mRect.w >0)
+		{
+			cRect2f textRect = pLayout->mRect;
+			textRect.x += vPos.x;
+			textRect.y += vPos.y;
+
+			if(cMath::CheckRectIntersection(mpCurrentClipRegion->mRect,textRect)==false) return;
+		}
+
+		//////////////////////////////////////////////////////
+		// Add a render object for each run of glyphs with same texture
+		cGuiRenderObject object;
+		object.mpClipRegion = mpCurrentClipRegion;
+		object.mvPos = vPos;
+		object.mColor = aColor;
+		object.mbRotated = false;
+
+		if(aMaterial != eGuiMaterial_LastEnum)	object.mpCustomMaterial = mpGui->GetMaterial(aMaterial);
+		else									object.mpCustomMaterial = NULL;	
+
+		for(size_t i=0; i<pLayout->mvRunStarts.size(); ++i)
+		{
+			int lStart = pLayout->mvRunStarts[i];
+			int lEnd = i+1 < pLayout->mvRunStarts.size() ? pLayout->mvRunStarts[i+1] : (int)pLayout->mvGlyphs.size();
+
+			for(int j=lStart; j<lEnd; ++j) pLayout->mvGlyphs[j].mpGfx->Flush();
+
+			object.mpGfx = pLayout->mvGlyphs[lStart].mpGfx;
+			object.mpTextGlyphs = &pLayout->mvGlyphs[lStart];
+			object.mlTextGlyphNum = lEnd - lStart;
+
+			m_setRenderObjects.insert(object);
+		}
+	}
+
+	//--------------------------------------------------------------
+
+	cGuiTextLayout* cGuiSet::GetTextLayout(const wchar_t* apString, iFontData *apFont, const cVector2f& avSize)
+	{
+		mTempTextLayoutKey.mpFont = apFont;
+		mTempTextLayoutKey.mvSize = avSize;
+		mTempTextLayoutKey.msText = apString;
+
+		cGuiTextLayout *pLayout = NULL;
+
+		tGuiTextLayoutMapIt it = m_mapTextLayouts.find(mTempTextLayoutKey);
+		if(it != m_mapTextLayouts.end())
+		{
+			pLayout = it->second;
+
+			//A new font might have been created at the same address.
+			if(pLayout->mlFontId != apFont->GetFontId())
+			{
+				CreateTextLayout(pLayout, apString, apFont, avSize);
+			}
+		}
+		else
+		{
+			pLayout = hplNew( cGuiTextLayout, () );
+			CreateTextLayout(pLayout, apString, apFont, avSize);
+
+			m_mapTextLayouts.insert(tGuiTextLayoutMap::value_type(mTempTextLayoutKey, pLayout));
 		}
 
+		pLayout->mlLastUsedFrame = mlTextLayoutFrame;
+
+		return pLayout;
+	}
+
+	//--------------------------------------------------------------
+
+	void cGuiSet::CreateTextLayout(cGuiTextLayout *apLayout, const wchar_t* apString, iFontData *apFont, const cVector2f& avSize)
+	{
+		apLayout->mlFontId = apFont->GetFontId();
+		apLayout->mvGlyphs.clear();
+		apLayout->mvRunStarts.clear();
+
+		cVector2f vMin(0), vMax(0);
+		float fX = 0;
+		int lCount =0;
+
 		//////////////////////////////////////////////////////
 		// Iterate the characters in string until NULL is found
 		while(apString[lCount] != 0)
@@ -1486,19 +1607,74 @@ namespace hpl {
 			//Get actual number of the glyph in the font.
 			lGlyphNum -= apFont->GetFirstChar();
 			
-			//Get glyph data and draw.
+			//Get glyph data and add.
 			cGlyph *pGlyph = apFont->GetGlyph(lGlyphNum);
 			if(pGlyph)
 			{
-				cVector2f vOffset(pGlyph->mvOffset * avSize);
-				cVector2f vSize(pGlyph->mvSize * avSize);// *apFont->GetSizeRatio());
+				const cVector3f& vGfxOffset = pGlyph->mpGuiGfx->GetOffset();
 
-				DrawGfx(pGlyph->mpGuiGfx,vPos + vOffset,vSize,aColor,aMaterial);
+				cGuiTextGlyph glyph;
+				glyph.mpGfx = pGlyph->mpGuiGfx;
+				glyph.mvOffset = pGlyph->mvOffset * avSize + cVector2f(fX + vGfxOffset.x, vGfxOffset.y);
+				glyph.mvSize = pGlyph->mvSize * avSize;
 
-				vPos.x += pGlyph->mfAdvance*avSize.x; 
+				if(apLayout->mvGlyphs.empty())
+				{
+					vMin = glyph.mvOffset;
+					vMax = glyph.mvOffset + glyph.mvSize;
+				}
+				else
+				{
+					vMin.x = cMath::Min(vMin.x, glyph.mvOffset.x);
+					vMin.y = cMath::Min(vMin.y, glyph.mvOffset.y);
+					vMax.x = cMath::Max(vMax.x, glyph.mvOffset.x + glyph.mvSize.x);
+					vMax.y = cMath::Max(vMax.y, glyph.mvOffset.y + glyph.mvSize.y);
+				}
+
+				apLayout->mvGlyphs.push_back(glyph);
+
+				fX += pGlyph->mfAdvance*avSize.x; 
 			}
 			lCount++;
 		}
+
+		apLayout->mfLength = fX;
+		apLayout->mRect = cRect2f(vMin.x, vMin.y, vMax.x - vMin.x, vMax.y - vMin.y);
+
+		//////////////////////////////////////////////////////
+		// Group glyphs with same material and texture into runs, keeping string order within each.
+		cGuiTextGlyphCompare glyphCompare;
+		std::stable_sort(apLayout->mvGlyphs.begin(), apLayout->mvGlyphs.end(), glyphCompare);
+		for(size_t i=0; i<apLayout->mvGlyphs.size(); ++i)
+		{
+			if(i==0 || glyphCompare(apLayout->mvGlyphs[i-1], apLayout->mvGlyphs[i]))
+			{
+				apLayout->mvRunStarts.push_back((int)i);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+
+	void cGuiSet::DestroyUnusedTextLayouts()
+	{
+		++mlTextLayoutFrame;
+		if(mlTextLayoutFrame % 60 != 0) return;
+
+		tGuiTextLayoutMapIt it = m_mapTextLayouts.begin();
+		while(it != m_mapTextLayouts.end())
+		{
+			cGuiTextLayout *pLayout = it->second;
+			if(mlTextLayoutFrame - pLayout->mlLastUsedFrame > 60)
+			{
+				hplDelete(pLayout);
+				m_mapTextLayouts.erase(it++);
+			}
+			else
+			{
+				++it;
+			}
+		}
 	}
 
 	//--------------------------------------------------------------
@@ -1631,7 +1807,32 @@ namespace hpl {
 
 				///////////////////////////
 				// Add object to batch
-				if(object.mbRotated)
+				if(object.mpTextGlyphs)
+				{
+					const cVector3f& vPos = object.mvPos;
+					for(int lGlyph=0; lGlyph<object.mlTextGlyphNum; ++lGlyph)
+					{
+						const cGuiTextGlyph &glyph = object.mpTextGlyphs[lGlyph];
+						cGuiGfxElement *pGlyphGfx = glyph.mpGfx;
+						for(int i=0; i<4; ++i)
+						{
+							cVertex &vtx = pGlyphGfx->mvVtx[i];
+							cVector3f& vVtxPos = vtx.pos;
+							pLowLevelGraphics->AddVertexToBatch_Raw(
+								cVector3f(	vVtxPos.x * glyph.mvSize.x + glyph.mvOffset.x + vPos.x,
+											vVtxPos.y * glyph.mvSize.y + glyph.mvOffset.y + vPos.y,
+											vPos.z),
+								vtx.col * object.mColor,
+								vtx.tex);
+						}
+
+						for(int i=0;i<4;i++)
+							pLowLevelGraphics->AddIndexToBatch(lIdxAdd + i);
+
+						lIdxAdd += 4;
+					}
+				}
+				else if(object.mbRotated)
 				{
 					for(int i=0; i<4; ++i)
 					{
@@ -1674,10 +1875,14 @@ namespace hpl {
 					}
 				}
 
-				for(int i=0;i<4;i++)
-					pLowLevelGraphics->AddIndexToBatch(lIdxAdd + i);
+				//Text runs have added indices for each of their glyphs
+				if(object.mpTextGlyphs==NULL)
+				{
+					for(int i=0;i<4;i++)
+						pLowLevelGraphics->AddIndexToBatch(lIdxAdd + i);
 
-				lIdxAdd += 4;
+					lIdxAdd += 4;
+				}
 
 				///////////////////////////
 				//Set last texture
@@ -50,6 +50,10 @@ namespace hpl {
 		mfWordWrapRowsHeight = 0.0f;
 		mbScrollingDown = true;
 
+		mbWordWrapRowsUpdated = false;
+		mfWordWrapRowsWidth = 0.0f;
+		mpWordWrapRowsFont = NULL;
+
 		mTextAlign = eFontAlign_Left;
 
 		mlMaxCharacters = -1;
@@ -128,30 +132,31 @@ namespace hpl {
 			int lChars =0;
 			bool bEnabled = IsEnabled();
 			float fHeight = mvDefaultFontSize.y+2;
-			tWStringVec vRows;
-			mpDefaultFontType->GetWordWrapRows(mvSize.x,fHeight,
-												mvDefaultFontSize, msText,
-												&vRows);
+			UpdateWordWrapRows(fHeight);
 
-			mfWordWrapRowsHeight = (fHeight-1) * (int)vRows.size();
+			mfWordWrapRowsHeight = (fHeight-1) * (int)mvWordWrapRows.size();
 
-			for(size_t i=0; i< vRows.size(); ++i)
+			for(size_t i=0; i< mvWordWrapRows.size(); ++i)
 			{
+				const tWString *pRow = &mvWordWrapRows[i];
+				tWString sCutRow;
+
 				bool bBreak = false;
 				if(mlMaxCharacters>=0)
 				{
-					if(lChars + (int)vRows[i].length() > mlMaxCharacters)
+					if(lChars + (int)pRow->length() > mlMaxCharacters)
 					{
-						vRows[i] = cString::SubW(vRows[i],0, mlMaxCharacters - lChars);
+						sCutRow = cString::SubW(*pRow,0, mlMaxCharacters - lChars);
+						pRow = &sCutRow;
 						bBreak = true;
 					}
-					lChars += (int)vRows[i].length();
+					lChars += (int)pRow->length();
 				}
 
 				if(bEnabled)
-					DrawDefaultText(vRows[i], GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),mTextAlign);
+					DrawDefaultText(*pRow, GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),mTextAlign);
 				else {
-					DrawDefaultText(vRows[i], GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),mTextAlign, cColor(0.5f, mDefaultFontColor.a));
+					DrawDefaultText(*pRow, GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),mTextAlign, cColor(0.5f, mDefaultFontColor.a));
 					//DrawSkinText(vRows[i],eGuiSkinFont_Disabled,GetGlobalPosition()+vOffset,mTextAlign);
 				}
 				vOffset.y += fHeight;
@@ -184,6 +189,31 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cWidgetLabel::UpdateWordWrapRows(float afRowHeight)
+	{
+		////////////////////////////////
+		// Only break the text into rows again if something it depends on has changed
+		if(	mbWordWrapRowsUpdated &&
+			mfWordWrapRowsWidth == mvSize.x &&
+			mvWordWrapRowsFontSize == mvDefaultFontSize &&
+			mpWordWrapRowsFont == mpDefaultFontType)
+		{
+			return;
+		}
+
+		mvWordWrapRows.clear();
+		mpDefaultFontType->GetWordWrapRows(mvSize.x,afRowHeight,
+											mvDefaultFontSize, msText,
+											&mvWordWrapRows);
+
+		mbWordWrapRowsUpdated = true;
+		mfWordWrapRowsWidth = mvSize.x;
+		mvWordWrapRowsFontSize = mvDefaultFontSize;
+		mpWordWrapRowsFont = mpDefaultFontType;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cWidgetLabel::OnLoadGraphics()
 	{
 		mpGfxBackground = mpSkin->GetGfx(eGuiSkinGfx_FrameBackground);
@@ -226,6 +256,8 @@ namespace hpl {
 
 	void cWidgetLabel::OnChangeText()
 	{
+		mbWordWrapRowsUpdated = false;
+
 		mfScrollTimer = mfWaitToScrollTime;
 		mfWordWrapOffset = 0;
 		mbScrollingDown = true;
@@ -42,6 +42,9 @@ namespace hpl {
 		mvSize = avSize;
 		mType = aType;
 
+		mbGeometryHashCalculated = false;
+		mlGeometryHash = 0;
+
 		mfVolume = 0;
 
 		float *pMtx = NULL;
@@ -422,6 +425,55 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	static unsigned int HashData(unsigned int alHash, const void *apData, size_t alSize)
+	{
+		//FNV-1a
+		const unsigned char *pData = (const unsigned char*)apData;
+		for(size_t i=0; i<alSize; ++i)
+		{
+			alHash ^= pData[i];
+			alHash *= 16777619u;
+		}
+		return alHash;
+	}
+
+	static void NewtonWriteToHash(void* apSerializeHandle, const void* apNewtonBuffer, int alSize)
+	{
+		unsigned int *pHash = (unsigned int*)apSerializeHandle;
+		*pHash = HashData(*pHash, apNewtonBuffer, (size_t)alSize);
+	}
+
+	unsigned int cCollideShapeNewton::GetGeometryHash()
+	{
+		//The shape never changes once created, so only calculate once.
+		if(mbGeometryHashCalculated) return mlGeometryHash;
+
+		unsigned int lHash = 2166136261u;
+		int lType = (int)mType;
+		lHash = HashData(lHash, &lType, sizeof(int));
+		lHash = HashData(lHash, mvSize.v, sizeof(float)*3);
+		lHash = HashData(lHash, m_mtxOffset.v, sizeof(float)*16);
+
+		//Meshes are hashed using the collision data, so it is the same if created from vertices or loaded from a cache.
+		if(mType == eCollideShapeType_Mesh && mpNewtonCollision)
+		{
+			NewtonCollisionSerialize(mpNewtonWorld, mpNewtonCollision, NewtonWriteToHash, (void*)&lHash);
+		}
+		
+		//Sub shapes include their offsets.
+		for(size_t i=0; i<mvSubShapes.size(); ++i)
+		{
+			unsigned int lSubHash = mvSubShapes[i]->GetGeometryHash();
+			lHash = HashData(lHash, &lSubHash, sizeof(unsigned int));
+		}
+
+		mlGeometryHash = lHash;
+		mbGeometryHashCalculated = true;
+		return mlGeometryHash;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHODS
 	//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl/FrameBufferNull.h"
+
+#include "graphics/Texture.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cDepthStencilBufferNull::cDepthStencilBufferNull(const cVector2l& avSize, int alDepthBits, int alStencilBits) 
+		: iDepthStencilBuffer(avSize, alDepthBits, alStencilBits)
+	{
+	}
+
+	cDepthStencilBufferNull::~cDepthStencilBufferNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	cFrameBufferNull::cFrameBufferNull(const tString& asName, iLowLevelGraphics* apLowLevelGraphics) : iFrameBuffer(asName, apLowLevelGraphics)
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	cFrameBufferNull::~cFrameBufferNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetTexture2D(int alColorIdx, iTexture *apTexture, int alMipmapLevel)
+	{
+		mpColorBuffer[alColorIdx] = apTexture;
+		if(apTexture) SetFirstSize(apTexture->GetSizeInt2D());
+	}
+
+	void cFrameBufferNull::SetTexture3D(int alColorIdx, iTexture *apTexture, int alZ, int alMipmapLevel)
+	{
+		SetTexture2D(alColorIdx, apTexture, alMipmapLevel);
+	}
+
+	void cFrameBufferNull::SetTextureCubeMap(int alColorIdx, iTexture *apTexture, int alFace, int alMipmapLevel)
+	{
+		SetTexture2D(alColorIdx, apTexture, alMipmapLevel);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetDepthTexture2D(iTexture *apTexture, int alMipmapLevel)
+	{
+		mpDepthBuffer = apTexture;
+		if(apTexture) SetFirstSize(apTexture->GetSizeInt2D());
+	}
+
+	void cFrameBufferNull::SetDepthTextureCubeMap(iTexture *apTexture, int alFace, int alMipmapLevel)
+	{
+		SetDepthTexture2D(apTexture, alMipmapLevel);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetDepthStencilBuffer(iDepthStencilBuffer* apBuffer)
+	{
+		mpDepthBuffer = apBuffer;
+		mpStencilBuffer = (apBuffer && apBuffer->GetStencilBits()>0) ? apBuffer : NULL;
+
+		if(apBuffer) SetFirstSize(apBuffer->GetSize());
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cFrameBufferNull::SetFirstSize(const cVector2l &avSize)
+	{
+		if(mvSize.x < 0) mvSize = avSize;
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl/GpuProgramNull.h"
+#include "impl/LowLevelGraphicsNull.h"
+
+#include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/String.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cGpuShaderNull::cGpuShaderNull(const tString& asName, eGpuShaderType aType, eGpuProgramFormat aProgramFormat) 
+		: iGpuShader(asName,_W(""),aType, aProgramFormat)
+	{
+	}
+
+	cGpuShaderNull::~cGpuShaderNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	cGpuProgramNull::cGpuProgramNull(const tString& asName, eGpuProgramFormat aProgramFormat, cLowLevelGraphicsNull* apLowLevelGraphics) 
+		: iGpuProgram(asName,aProgramFormat)
+	{
+		mpLowLevelGraphics = apLowLevelGraphics;
+	}
+
+	cGpuProgramNull::~cGpuProgramNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cGpuShaderNull::CreateFromFile(const tWString& asFile, const tString& asEntry, bool abPrintInfoIfFail)
+	{
+		//Still require the file so missing shaders are reported like with a real program
+		if(cPlatform::FileExists(asFile)==false)
+		{
+			if(abPrintInfoIfFail) Error("Could not find shader file '%s'\n", cString::To8Char(asFile).c_str());
+			return false;
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cGpuProgramNull::Bind()
+	{
+		mpLowLevelGraphics->AddProgramBind();
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cGpuProgramNull::GetVariableId(const tString& asName)
+	{
+		for(size_t i=0; i<mvVariableNames.size(); ++i)
+		{
+			if(mvVariableNames[i] == asName) return (int)i;
+		}
+		mvVariableNames.push_back(asName);
+		return (int)mvVariableNames.size()-1;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cGpuProgramNull::SetInt(int alVarId, int alX)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	bool cGpuProgramNull::SetFloat(int alVarId, float afX)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	bool cGpuProgramNull::SetVec2f(int alVarId, float afX,float afY)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	bool cGpuProgramNull::SetVec3f(int alVarId, float afX,float afY,float afZ)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	bool cGpuProgramNull::SetVec4f(int alVarId, float afX,float afY,float afZ, float afW)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	bool cGpuProgramNull::SetMatrixf(int alVarId, const cMatrixf& aMtx)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	bool cGpuProgramNull::SetMatrixf(int alVarId, eGpuShaderMatrix aType, eGpuShaderMatrixOp aOp)
+	{
+		mpLowLevelGraphics->AddProgramVariableSet();
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl/LowLevelGraphicsNull.h"
+
+#include "system/LowLevelSystem.h"
+
+#include "graphics/Bitmap.h"
+#include "graphics/Texture.h"
+
+#include "impl/SDLFontData.h"
+#include "impl/TextureNull.h"
+#include "impl/VertexBufferNull.h"
+#include "impl/FrameBufferNull.h"
+#include "impl/GpuProgramNull.h"
+#include "impl/OcclusionQueryNull.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// COUNTERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cNullGraphicsCounters::Reset()
+	{
+		mlDrawCalls =0;
+		mlDrawnTriangles =0;
+		mlStateChanges =0;
+		mlMatrixChanges =0;
+		mlTextureBinds =0;
+		mlProgramBinds =0;
+		mlProgramVariableSets =0;
+		mlVertexBufferBinds =0;
+		mlFrameBufferBinds =0;
+		mlFrameBufferClears =0;
+		mlOcclusionQueries =0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cNullGraphicsCounters::Add(const cNullGraphicsCounters& aCounters)
+	{
+		mlDrawCalls += aCounters.mlDrawCalls;
+		mlDrawnTriangles += aCounters.mlDrawnTriangles;
+		mlStateChanges += aCounters.mlStateChanges;
+		mlMatrixChanges += aCounters.mlMatrixChanges;
+		mlTextureBinds += aCounters.mlTextureBinds;
+		mlProgramBinds += aCounters.mlProgramBinds;
+		mlProgramVariableSets += aCounters.mlProgramVariableSets;
+		mlVertexBufferBinds += aCounters.mlVertexBufferBinds;
+		mlFrameBufferBinds += aCounters.mlFrameBufferBinds;
+		mlFrameBufferClears += aCounters.mlFrameBufferClears;
+		mlOcclusionQueries += aCounters.mlOcclusionQueries;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cLowLevelGraphicsNull::cLowLevelGraphicsNull()
+	{
+		mvScreenSize = cVector2l(800,600);
+		mGpuProgramFormat = eGpuProgramFormat_GLSL;
+		mfGammaCorrection = 1.0f;
+
+		mpFrameBuffer = NULL;
+		mvFrameBufferPos =0;
+		mvFrameBufferSize = mvScreenSize;
+
+		mlOcclusionQuerySampleCount = 1000;
+
+		mlBatchVertexCount =0;
+		mlBatchIndexCount =0;
+
+		mlFrameCount =0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cLowLevelGraphicsNull::~cLowLevelGraphicsNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// GENERAL SETUP
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cLowLevelGraphicsNull::Init(	int alWidth, int alHeight, int alDisplay, int alBpp, int abFullscreen,
+										int alMultisampling, eGpuProgramFormat aGpuProgramFormat,const tString& asWindowCaption,
+										const cVector2l &avWindowPos)
+	{
+		mvScreenSize.x = alWidth;
+		mvScreenSize.y = alHeight;
+		mGpuProgramFormat = aGpuProgramFormat;
+
+		mvFrameBufferSize = mvScreenSize;
+
+		Log(" Using null graphics, nothing will be drawn.\n");
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cLowLevelGraphicsNull::GetCaps(eGraphicCaps aType)
+	{
+		//Report a fairly capable card so the renderer takes its normal paths.
+		switch(aType)
+		{
+		case eGraphicCaps_MaxTextureImageUnits:		return kMaxTextureUnits;
+		case eGraphicCaps_MaxTextureCoordUnits:		return kMaxTextureUnits;
+		case eGraphicCaps_MaxUserClipPlanes:		return kMaxClipPlanes;
+		case eGraphicCaps_MaxAnisotropicFiltering:	return 16;
+		case eGraphicCaps_MaxDrawBuffers:			return kMaxDrawColorBuffers;
+		case eGraphicCaps_MaxColorRenderTargets:	return kMaxDrawColorBuffers;
+		case eGraphicCaps_OGL_ATIFragmentShader:	return 0;
+		case eGraphicCaps_ShaderModel_4:			return 0;
+		default:									return 1;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	cVector2f cLowLevelGraphicsNull::GetScreenSizeFloat()
+	{
+		return cVector2f((float)mvScreenSize.x, (float)mvScreenSize.y);
+	}
+
+	const cVector2l& cLowLevelGraphicsNull::GetScreenSizeInt()
+	{
+		return mvScreenSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// DATA CREATION
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	iFontData* cLowLevelGraphicsNull::CreateFontData(const tString &asName)
+	{
+		return hplNew( cSDLFontData, (asName, this) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iGpuProgram* cLowLevelGraphicsNull::CreateGpuProgram(const tString& asName)
+	{
+		return hplNew( cGpuProgramNull, (asName, mGpuProgramFormat, this) );
+	}
+
+	iGpuShader* cLowLevelGraphicsNull::CreateGpuShader(const tString& asName, eGpuShaderType aType)
+	{
+		return hplNew( cGpuShaderNull, (asName,aType, mGpuProgramFormat) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iTexture* cLowLevelGraphicsNull::CreateTexture(const tString &asName,eTextureType aType, eTextureUsage aUsage)
+	{
+		return hplNew( cTextureNull, (asName,aType, aUsage, this) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iVertexBuffer* cLowLevelGraphicsNull::CreateVertexBuffer(	eVertexBufferType aType,
+																eVertexBufferDrawType aDrawType,
+																eVertexBufferUsageType aUsageType, 
+																int alReserveVtxSize,int alReserveIdxSize)
+	{
+		return hplNew( cVertexBufferNull, (this, aType, aDrawType,aUsageType,alReserveVtxSize,alReserveIdxSize) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	iFrameBuffer* cLowLevelGraphicsNull::CreateFrameBuffer(const tString& asName)
+	{
+		return hplNew(cFrameBufferNull,(asName, this));
+	}
+
+	//-----------------------------------------------------------------------
+
+	iDepthStencilBuffer* cLowLevelGraphicsNull::CreateDepthStencilBuffer(const cVector2l& avSize, int alDepthBits, int alStencilBits)
+	{
+		return hplNew(cDepthStencilBufferNull,(avSize, alDepthBits,alStencilBits));
+	}
+
+	//-----------------------------------------------------------------------
+
+	iOcclusionQuery* cLowLevelGraphicsNull::CreateOcclusionQuery()
+	{
+		return hplNew(cOcclusionQueryNull, (this) );
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// FRAME BUFFER OPERATIONS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::ClearFrameBuffer(tClearFrameBufferFlag aFlags)
+	{
+		++mFrameCounters.mlFrameBufferClears;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cBitmap* cLowLevelGraphicsNull::CopyFrameBufferToBitmap(const cVector2l &avScreenPos,const cVector2l &avScreenSize)
+	{
+		cVector2l vSize = avScreenSize;
+		if(vSize.x <= 0) vSize.x = mvFrameBufferSize.x;
+		if(vSize.y <= 0) vSize.y = mvFrameBufferSize.y;
+
+		cBitmap *pBitmap = hplNew(cBitmap, () );
+		pBitmap->CreateData(cVector3l(vSize.x, vSize.y,1),ePixelFormat_RGBA,0,0);
+		pBitmap->Clear(cColor(0,0),0,0);
+
+		return pBitmap;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::SwapBuffers()
+	{
+		mTotalCounters.Add(mFrameCounters);
+		mLastFrameCounters = mFrameCounters;
+		mFrameCounters.Reset();
+
+		++mlFrameCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::SetCurrentFrameBuffer(iFrameBuffer* apFrameBuffer, const cVector2l &avPos, const cVector2l& avSize)
+	{
+		++mFrameCounters.mlFrameBufferBinds;
+
+		mpFrameBuffer = apFrameBuffer;
+		mvFrameBufferPos = avPos;
+
+		cVector2l vTotalSize = apFrameBuffer ? apFrameBuffer->GetSize() : mvScreenSize;
+		mvFrameBufferSize.x = avSize.x < 0 ? vTotalSize.x : avSize.x;
+		mvFrameBufferSize.y = avSize.y < 0 ? vTotalSize.y : avSize.y;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// RENDER STATE
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::SetClipPlane(int alIdx, const cPlanef& aPlane)
+	{
+		AddStateChange();
+		mvClipPlanes[alIdx] = aPlane;
+	}
+
+	cPlanef cLowLevelGraphicsNull::GetClipPlane(int alIdx)
+	{
+		return mvClipPlanes[alIdx];
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// VERTEX BATCHING
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::FlushTriBatch(tVtxBatchFlag aTypeFlags, bool abAutoClear)
+	{
+		AddDrawCall(mlBatchIndexCount / 3);
+
+		if(abAutoClear) ClearBatch();
+	}
+
+	void cLowLevelGraphicsNull::FlushQuadBatch(tVtxBatchFlag aTypeFlags, bool abAutoClear)
+	{
+		AddDrawCall((mlBatchIndexCount / 4) * 2);
+
+		if(abAutoClear) ClearBatch();
+	}
+
+	void cLowLevelGraphicsNull::ClearBatch()
+	{
+		mlBatchVertexCount =0;
+		mlBatchIndexCount =0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// IMPLEMENTION SPECIFICS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cLowLevelGraphicsNull::ResetCounters()
+	{
+		mFrameCounters.Reset();
+		mLastFrameCounters.Reset();
+		mTotalCounters.Reset();
+		mlFrameCount =0;
+	}
+
+	//-----------------------------------------------------------------------
+}
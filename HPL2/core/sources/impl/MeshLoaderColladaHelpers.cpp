@@ -41,6 +41,36 @@
 namespace hpl {
 
 #define GetAdress(sStr) if(sStr.length()>0 && sStr[0]=='#') sStr = cString::Sub(sStr,1);
+
+	//////////////////////////////////////////////////////////////////////////
+	// VALUE PARSING
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	//Appends all values in the text to the vector, parsed in place without any temporary strings.
+	static void AppendFloatValues(const char* apText, tFloatVec& avValues)
+	{
+		int lCount = cString::GetValueCount(apText);
+		if(lCount<=0) return;
+
+		size_t lStart = avValues.size();
+		avValues.resize(lStart + lCount);
+		cString::ParseFloatArray(&avValues[lStart], lCount, apText);
+	}
+
+	static void AppendIntValues(const char* apText, tIntVec& avValues)
+	{
+		int lCount = cString::GetValueCount(apText);
+		if(lCount<=0) return;
+
+		size_t lStart = avValues.size();
+		avValues.resize(lStart + lCount);
+		cString::ParseIntArray(&avValues[lStart], lCount, apText);
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHODS
 	//////////////////////////////////////////////////////////////////////////
@@ -931,7 +961,7 @@ namespace hpl {
 				if(lCount>0)	
 				{
 					TiXmlText *pText = pArrayElem->FirstChild()->ToText();
-					cString::GetFloatVec(pText->Value(),Source.mvValues);
+					AppendFloatValues(pText->Value(),Source.mvValues);
 				}
 			}
 		}
@@ -1296,7 +1326,7 @@ namespace hpl {
 					//Convert text to floats
 					tFloatVec vValVec;
 					vValVec.reserve(lCount);
-					cString::GetFloatVec(pText->Value(), vValVec);
+					AppendFloatValues(pText->Value(), vValVec);
 					
 					//Weights
 					if(sId == sJointWeightSource)
@@ -1335,7 +1365,7 @@ namespace hpl {
 				if(pVCountText==NULL){ Error("No value data found!\n"); continue;}
 
                 tIntVec vVCount;
-				cString::GetIntVec(pVCountText->Value(),vVCount);
+				AppendIntValues(pVCountText->Value(),vVCount);
 
 				/////////////////////////////
 				//V - Get the pairs
@@ -1347,7 +1377,7 @@ namespace hpl {
 				if(pVText==NULL){ Error("No value data found!\n"); continue;}
 
 				tIntVec vV;
-				cString::GetIntVec(pVText->Value(),vV);
+				AppendIntValues(pVText->Value(),vV);
 				
 				int lVtx=0;
 				int lNumOfPairs = ((int)vV.size())/2;
@@ -1704,7 +1734,7 @@ namespace hpl {
 
 				//Get the indices for the triangle
 				tIntVec vIndexArray;
-				cString::GetIntVec(pText->Value(),vIndexArray);
+				AppendIntValues(pText->Value(),vIndexArray);
 
 				int lTriangleNum = (int)vIndexArray.size()/ (3*lTriElements);
                 for(int triangle=0; triangle< lTriangleNum; triangle++)
@@ -2146,6 +2176,71 @@ namespace hpl {
 	}
 
 
+	/**
+	 * Open addressing hash from a position/normal/texture index combination to the vertex created for it.
+	 */
+	class cColladaVtxIndexHash
+	{
+	public:
+		cColladaVtxIndexHash(size_t alMaxEntries)
+		{
+			size_t lSize = 16;
+			while(lSize < alMaxEntries*2) lSize *= 2;
+
+			mvEntries.resize(lSize);
+			mlMask = lSize-1;
+		}
+
+		/**
+		 * Returns the vertex for the combination, set it if it is < 0 (a new combination).
+		 */
+		int& GetNewVtx(const cColladaVtxIndex &aData)
+		{
+			unsigned int lHash =	(unsigned int)aData.mlVtx * 73856093u ^ 
+									(unsigned int)aData.mlNorm * 19349663u ^ 
+									(unsigned int)aData.mlTex * 83492791u;
+			size_t lIdx = (lHash * 2654435761u) & mlMask;
+
+			while(true)
+			{
+				cEntry &entry = mvEntries[lIdx];
+				if(entry.mbUsed==false)
+				{
+					entry.mbUsed = true;
+					entry.mlVtx = aData.mlVtx;
+					entry.mlNorm = aData.mlNorm;
+					entry.mlTex = aData.mlTex;
+					entry.mlNewVtx = -1;
+					return entry.mlNewVtx;
+				}
+				if(entry.mlVtx == aData.mlVtx && entry.mlNorm == aData.mlNorm && entry.mlTex == aData.mlTex)
+				{
+					return entry.mlNewVtx;
+				}
+
+				lIdx = (lIdx+1) & mlMask;
+			}
+		}
+
+	private:
+		class cEntry
+		{
+		public:
+			cEntry() : mbUsed(false){}
+
+			int mlVtx;
+			int mlNorm;
+			int mlTex;
+			int mlNewVtx;
+			bool mbUsed;
+		};
+
+		std::vector<cEntry> mvEntries;
+		size_t mlMask;
+	};
+
+	//-----------------------------------------------------------------------
+
 	void cMeshLoaderCollada::SplitVertices(cColladaGeometry &aGeometry,tColladaExtraVtxListVec &avExtraVtxVec, 
 		tVertexVec &avVertexVec, tUIntVec &avIndexVec)
 	{
@@ -2157,52 +2252,38 @@ namespace hpl {
 
 		tColladaVtxIndexVec &vIndices = aGeometry.mvIndices;
 
+		//There can never be more combinations than indices
+		cColladaVtxIndexHash indexHash(vIndices.size());
+
 		for(int i=0; i<(int) vIndices.size(); i++)
 		{
 			cColladaVtxIndex &Data = vIndices[i];
-			//Log("Index %d: ", i);
+
+			//If the combination has been added before, use that vertex.
+			int &lNewVtx = indexHash.GetNewVtx(Data);
+			if(lNewVtx >= 0)
+			{
+				avIndexVec[i] = lNewVtx;
+				continue;
+			}
 
 			//If the vertex extra is empty this is the first of
 			//this vertex added, so no need to split.
 			if(avExtraVtxVec[Data.mlVtx].empty())
 			{
-				avExtraVtxVec[Data.mlVtx].push_back(IndexDataToExtra(Data, Data.mlVtx));
-
+				lNewVtx = Data.mlVtx;
 				avVertexVec[Data.mlVtx] = IndexDataToVertex(Data,aGeometry);
-				avIndexVec[i] = Data.mlVtx;
-				//Log("New vertex added");
 			}
-			//There is already a vertex added at this position, check if this exist
-			//else create a new.
+			//There is already a vertex added at this position, the new one is put at the end.
 			else
 			{
-				bool bFound = false;
-				tColladaExtraVtxListIt it = avExtraVtxVec[Data.mlVtx].begin();
-				for(; it != avExtraVtxVec[Data.mlVtx].end(); ++it)
-				{
-					//If the split has already been made for this combo just set the vertex position.
-					if(it->Equals(Data))
-					{
-						avIndexVec[i] = it->mlNewVtx;
-						bFound = true;
-						//Log("Old vertex split used");
-						break;
-					}
-				}
-
-				//If no split was found create a new
-				if(bFound == false)
-				{
-					//The new vertex will be put at the end.
-					avExtraVtxVec[Data.mlVtx].push_back(IndexDataToExtra(Data, (int)avVertexVec.size()));
-					avIndexVec[i] = (int)avVertexVec.size();
-
-					avVertexVec.push_back(IndexDataToVertex(Data,aGeometry));
-					//Log("New split made");
-				}
+				lNewVtx = (int)avVertexVec.size();
+				avVertexVec.push_back(IndexDataToVertex(Data,aGeometry));
 			}
 
-			//Log("\n");
+			//The extra list is still needed to know all the vertices made from a position (for skinning).
+			avExtraVtxVec[Data.mlVtx].push_back(IndexDataToExtra(Data, lNewVtx));
+			avIndexVec[i] = lNewVtx;
 		}
 	}
 
@@ -2224,31 +2305,31 @@ namespace hpl {
 	{
 		if((int)avVtxVec.size() < alVtxCount) avVtxVec.resize(alVtxCount);
 
-		//This is a bit slower but shouldn't matter since we have cache files.
-		//Also, the biggie is probably string -> float, which is no different really. Just some extra copying to arrays happen.
-		//Plus side is that it is a lot safer!
-		tFloatVec vFloatData;
-		cString::GetFloatVec(apChars, vFloatData);
-		
-		int lLoadedVtxNum = (int)vFloatData.size() / alElements;
-		if(lLoadedVtxNum != alVtxCount)
+		//Values are parsed straight into the vectors, elements above the third are skipped.
+		const char *pChars = apChars;
+		int lLoadedVtxNum = 0;
+		for(; lLoadedVtxNum<alVtxCount; ++lLoadedVtxNum)
 		{
-			Warning("Vertex array in does not have correct number of values stored. %d instead of %d\n", vFloatData.size(), alElements * alVtxCount);
+			float vValues[3];
+			int lParsed = 0;
+			for(int i=0; i<alElements; ++i)
+			{
+				float fValue;
+				if(cString::ParseFloatArray(&fValue, 1, pChars, &pChars)==0) break;
+				
+				if(i<3) vValues[i] = fValue;
+				++lParsed;
+			}
+			if(lParsed < alElements) break;
+
+			cVector3f &vVtx = avVtxVec[lLoadedVtxNum];
+			for(int i=0; i<alElements && i<3; ++i) vVtx.v[i] = vValues[i];
 		}
 		
-		for(int i=0; i<alVtxCount; ++i)
+		if(lLoadedVtxNum != alVtxCount || cString::GetValueCount(pChars) > 0)
 		{
-			if(i>=lLoadedVtxNum) break;
-
-			float* fData = &vFloatData[i*alElements];
-
-			avVtxVec[i].x = fData[0];
-			if(alElements > 1)
-			{
-				avVtxVec[i].y = fData[1];
-				if(alElements > 2)
-					avVtxVec[i].z = fData[2];
-			}
+			Warning("Vertex array in does not have correct number of values stored. %d instead of %d\n", 
+					lLoadedVtxNum*alElements + cString::GetValueCount(pChars), alElements * alVtxCount);
 		}
 
 		/*
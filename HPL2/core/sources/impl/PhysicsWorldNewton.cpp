@@ -74,9 +74,16 @@ namespace hpl {
 		m_mapMaterials.insert(Val);
 		pMaterial->UpdateMaterials();
 
-		mpTempDepths = hplNewArray( float,500);
-		mpTempNormals = hplNewArray( float,500 * 3);
-		mpTempPoints = hplNewArray( float,500 * 3);
+		/////////////////////////////////
+		//Create temp buffers, one set per thread that can do collision queries.
+		int lQueryThreads = cMath::Max(NewtonGetMaxThreadsCount(mpNewtonWorld), 1);
+		mvTempBuffers.resize(lQueryThreads);
+		for(size_t i=0; i<mvTempBuffers.size(); ++i)
+		{
+			mvTempBuffers[i].mpDepths = hplNewArray( float,500);
+			mvTempBuffers[i].mpNormals = hplNewArray( float,500 * 3);
+			mvTempBuffers[i].mpPoints = hplNewArray( float,500 * 3);
+		}
 	}
 
 	//-----------------------------------------------------------------------
@@ -86,9 +93,12 @@ namespace hpl {
 		DestroyAll();
 		NewtonDestroy(mpNewtonWorld);
 
-		hplDeleteArray(mpTempDepths);
-		hplDeleteArray(mpTempNormals);
-		hplDeleteArray(mpTempPoints);
+		for(size_t i=0; i<mvTempBuffers.size(); ++i)
+		{
+			hplDeleteArray(mvTempBuffers[i].mpDepths);
+			hplDeleteArray(mvTempBuffers[i].mpNormals);
+			hplDeleteArray(mvTempBuffers[i].mpPoints);
+		}
 	}
 
 	//-----------------------------------------------------------------------
@@ -212,6 +222,13 @@ namespace hpl {
 	{
 		return NewtonGetThreadsCount(mpNewtonWorld);
 	}
+
+	//-----------------------------------------------------------------------
+
+	int cPhysicsWorldNewton::GetMaxQueryThreads()
+	{
+		return (int)mvTempBuffers.size();
+	}
 	
 	//-----------------------------------------------------------------------
 	
@@ -386,19 +403,17 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	static std::vector<iPhysicsBody*> *gpBodyVec;
 	static void AddNewtonBodyToVector(const NewtonBody* apNewtonBody, void* userData)
 	{
+		std::vector<iPhysicsBody*> *pBodyVec = static_cast<std::vector<iPhysicsBody*>*>(userData);
 		cPhysicsBodyNewton* pBody = (cPhysicsBodyNewton*) NewtonBodyGetUserData(apNewtonBody);
-		gpBodyVec->push_back(pBody);
+		pBodyVec->push_back(pBody);
 	}
 
 	void cPhysicsWorldNewton::GetBodiesInBV(cBoundingVolume *apBV, std::vector<iPhysicsBody*> *apBodyVec)
 	{
-		gpBodyVec = apBodyVec;
-
-		//NewtonWorldForEachBodyInAABBDo(mpNewtonWorld,apBV->GetMin().v, apBV->GetMax().v,AddNewtonBodyToVector, NULL);
-		NewtonWorldForEachBodyInAABBDo(mpNewtonWorld,apBV->GetMin().v, apBV->GetMax().v,AddNewtonBodyToVector, NULL);
+		//The vector is sent as user data (instead of a global) so that several threads can query at the same time.
+		NewtonWorldForEachBodyInAABBDo(mpNewtonWorld,apBV->GetMin().v, apBV->GetMax().v,AddNewtonBodyToVector, apBodyVec);
 	}
 	
 	//-----------------------------------------------------------------------
@@ -450,35 +465,41 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	static bool gbRayCalcDist;
-	static bool gbRayCalcNormal;
-	static bool gbRayCalcPoint;
-	static iPhysicsRayCallback *gpRayCallback;
-	static cVector3f gvRayOrigin;
-	static cVector3f gvRayEnd;
-	static cVector3f gvRayDelta;
-	static float gfRayLength;
-	//Temp:
-	static cVector3f gvRayBoxMin; 
-	static cVector3f gvRayBoxMax;
-	
-	static cPhysicsRayParams gRayParams;
+	class cNewtonRayData
+	{
+	public:
+		bool mbCalcDist;
+		bool mbCalcNormal;
+		bool mbCalcPoint;
+		iPhysicsRayCallback *mpCallback;
+		cVector3f mvOrigin;
+		cVector3f mvEnd;
+		cVector3f mvDelta;
+		float mfLength;
+		//Temp:
+		cVector3f mvBoxMin; 
+		cVector3f mvBoxMax;
+		
+		cPhysicsRayParams mParams;
+	};
 
 	//////////////////////////////////////
 	
 	static unsigned RayCastPrefilterFunc (const NewtonBody* apNewtonBody,const NewtonCollision* collision, void* userData)
 	{
+		cNewtonRayData *pRay = static_cast<cNewtonRayData*>(userData);
+
 		cPhysicsBodyNewton* pRigidBody = (cPhysicsBodyNewton*) NewtonBodyGetUserData(apNewtonBody);
 		if(pRigidBody->IsActive()==false) return 0;
 
 		//Temp:
 		cBoundingVolume *pBv = pRigidBody->GetBoundingVolume();
-		if(cMath::CheckAABBIntersection(gvRayBoxMin, gvRayBoxMax, pBv->GetMin(), pBv->GetMax())==false)
+		if(cMath::CheckAABBIntersection(pRay->mvBoxMin, pRay->mvBoxMax, pBv->GetMin(), pBv->GetMax())==false)
 		{
 			return 0;
 		}
 
-		bool bRet = gpRayCallback->BeforeIntersect(pRigidBody);
+		bool bRet = pRay->mpCallback->BeforeIntersect(pRigidBody);
 
 		if(bRet) return 1;
 		else return 0;
@@ -487,24 +508,26 @@ namespace hpl {
 	static float RayCastFilterFunc (const NewtonBody* apNewtonBody, const float* apNormalVec, 
 								int alCollisionID, void* apUserData, float afIntersetParam)
 	{
+		cNewtonRayData *pRay = static_cast<cNewtonRayData*>(apUserData);
+
 		cPhysicsBodyNewton* pRigidBody = (cPhysicsBodyNewton*) NewtonBodyGetUserData(apNewtonBody);
 		if(pRigidBody->IsActive()==false) return 1;
 
-		gRayParams.mfT = afIntersetParam;
+		pRay->mParams.mfT = afIntersetParam;
 		
 		//Calculate stuff needed.
-		if(gbRayCalcDist){
-			gRayParams.mfDist = gfRayLength * afIntersetParam;
+		if(pRay->mbCalcDist){
+			pRay->mParams.mfDist = pRay->mfLength * afIntersetParam;
 		}
-		if(gbRayCalcNormal){
-			gRayParams.mvNormal.FromVec(apNormalVec);
+		if(pRay->mbCalcNormal){
+			pRay->mParams.mvNormal.FromVec(apNormalVec);
 		}
-		if(gbRayCalcPoint){
-			gRayParams.mvPoint = gvRayOrigin + gvRayDelta * afIntersetParam;
+		if(pRay->mbCalcPoint){
+			pRay->mParams.mvPoint = pRay->mvOrigin + pRay->mvDelta * afIntersetParam;
 		}
 		
 		//Call the call back
-		bool bRet = gpRayCallback->OnIntersect(pRigidBody,&gRayParams);
+		bool bRet = pRay->mpCallback->OnIntersect(pRigidBody,&pRay->mParams);
 		
 		//return correct value.
 		if(bRet) return 1;//afIntersetParam;
@@ -518,37 +541,62 @@ namespace hpl {
 								bool abCalcDist, bool abCalcNormal,bool abCalcPoint,
 								bool abUsePrefilter)
 	{
-		gbRayCalcPoint = abCalcPoint;
-		gbRayCalcNormal = abCalcNormal;
-		gbRayCalcDist = abCalcDist;
+		//All ray data is kept on the stack and sent as user data, so rays can be cast from several threads.
+		cNewtonRayData rayData;
+
+		rayData.mbCalcPoint = abCalcPoint;
+		rayData.mbCalcNormal = abCalcNormal;
+		rayData.mbCalcDist = abCalcDist;
 
-		gvRayOrigin = avOrigin;
-		gvRayEnd = avEnd;
+		rayData.mvOrigin = avOrigin;
+		rayData.mvEnd = avEnd;
 
-		gvRayDelta = avEnd - avOrigin;
-		gfRayLength = gvRayDelta.Length();
+		rayData.mvDelta = avEnd - avOrigin;
+		rayData.mfLength = rayData.mvDelta.Length();
 
-        gpRayCallback = apCallback;
+        rayData.mpCallback = apCallback;
 
 		////////////
 		//Temp:
 		for(int i=0; i<3; ++i)
 		{
-			if(gvRayOrigin.v[i] > gvRayEnd.v[i]){
-				gvRayBoxMin.v[i] = gvRayEnd.v[i];
-				gvRayBoxMax.v[i] = gvRayOrigin.v[i];
+			if(rayData.mvOrigin.v[i] > rayData.mvEnd.v[i]){
+				rayData.mvBoxMin.v[i] = rayData.mvEnd.v[i];
+				rayData.mvBoxMax.v[i] = rayData.mvOrigin.v[i];
 			}
 			else {
-				gvRayBoxMin.v[i] = gvRayOrigin.v[i];
-				gvRayBoxMax.v[i] = gvRayEnd.v[i];
+				rayData.mvBoxMin.v[i] = rayData.mvOrigin.v[i];
+				rayData.mvBoxMax.v[i] = rayData.mvEnd.v[i];
 			}
 		}
 
 		
 		if(abUsePrefilter)
-			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, NULL, RayCastPrefilterFunc);
+			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, &rayData, RayCastPrefilterFunc);
 		else
-			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, NULL, NULL);
+			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, &rayData, NULL);
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cPhysicsWorldNewton::CheckRayBodyIntersection(	iPhysicsBody *apBody, const cVector3f &avOrigin, const cVector3f& avEnd, 
+														float *apT)
+	{
+		cCollideShapeNewton *pShape = static_cast<cCollideShapeNewton*>(apBody->GetShape());
+		if(pShape==NULL || pShape->GetNewtonCollision()==NULL) return false;
+
+		//Newton wants the ray in the local space of the body
+		cMatrixf mtxInvBody = cMath::MatrixInverse(apBody->GetLocalMatrix());
+		cVector3f vLocalOrigin = cMath::MatrixMul(mtxInvBody, avOrigin);
+		cVector3f vLocalEnd = cMath::MatrixMul(mtxInvBody, avEnd);
+
+		float vNormal[3];
+		int lAttribute=0;
+		float fT = NewtonCollisionRayCast(pShape->GetNewtonCollision(), vLocalOrigin.v, vLocalEnd.v, vNormal, &lAttribute);
+		if(fT < 0 || fT > 1) return false;
+
+		if(apT) *apT = fT;
+		return true;
 	}
 	
 	//-----------------------------------------------------------------------
@@ -566,8 +614,14 @@ namespace hpl {
 	bool cPhysicsWorldNewton::CheckShapeCollision(	iCollideShape* apShapeA, const cMatrixf& a_mtxA,
 										iCollideShape* apShapeB, const cMatrixf& a_mtxB,
 										cCollideData & aCollideData, int alMaxPoints,
-										bool abCorrectNormalDirection)
+										bool abCorrectNormalDirection, int alThreadIndex)
 	{
+		//Each thread has its own temp buffers, Newton is also given the index so it uses its per thread data.
+		if(alThreadIndex <0 || alThreadIndex >= (int)mvTempBuffers.size()) alThreadIndex =0;
+		float *pTempPoints = mvTempBuffers[alThreadIndex].mpPoints;
+		float *pTempNormals = mvTempBuffers[alThreadIndex].mpNormals;
+		float *pTempDepths = mvTempBuffers[alThreadIndex].mpDepths;
+
 		cCollideShapeNewton *pNewtonShapeA = static_cast<cCollideShapeNewton*>(apShapeA);
 		cCollideShapeNewton *pNewtonShapeB = static_cast<cCollideShapeNewton*>(apShapeB);
 
@@ -599,7 +653,7 @@ namespace hpl {
 					int lNum = NewtonCollisionCollide(mpNewtonWorld, alMaxPoints,
 												pSubShapeA->GetNewtonCollision(), &(mtxTransposeA.m[0][0]),
 												pSubShapeB->GetNewtonCollision(), &(mtxTransposeB.m[0][0]),
-												mpTempPoints, mpTempNormals, mpTempDepths, 0);
+												pTempPoints, pTempNormals, pTempDepths, alThreadIndex);
 					if(lNum<1) continue;
 					if(lNum > alMaxPoints )lNum = alMaxPoints;
 
@@ -613,17 +667,17 @@ namespace hpl {
 					for(int i=0; i<lNum; i++)
 					{
 						cCollidePoint &CollPoint = aCollideData.mvContactPoints[lCollideDataStart + i];
-						CollPoint.mfDepth =  mpTempDepths[i];
+						CollPoint.mfDepth =  pTempDepths[i];
 
 						int lVertex = i*3;
 
-						CollPoint.mvNormal.x = mpTempNormals[lVertex+0];
-						CollPoint.mvNormal.y = mpTempNormals[lVertex+1];
-						CollPoint.mvNormal.z = mpTempNormals[lVertex+2];
+						CollPoint.mvNormal.x = pTempNormals[lVertex+0];
+						CollPoint.mvNormal.y = pTempNormals[lVertex+1];
+						CollPoint.mvNormal.z = pTempNormals[lVertex+2];
 
-						CollPoint.mvPoint.x = mpTempPoints[lVertex+0];
-						CollPoint.mvPoint.y = mpTempPoints[lVertex+1];
-						CollPoint.mvPoint.z = mpTempPoints[lVertex+2];
+						CollPoint.mvPoint.x = pTempPoints[lVertex+0];
+						CollPoint.mvPoint.y = pTempPoints[lVertex+1];
+						CollPoint.mvPoint.z = pTempPoints[lVertex+2];
 						
 						/////////
 						//Correct the normal
@@ -649,7 +703,7 @@ namespace hpl {
 			int lNum = NewtonCollisionCollide(mpNewtonWorld, alMaxPoints,
 										pNewtonShapeA->GetNewtonCollision(), &(mtxTransposeA.m[0][0]),
 										pNewtonShapeB->GetNewtonCollision(), &(mtxTransposeB.m[0][0]),
-										mpTempPoints, mpTempNormals, mpTempDepths, 0);
+										pTempPoints, pTempNormals, pTempDepths, alThreadIndex);
 			
 			if(lNum<1) return false;
 			if(lNum > alMaxPoints )lNum = alMaxPoints;
@@ -658,17 +712,17 @@ namespace hpl {
 			for(int i=0; i<lNum; i++)
 			{
 				cCollidePoint &CollPoint = aCollideData.mvContactPoints[i];
-				CollPoint.mfDepth =  mpTempDepths[i];
+				CollPoint.mfDepth =  pTempDepths[i];
 				
 				int lVertex = i*3;
 
-				CollPoint.mvNormal.x = mpTempNormals[lVertex+0];
-				CollPoint.mvNormal.y = mpTempNormals[lVertex+1];
-				CollPoint.mvNormal.z = mpTempNormals[lVertex+2];
+				CollPoint.mvNormal.x = pTempNormals[lVertex+0];
+				CollPoint.mvNormal.y = pTempNormals[lVertex+1];
+				CollPoint.mvNormal.z = pTempNormals[lVertex+2];
 
-				CollPoint.mvPoint.x = mpTempPoints[lVertex+0];
-				CollPoint.mvPoint.y = mpTempPoints[lVertex+1];
-				CollPoint.mvPoint.z = mpTempPoints[lVertex+2];
+				CollPoint.mvPoint.x = pTempPoints[lVertex+0];
+				CollPoint.mvPoint.y = pTempPoints[lVertex+1];
+				CollPoint.mvPoint.z = pTempPoints[lVertex+2];
 
 				/////////
 				//Correct the normal
@@ -32,6 +32,7 @@
 #include "impl/TimerSDL.h"
 #include "impl/ThreadSDL.h"
 #include "impl/MutexSDL.h"
+#include "impl/SemaphoreSDL.h"
 
 #include <set>
 #include <algorithm>
@@ -177,5 +178,24 @@ namespace hpl {
 	{
 		return hplNew(cMutexSDL, ());
 	}
+
+	//-----------------------------------------------------------------------
+
+	iSemaphore* cPlatform::CreateSemaPhore(unsigned int alInitialCount)
+	{
+		return hplNew(cSemaphoreSDL, (alInitialCount));
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cPlatform::GetNumberOfCores()
+	{
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		int lCores = SDL_GetCPUCount();
+		return lCores > 0 ? lCores : 1;
+#else
+		return 1;
+#endif
+	}
 #endif
 }
@@ -46,6 +46,7 @@
 #include "impl/TimerSDL.h"
 #include "impl/ThreadWin32.h"
 #include "impl/MutexWin32.h"
+#include "impl/SemaphoreWin32.h"
 
 #include <algorithm>
 
@@ -706,6 +707,22 @@ namespace hpl {
 		return hplNew(cMutexWin32, ());
 	}
 
+	//-----------------------------------------------------------------------
+
+	iSemaphore* cPlatform::CreateSemaPhore(unsigned int alInitialCount)
+	{
+		return hplNew(cSemaphoreWin32, (alInitialCount));
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cPlatform::GetNumberOfCores()
+	{
+		SYSTEM_INFO sysInfo;
+		GetSystemInfo(&sysInfo);
+		return sysInfo.dwNumberOfProcessors > 0 ? (int)sysInfo.dwNumberOfProcessors : 1;
+	}
+
 
 	//-----------------------------------------------------------------------
 
@@ -32,6 +32,7 @@
 #include "impl/KeyboardSDL.h"
 #include "impl/MouseSDL.h"
 #include "impl/LowLevelGraphicsSDL.h"
+#include "impl/LowLevelGraphicsNull.h"
 #include "impl/LowLevelResourcesSDL.h"
 #include "impl/LowLevelSystemSDL.h"
 #include "impl/LowLevelInputSDL.h"
@@ -63,8 +64,11 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	cSDLEngineSetup::cSDLEngineSetup(tFlag alHplSetupFlags)
+	cSDLEngineSetup::cSDLEngineSetup(tFlag alHplSetupFlags, eHplAPI aApi)
 	{
+		//The null graphics never opens a window
+		if(aApi == eHplAPI_Null) alHplSetupFlags &= ~(eHplSetup_Screen | eHplSetup_Video);
+
 #if SDL_VERSION_ATLEAST(2,0,0)
 		SDL_SetHint(SDL_HINT_VIDEO_MAC_FULLSCREEN_SPACES, "0");
 #endif
@@ -115,7 +119,10 @@ namespace hpl {
 		
 		//////////////////////////
 		// Graphics
-		mpLowLevelGraphics = hplNew( cLowLevelGraphicsSDL,() );
+		if(aApi == eHplAPI_Null)
+			mpLowLevelGraphics = hplNew( cLowLevelGraphicsNull,() );
+		else
+			mpLowLevelGraphics = hplNew( cLowLevelGraphicsSDL,() );
 		
 		//////////////////////////
 		// Input
@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl/SemaphoreWin32.h"
+
+#include <limits.h>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+	
+	cSemaphoreWin32::cSemaphoreWin32(unsigned int alInitialCount)
+	{
+		mpSemaphoreHandle = NULL;
+		mpSemaphoreHandle = CreateSemaphore(NULL, (LONG)alInitialCount, LONG_MAX, NULL);
+	}
+
+	//-----------------------------------------------------------------------
+
+	cSemaphoreWin32::~cSemaphoreWin32()
+	{
+		if(mpSemaphoreHandle)
+			CloseHandle(mpSemaphoreHandle);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+	
+	bool cSemaphoreWin32::Wait()
+	{
+		return WaitForSingleObject(mpSemaphoreHandle, INFINITE)==WAIT_OBJECT_0;
+	}
+	
+	bool cSemaphoreWin32::Signal()
+	{
+		return ReleaseSemaphore(mpSemaphoreHandle, 1, NULL)==TRUE;
+	}
+
+	//-----------------------------------------------------------------------
+
+}
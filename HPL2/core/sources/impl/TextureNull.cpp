@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl/TextureNull.h"
+
+#include "graphics/Bitmap.h"
+#include "math/Math.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cTextureNull::cTextureNull(const tString &asName,eTextureType aType, eTextureUsage aUsage, iLowLevelGraphics* apLowLevelGraphics)
+		: iTexture(asName,_W(""),aType, aUsage, apLowLevelGraphics)
+	{
+		mlFrameNum = 0;
+		mfTimeCount = 0;
+		mfTimeDir = 1;
+	}
+
+	cTextureNull::~cTextureNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateFromBitmap(cBitmap* pBmp)
+	{
+		SetSizeAndFormat(pBmp->GetSize(), pBmp->GetPixelFormat(), 1);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateAnimFromBitmapVec(std::vector<cBitmap*> *avBitmaps)
+	{
+		if(avBitmaps->empty()) return false;
+
+		cBitmap *pBmp = (*avBitmaps)[0];
+		SetSizeAndFormat(pBmp->GetSize(), pBmp->GetPixelFormat(), (int)avBitmaps->size());
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateCubeFromBitmapVec(std::vector<cBitmap*> *avBitmaps)
+	{
+		if(avBitmaps->size() < 6) return false;
+
+		cBitmap *pBmp = (*avBitmaps)[0];
+		SetSizeAndFormat(pBmp->GetSize(), pBmp->GetPixelFormat(), 1);
+		mlMemorySize *= 6;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTextureNull::CreateFromRawData(const cVector3l &avSize,ePixelFormat aPixelFormat, unsigned char *apData)
+	{
+		SetSizeAndFormat(avSize, aPixelFormat, 1);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::Update(float afTimeStep)
+	{
+		if(mlFrameNum <= 1) return;
+
+		StepTime(afTimeStep * (1.0f/mfFrameTime) * mfTimeDir);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::NextFrame()
+	{
+		StepTime(mfTimeDir);
+	}
+
+	void cTextureNull::PrevFrame()
+	{
+		StepTime(-mfTimeDir);
+	}
+
+	//-----------------------------------------------------------------------
+
+	float cTextureNull::GetT()
+	{
+		return cMath::Modulus(mfTimeCount,1.0f);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::SetSizeAndFormat(const cVector3l &avSize, ePixelFormat aPixelFormat, int alFrameNum)
+	{
+		mvSize = avSize;
+		if(mvSize.x<1)mvSize.x=1;
+		if(mvSize.y<1)mvSize.y=1;
+		if(mvSize.z<1)mvSize.z=1;
+
+		mPixelFormat = aPixelFormat;
+		mlFrameNum = alFrameNum;
+
+		mlMemorySize = mvSize.x * mvSize.y * mvSize.z * GetBytesPerPixel(aPixelFormat) * alFrameNum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureNull::StepTime(float afStep)
+	{
+		float fMax = (float)mlFrameNum;
+		mfTimeCount += afStep;
+
+		if(mfTimeCount >= fMax)
+		{
+			if(mAnimMode == eTextureAnimMode_Loop)
+			{
+				mfTimeCount =0;
+			}
+			else
+			{
+				mfTimeCount = fMax - 1.0f;
+				mfTimeDir = -1.0f;
+			}
+		}
+		else if(mfTimeCount < 0)
+		{
+			mfTimeCount =1;
+			mfTimeDir = 1.0f;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+}
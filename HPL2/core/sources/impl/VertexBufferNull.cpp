@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl/VertexBufferNull.h"
+#include "impl/LowLevelGraphicsNull.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cVertexBufferNull::cVertexBufferNull(	cLowLevelGraphicsNull* apLowLevelGraphics, eVertexBufferType aType,
+											eVertexBufferDrawType aDrawType,eVertexBufferUsageType aUsageType,
+											int alReserveVtxSize,int alReserveIdxSize) :
+	iVertexBufferOpenGL(apLowLevelGraphics,aType, aDrawType,aUsageType, alReserveVtxSize, alReserveIdxSize)
+	{
+		mpLowLevelGraphicsNull = apLowLevelGraphics;
+	}
+
+	cVertexBufferNull::~cVertexBufferNull()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cVertexBufferNull::Draw(eVertexBufferDrawType aDrawType)
+	{
+		eVertexBufferDrawType drawType = aDrawType == eVertexBufferDrawType_LastEnum ? mDrawType : aDrawType;
+
+		int lSize = mlElementNum;
+		if(mlElementNum<0) lSize = GetIndexNum();
+
+		mpLowLevelGraphicsNull->AddDrawCall(GetTriangleNum(drawType, lSize));
+	}
+
+	void cVertexBufferNull::DrawIndices(unsigned int *apIndices, int alCount, eVertexBufferDrawType aDrawType)
+	{
+		eVertexBufferDrawType drawType = aDrawType == eVertexBufferDrawType_LastEnum ? mDrawType : aDrawType;
+
+		mpLowLevelGraphicsNull->AddDrawCall(GetTriangleNum(drawType, alCount));
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cVertexBufferNull::Bind()
+	{
+		mpLowLevelGraphicsNull->AddVertexBufferBind();
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	iVertexBufferOpenGL* cVertexBufferNull::CreateDataCopy(tVertexElementFlag aFlags, eVertexBufferDrawType aDrawType,
+															eVertexBufferUsageType aUsageType,
+															int alReserveVtxSize,int alReserveIdxSize)
+	{
+		return hplNew(cVertexBufferNull, (mpLowLevelGraphicsNull,mType,aDrawType,aUsageType,alReserveVtxSize,alReserveIdxSize));
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cVertexBufferNull::GetTriangleNum(eVertexBufferDrawType aDrawType, int alIndexNum)
+	{
+		switch(aDrawType)
+		{
+		case eVertexBufferDrawType_Tri:			return alIndexNum / 3;
+		case eVertexBufferDrawType_TriStrip:
+		case eVertexBufferDrawType_TriFan:		return alIndexNum > 2 ? alIndexNum - 2 : 0;
+		case eVertexBufferDrawType_Quad:		return (alIndexNum / 4) * 2;
+		case eVertexBufferDrawType_QuadStrip:	return alIndexNum > 2 ? ((alIndexNum - 2) / 2) * 2 : 0;
+		default:								return 0;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+}
@@ -56,7 +56,7 @@ namespace hpl {
 
 	void cVertexBufferOGL_Array::UpdateData(tVertexElementFlag aTypes, bool abIndices)
 	{
-		
+		if((aTypes & eVertexElementFlag_Position) || abIndices) DestroyTriangleBVH();
 	}
 	//-----------------------------------------------------------------------
 
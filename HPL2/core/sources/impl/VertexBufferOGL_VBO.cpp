@@ -73,7 +73,7 @@ namespace hpl {
 
 	void cVertexBufferOGL_VBO::UpdateData(tVertexElementFlag aTypes, bool abIndices)
 	{
-		;
+		if((aTypes & eVertexElementFlag_Position) || abIndices) DestroyTriangleBVH();
 
 		GLenum usageType = GL_STATIC_DRAW_ARB;
 		if(mUsageType== eVertexBufferUsageType_Dynamic) usageType = GL_DYNAMIC_DRAW_ARB;
@@ -535,6 +535,7 @@ namespace hpl {
 		if(pElement==NULL) return;
 
 		pElement->Resize(alSize);
+		if(aElement == eVertexBufferElement_Position) DestroyTriangleBVH();
 	}
 
 	//-----------------------------------------------------------------------
@@ -542,6 +543,7 @@ namespace hpl {
 	void iVertexBufferOpenGL::ResizeIndices(int alSize)
 	{
 		mvIndexArray.resize(alSize);
+		DestroyTriangleBVH();
 	}
 
 	//-----------------------------------------------------------------------
@@ -24,9 +24,17 @@
 #include "math/Math.h"
 #include "graphics/Texture.h"
 #include "system/String.h"
+#include "system/Mutex.h"
+#include "system/Semaphore.h"
 
 #include <cstdio>
 #include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HPL_VIDEO_USE_SSE2
+	#include <emmintrin.h>
+#endif
 
 //#pragma comment(lib, "libogg.lib")
 //#pragma comment(lib, "libtheora.lib")
@@ -34,81 +42,125 @@
 namespace hpl {
 
 	//////////////////////////////////////////////////////////////////////////
-	// LOADER
+	// YUV CONVERSION
 	//////////////////////////////////////////////////////////////////////////
 
 	//-----------------------------------------------------------------------
 
-	cVideoStreamTheora_Loader::cVideoStreamTheora_Loader()
+	// Fixed point BT.601 with 6 fraction bits:
+	// R = 1.164(Y-16) + 1.596V, G = 1.164(Y-16) - 0.813V - 0.391U, B = 1.164(Y-16) + 2.018U (U and V are -128)
+	static const int kYuvScaleY = 75;
+	static const int kYuvScaleRV = 102;
+	static const int kYuvScaleGV = 52;
+	static const int kYuvScaleGU = 25;
+	static const int kYuvScaleBU = 129;
+
+	static inline unsigned char ClampYuvResult(int alX)
 	{
-		//////////////////////////////////////
-		// Set up extensions
-		AddSupportedExtension("dds");
+		return (unsigned char)(alX < 0 ? 0 : (alX > 255 ? 255 : alX));
+	}
 
-		//////////////////////////////////////
-		// Calculate YUV -> RBG
-		
-		//////////////////////////////
-		//Create buffers
-		mpYuvToR = hplNewArray( unsigned char,256*256);
-		mpYuvToB = hplNewArray( unsigned char,256*256);
-
-		mpYuv_G_UV = hplNewArray( unsigned short,256*256);
-		mpYuv_G_Y_UV = hplNewArray( unsigned char,256*1024);
-
-		//////////////////////////////
-		//Values for R and B
-		float fY, fI,fJ,fUV;
-		for(int i=0; i<256; ++i)
-		for(int y=0; y<256; ++y)
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Converts one row of 4:2:0 data to RGBA, one U and V sample is used for two pixels.
+	 */
+	static void ConvertYUVRowToRGBA(unsigned char *apDest, const unsigned char *apY, const unsigned char *apU, const unsigned char *apV, int alWidth)
+	{
+		int x=0;
+
+	#ifdef HPL_VIDEO_USE_SSE2
+		const __m128i vZero = _mm_setzero_si128();
+		const __m128i vYOffset = _mm_set1_epi16(16);
+		const __m128i vUVOffset = _mm_set1_epi16(128);
+		const __m128i vRound = _mm_set1_epi16(32);
+		const __m128i vScaleY = _mm_set1_epi16(kYuvScaleY);
+		const __m128i vScaleRV = _mm_set1_epi16(kYuvScaleRV);
+		const __m128i vScaleGV = _mm_set1_epi16(kYuvScaleGV);
+		const __m128i vScaleGU = _mm_set1_epi16(kYuvScaleGU);
+		const __m128i vScaleBU = _mm_set1_epi16(kYuvScaleBU);
+		const __m128i vAlpha = _mm_set1_epi8((char)0xFF);
+
+		//16 pixels at a time, all intermediate values fit in signed 16 bit.
+		for(; x+16 <= alWidth; x+=16)
 		{
-			fY = 1.164f * ((float)y -16);
-			fI = (float)i;
-			
-			//I = V
-			mpYuvToR[y + i*256] = (unsigned char)cMath::Clamp(fY + 1.596f*(fI - 128),0,255);
-
-			//I = U
-			mpYuvToB[y + i*256] = (unsigned char)cMath::Clamp(fY + 2.018f * (fI - 128),0,255);
-		}
+			__m128i vY = _mm_loadu_si128((const __m128i*)(apY + x));
+			__m128i vU = _mm_loadl_epi64((const __m128i*)(apU + x/2));
+			__m128i vV = _mm_loadl_epi64((const __m128i*)(apV + x/2));
 
-		///////////////////////////////////////////////////
-		//Split the Green computation into two buffer
-		float fMinVal = 0.813f * (-128.0f) - 0.391f * 127;
-		float fMaxVal = 0.813f * (127.0f) + 0.391f * 128;
+			//Duplicate each chroma sample for the two pixels sharing it
+			vU = _mm_unpacklo_epi8(vU, vU);
+			vV = _mm_unpacklo_epi8(vV, vV);
 
-		//Green UV part
-		for(int i=0; i<256; ++i)
-		for(int j=0; j<256; ++j)
-		{
-			//I= U J = V
-			fJ = (float)j;
-			fI = (float)i;
+			__m128i vRGB[2][3];
+			for(int i=0; i<2; ++i)
+			{
+				__m128i vY16 = i==0 ? _mm_unpacklo_epi8(vY, vZero) : _mm_unpackhi_epi8(vY, vZero);
+				__m128i vU16 = i==0 ? _mm_unpacklo_epi8(vU, vZero) : _mm_unpackhi_epi8(vU, vZero);
+				__m128i vV16 = i==0 ? _mm_unpacklo_epi8(vV, vZero) : _mm_unpackhi_epi8(vV, vZero);
+
+				vY16 = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(vY16, vYOffset), vScaleY), vRound);
+				vU16 = _mm_sub_epi16(vU16, vUVOffset);
+				vV16 = _mm_sub_epi16(vV16, vUVOffset);
+
+				__m128i vR = _mm_adds_epi16(vY16, _mm_mullo_epi16(vV16, vScaleRV));
+				__m128i vG = _mm_subs_epi16(_mm_subs_epi16(vY16, _mm_mullo_epi16(vV16, vScaleGV)), _mm_mullo_epi16(vU16, vScaleGU));
+				__m128i vB = _mm_adds_epi16(vY16, _mm_mullo_epi16(vU16, vScaleBU));
 
-			float fUV = 0.813f*(fJ - 128) - 0.391f * (fI - 128);
-			mpYuv_G_UV[i*256 + j] = (unsigned short)cMath::Clamp(((fUV - fMinVal) / (fMaxVal - fMinVal)) * 1023.0f,0,1023.0f);
+				vRGB[i][0] = _mm_srai_epi16(vR, 6);
+				vRGB[i][1] = _mm_srai_epi16(vG, 6);
+				vRGB[i][2] = _mm_srai_epi16(vB, 6);
+			}
+
+			__m128i vR8 = _mm_packus_epi16(vRGB[0][0], vRGB[1][0]);
+			__m128i vG8 = _mm_packus_epi16(vRGB[0][1], vRGB[1][1]);
+			__m128i vB8 = _mm_packus_epi16(vRGB[0][2], vRGB[1][2]);
+
+			//Interleave to RGBA
+			__m128i vRGLo = _mm_unpacklo_epi8(vR8, vG8);
+			__m128i vRGHi = _mm_unpackhi_epi8(vR8, vG8);
+			__m128i vBALo = _mm_unpacklo_epi8(vB8, vAlpha);
+			__m128i vBAHi = _mm_unpackhi_epi8(vB8, vAlpha);
+
+			__m128i *pDest = (__m128i*)(apDest + x*4);
+			_mm_storeu_si128(pDest+0, _mm_unpacklo_epi16(vRGLo, vBALo));
+			_mm_storeu_si128(pDest+1, _mm_unpackhi_epi16(vRGLo, vBALo));
+			_mm_storeu_si128(pDest+2, _mm_unpacklo_epi16(vRGHi, vBAHi));
+			_mm_storeu_si128(pDest+3, _mm_unpackhi_epi16(vRGHi, vBAHi));
 		}
+	#endif
 
-		//Green Y * UV part
-		for(int i=0; i<1024; ++i)
-		for(int y=0; y<256; ++y)
+		for(; x<alWidth; ++x)
 		{
-			fY = 1.164f * ((float)y -16);
-			fUV = (float)i;
-			fUV = (fUV / 1023.0f) * (fMaxVal - fMinVal) + fMinVal;
-
-			mpYuv_G_Y_UV[i*256 + y] = (unsigned char)cMath::Clamp(fY - fUV, 0, 255);
+			const int lY = (apY[x] - 16) * kYuvScaleY + 32;
+			const int lU = apU[x/2] - 128;
+			const int lV = apV[x/2] - 128;
+
+			unsigned char *pDest = apDest + x*4;
+			pDest[0] = ClampYuvResult((lY + kYuvScaleRV*lV) >> 6);
+			pDest[1] = ClampYuvResult((lY - kYuvScaleGV*lV - kYuvScaleGU*lU) >> 6);
+			pDest[2] = ClampYuvResult((lY + kYuvScaleBU*lU) >> 6);
+			pDest[3] = 255;
 		}
+	}
+
+	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// LOADER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cVideoStreamTheora_Loader::cVideoStreamTheora_Loader()
+	{
+		//////////////////////////////////////
+		// Set up extensions
+		AddSupportedExtension("dds");
 	}
 
 	cVideoStreamTheora_Loader::~cVideoStreamTheora_Loader()
 	{
-		hplDeleteArray(mpYuvToR);
-		hplDeleteArray(mpYuvToB);
-
-		hplDeleteArray(mpYuv_G_UV);
-		hplDeleteArray(mpYuv_G_Y_UV);
 	}
 
 	//-----------------------------------------------------------------------
@@ -151,12 +203,23 @@ namespace hpl {
 		mfVideobufTime=0;
 
 		mfTime = 0;
+		mfLastTimeStep = 0;
 
 		mlBufferSize = 4096;
 
 		mbVideoFrameReady = false;
 
-		mpFrameBuffer = NULL;
+		mpDecoderThread = NULL;
+		mpMutex = cPlatform::CreateMutEx();
+		mpDecodeSemaphore = cPlatform::CreateSemaPhore(0);
+		mbExiting = false;
+		mbResetRequested = false;
+
+		for(int i=0; i<3; ++i) mvFrameBuffers[i] = NULL;
+		mlDecodeFrame = 0;
+		mlReadyFrame = 1;
+		mlUploadFrame = 2;
+		mbNewFrameReady = false;
 
 		//Theora structs that we want until class i deleted.
 		theora_comment_init(&mTheoraComment);
@@ -170,6 +233,21 @@ namespace hpl {
 
 	cVideoStreamTheora::~cVideoStreamTheora()
 	{
+		////////////////////////////////
+		//Wake the decoder up so it can see that we are exiting.
+		if(mpDecoderThread)
+		{
+			mpMutex->Lock();
+			mbExiting = true;
+			mpMutex->Unlock();
+			mpDecodeSemaphore->Signal();
+
+			mpDecoderThread->Stop();
+			hplDelete(mpDecoderThread);
+		}
+		hplDelete(mpDecodeSemaphore);
+		hplDelete(mpMutex);
+
 		if(mpFile) fclose(mpFile);
 
 		ogg_sync_clear(&mOggSyncState);
@@ -182,7 +260,11 @@ namespace hpl {
 		if(mbVideoLoaded)
 		{
 			theora_clear(&mTheoraState);
-			if(mpFrameBuffer) hplDeleteArray(mpFrameBuffer);
+		}
+
+		for(int i=0; i<3; ++i)
+		{
+			if(mvFrameBuffers[i]) hplDeleteArray(mvFrameBuffers[i]);
 		}
 	}
 	
@@ -220,6 +302,14 @@ namespace hpl {
 		//Initialize decoders and attributes
 		if(InitDecoders()==false) return false;
         
+		////////////////////////////////
+		//Start decoder thread
+		if(mbVideoLoaded)
+		{
+			mpDecoderThread = cPlatform::CreateThread(this);
+			mpDecoderThread->SetSleepTime(0);
+			mpDecoderThread->Start();
+		}
 
 		return true;
 	}
@@ -228,106 +318,141 @@ namespace hpl {
 
 	void cVideoStreamTheora::Update(float afTimeStep)
 	{
-		if(mbPlaying==false || mbPaused) return;
+		if(mpDecoderThread==NULL) return;
 
-		mfTime += afTimeStep;
-		////////////////////////////////
-		// Theora Decode packets until the video is ahead of real time. 
-		// (This could be skipped once non-keyframe seeks can be made?)
-		while(!mlVideobufReady && mfVideobufTime < mfTime)
+		mpMutex->Lock();
+		bool bAdvance = mbPlaying && mbPaused==false;
+		if(bAdvance)
 		{
-			//Get first packet and decode,
-			ogg_packet packet;
-			if(ogg_stream_packetout(&mTheoraStreamState,&packet)>0)
-			{
-				if(theora_decode_packetin(&mTheoraState,&packet)==0)
-				{
-					//Get new time for current fram position.
-					mlVideobufGranulePos = mTheoraState.granulepos;
-					mfVideobufTime = theora_granule_time(&mTheoraState,mlVideobufGranulePos);
-
-					mbVideoFrameReady = true;	
-				}
-			}
-			//No packets left, get new page.
-			else
-			{
-				//Get Next page
-				ogg_page page;
-				if(ogg_sync_pageout(&mOggSyncState,&page) > 0)
-				{
-					QueuePage(&page);	
-				}
-				//No pages left, read more buffer data.
-				else
-				{
-					int bytes= BufferData(mpFile,&mOggSyncState);
-					//Fill streams with pages.
-					if(bytes!=0)
-					{
-						while(ogg_sync_pageout(&mOggSyncState,&page)>0) QueuePage(&page);
-					}
-					//No more buffer data in file, stop video				
-					else
-					{
-						if(mbLooping==false) mbPlaying = false;
-						ResetStreams();
-					}
-					
-				}
-			}
+			mfTime += afTimeStep;
+			mfLastTimeStep = afTimeStep;
 		}
+		mpMutex->Unlock();
 
-		
-		////////////////////////////////
-		// Theora Check for end of file.
-		if(!mlVideobufReady && feof(mpFile))
-		{
-			if(mbLooping==false) mbPlaying = false;
-			ResetStreams();
-		}
+		//Let the decoder catch up with the new time
+		if(bAdvance) mpDecodeSemaphore->Signal();
 	}
 
 	//-----------------------------------------------------------------------
 
 	void cVideoStreamTheora::Play()
 	{
+		mpMutex->Lock();
 		mbPlaying = true;
+		mpMutex->Unlock();
 	}
 	
 	//-----------------------------------------------------------------------
 
 	void cVideoStreamTheora::Stop()
 	{
+		mpMutex->Lock();
 		mbPlaying = false;
-		ResetStreams();
+		mfTime = 0;
+		mbResetRequested = true;
+		mbNewFrameReady = false;
+		mpMutex->Unlock();
+
+		//The decoder does the actual reset
+		if(mpDecoderThread) mpDecodeSemaphore->Signal();
 	}
 
 	//-----------------------------------------------------------------------
 
 	void cVideoStreamTheora::Pause(bool abX)
 	{
+		mpMutex->Lock();
 		mbPaused = abX;
+		mpMutex->Unlock();
 	}
 	//-----------------------------------------------------------------------
 
 
 	void cVideoStreamTheora::SetLoop(bool abX)
 	{
+		mpMutex->Lock();
 		mbLooping = abX;
+		mpMutex->Unlock();
 	}
 	
 	//-----------------------------------------------------------------------
 
 	void cVideoStreamTheora::CopyToTexture(iTexture *apTexture)
 	{
-		if(mbVideoLoaded==false || mpFrameBuffer ==NULL) return;
+		if(mbVideoLoaded==false || mpDecoderThread==NULL) return;
+
+		////////////////////////////////
+		//Take the newest finished frame, the decoder keeps writing to its own buffer meanwhile.
+		mpMutex->Lock();
+		bool bNewFrame = mbNewFrameReady;
+		if(bNewFrame)
+		{
+			std::swap(mlUploadFrame, mlReadyFrame);
+			mbNewFrameReady = false;
+		}
+		mpMutex->Unlock();
+
+		if(bNewFrame)
+		{
+			apTexture->SetRawData(0,0,cVector3l(mvSize.x,mvSize.y,1) ,ePixelFormat_RGBA,mvFrameBuffers[mlUploadFrame]);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cVideoStreamTheora::UpdateThread()
+	{
+		//Sleep until the time has been updated (or the stream is exiting)
+		mpDecodeSemaphore->Wait();
+
+		////////////////////////////////
+		//Get the state set by the main thread
+		mpMutex->Lock();
+		if(mbExiting)
+		{
+			mpMutex->Unlock();
+			mpDecodeSemaphore->Signal();
+			return;
+		}
+		bool bReset = mbResetRequested;
+		mbResetRequested = false;
+		bool bPlaying = mbPlaying && mbPaused==false;
+		//Decode one step ahead since the frame is uploaded on a later frame.
+		float fTargetTime = mfTime + mfLastTimeStep;
+		mpMutex->Unlock();
+
+		if(bReset) ResetStreams();
+		if(bPlaying==false) return;
+
+		////////////////////////////////
+		//Decode and convert
+		bool bEndOfStream = DecodeToTime(fTargetTime);
 
 		if(mbVideoFrameReady)
 		{
-			DrawFrameToBuffer();
-			apTexture->SetRawData(0,0,cVector3l(mvSize.x,mvSize.y,1) ,ePixelFormat_RGB,mpFrameBuffer);
+			DrawFrameToBuffer(mvFrameBuffers[mlDecodeFrame]);
 			mbVideoFrameReady = false;
+
+			mpMutex->Lock();
+			//Skip the frame if the stream was stopped while decoding.
+			if(mbResetRequested==false)
+			{
+				std::swap(mlDecodeFrame, mlReadyFrame);
+				mbNewFrameReady = true;
+			}
+			mpMutex->Unlock();
+		}
+
+		////////////////////////////////
+		//Restart stream at end
+		if(bEndOfStream)
+		{
+			ResetStreams();
+
+			mpMutex->Lock();
+			mfTime = 0;
+			if(mbLooping==false) mbPlaying = false;
+			mpMutex->Unlock();
 		}
 	}
 
@@ -339,7 +464,66 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void cVideoStreamTheora::DrawFrameToBuffer()
+	/**
+	 * Decodes packets until the video is ahead of afTime. Returns true if the end of the file was reached.
+	 */
+	bool cVideoStreamTheora::DecodeToTime(float afTime)
+	{
+		////////////////////////////////
+		// Theora Decode packets until the video is ahead of real time. 
+		// (This could be skipped once non-keyframe seeks can be made?)
+		while(!mlVideobufReady && mfVideobufTime < afTime)
+		{
+			//Get first packet and decode,
+			ogg_packet packet;
+			if(ogg_stream_packetout(&mTheoraStreamState,&packet)>0)
+			{
+				if(theora_decode_packetin(&mTheoraState,&packet)==0)
+				{
+					//Get new time for current fram position.
+					mlVideobufGranulePos = mTheoraState.granulepos;
+					mfVideobufTime = theora_granule_time(&mTheoraState,mlVideobufGranulePos);
+
+					mbVideoFrameReady = true;	
+				}
+			}
+			//No packets left, get new page.
+			else
+			{
+				//Get Next page
+				ogg_page page;
+				if(ogg_sync_pageout(&mOggSyncState,&page) > 0)
+				{
+					QueuePage(&page);	
+				}
+				//No pages left, read more buffer data.
+				else
+				{
+					int bytes= BufferData(mpFile,&mOggSyncState);
+					//Fill streams with pages.
+					if(bytes!=0)
+					{
+						while(ogg_sync_pageout(&mOggSyncState,&page)>0) QueuePage(&page);
+					}
+					//No more buffer data in file, stop video				
+					else
+					{
+						return true;
+					}
+					
+				}
+			}
+		}
+
+		
+		////////////////////////////////
+		// Theora Check for end of file.
+		return !mlVideobufReady && feof(mpFile);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cVideoStreamTheora::DrawFrameToBuffer(unsigned char *apDestBuffer)
 	{
 		////////////////////////////////
 		//Get YUV buffer
@@ -353,109 +537,20 @@ namespace hpl {
 		size_t lCropOffsetY = mTheoraInfo.offset_x + yuvBuffer.y_stride * mTheoraInfo.offset_y;
 		size_t lCropOffsetUV = mTheoraInfo.offset_x/2 + yuvBuffer.uv_stride * (mTheoraInfo.offset_y/2);
 
-		//Pointers to conversion buffers.
-		unsigned char* pYuvToR = mpLoader->mpYuvToR;
-		unsigned char* pYuvToB = mpLoader->mpYuvToB;
-
-		unsigned short* pYuv_G_UV = mpLoader->mpYuv_G_UV;
-		unsigned char*  pYuv_G_Y_UV = mpLoader->mpYuv_G_Y_UV;
+		const unsigned char *pYBuffer = yuvBuffer.y + lCropOffsetY;
+		const unsigned char *pUBuffer = yuvBuffer.u + lCropOffsetUV;
+		const unsigned char *pVBuffer = yuvBuffer.v + lCropOffsetUV;
 
 		/////////////////////////////////
-		//Write Y to R
-
-		//Get start of buffers
-		unsigned char *pSrcBuffer = mpFrameBuffer;
-		unsigned char *pYBuffer = yuvBuffer.y + lCropOffsetY;
-		
-		//Set up counters
-		int lXCount = mvSize.x;
-		int lYCount = mvSize.y;
-		
-		//Precalculate some values
-		const int lYBufferAdd = yuvBuffer.y_stride - mvSize.x;
-
-		//Go through Y surface of copy to R in frame buffer
-		while(lYCount)
+		//Convert row by row, each chroma row is used for two rows.
+		const int lDestRowSize = mvSize.x*4;
+		for(int y=0; y<mvSize.y; ++y)
 		{
-			*pSrcBuffer = *pYBuffer;
-
-			pSrcBuffer+=3;
-			pYBuffer++;
-
-			--lXCount;
-			if(!lXCount)
-			{
-				pYBuffer += lYBufferAdd;
-				lXCount = mvSize.x;
-				--lYCount;
-			}
-		}
-
-		/////////////////////////////////
-		//Write UV and use R as Y
-
-		//Get start of buffers
-		pSrcBuffer = mpFrameBuffer;
-		unsigned char *pUBuffer = yuvBuffer.u + lCropOffsetUV;
-		unsigned char *pVBuffer = yuvBuffer.v + lCropOffsetUV;
-		
-		//Setup counters
-		lXCount = mvSize.x/2;
-		lYCount = mvSize.y/2;
-		
-		//Precalculate some values
-		const int lXRowAdd = mvSize.x/2;
-		const int lSourceRowSize = mvSize.x*3;
-		const int lUVBufferAdd = yuvBuffer.uv_stride - mvSize.x/2;
-		unsigned char y;
-		
-		//Go through UV surfaces and convert to RGB in frame buffer
-		while(lYCount)
-		{
-			const unsigned short u_add = (*pUBuffer) <<8;
-			const unsigned short v_add = (*pVBuffer) <<8;
-			const unsigned int g_uv_add = (pYuv_G_UV[u_add + (*pVBuffer)])<<8;
-
-			//Here we draw to a 2x2 large piece of source.
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];	
-
-			pSrcBuffer+= 3;
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];			
-
-			pSrcBuffer += lSourceRowSize - 3;
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];			
-
-			pSrcBuffer += 3;
-			y = *pSrcBuffer;
-			pSrcBuffer[0] = pYuvToR[y + v_add];
-			pSrcBuffer[1] = pYuv_G_Y_UV[y +(g_uv_add)];
-			pSrcBuffer[2] = pYuvToB[y + u_add];			
-
-			pSrcBuffer-= lSourceRowSize;
-
-			pSrcBuffer+=3;
-
-			pUBuffer++;
-			pVBuffer++;
-
-			--lXCount;
-			if(!lXCount)
-			{
-				pSrcBuffer+= lSourceRowSize;
-				pVBuffer += lUVBufferAdd;
-				pUBuffer += lUVBufferAdd;
-				lXCount = lXRowAdd;
-				--lYCount;
-			}
+			ConvertYUVRowToRGBA(apDestBuffer + y*lDestRowSize, 
+								pYBuffer + y*yuvBuffer.y_stride,
+								pUBuffer + (y/2)*yuvBuffer.uv_stride,
+								pVBuffer + (y/2)*yuvBuffer.uv_stride,
+								mvSize.x);
 		}
 	}
 
@@ -518,7 +613,11 @@ namespace hpl {
 
 			mvSize = cVector2l(mTheoraInfo.frame_width, mTheoraInfo.frame_height);
 
-			mpFrameBuffer = hplNewArray(unsigned char,mvSize.x * mvSize.y *3);
+			for(int i=0; i<3; ++i)
+			{
+				mvFrameBuffers[i] = hplNewArray(unsigned char,mvSize.x * mvSize.y *4);
+				memset(mvFrameBuffers[i], 0, mvSize.x * mvSize.y *4);
+			}
 		}
 		else
 		{
@@ -548,8 +647,7 @@ namespace hpl {
 		
 
 		////////////////////////////////
-		//Reset variables
-		mfTime =0;
+		//Reset variables (mfTime is owned by the main thread and reset by the caller)
 		mfVideobufTime =0;
 		mbVideoFrameReady = false;
 		
@@ -22,6 +22,10 @@
 #include "math/Math.h"
 #include "graphics/LowLevelGraphics.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HPL_BV_USE_SSE2
+	#include <emmintrin.h>
+#endif
 
 namespace hpl {
 
@@ -472,42 +476,77 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 		
-	void cBoundingVolume::UpdateSize()
+	/**
+	 * Transforms the local box as center and half extents (without translation). The world extent along each
+	 * axis is the sum of the absolute rotation (and scale) entries times the local extents, which gives the 
+	 * same box as transforming all 8 corners, without any branching.
+	 */
+	static inline void TransformBox(const cMatrixf& a_mtxTransform, const cVector3f& avLocalMin, const cVector3f& avLocalMax,
+									cVector3f& avMin, cVector3f& avMax)
 	{
-		if(mbSizeUpdated)
-		{
-			cMatrixf mtxRot = m_mtxTransform.GetRotation();
-
-			//Transform the local corners
-			cVector3f vCorners[8];
-			vCorners[0] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMax.x,mvLocalMax.y,mvLocalMax.z));
-			vCorners[1] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMax.x,mvLocalMax.y,mvLocalMin.z));
-			vCorners[2] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMax.x,mvLocalMin.y,mvLocalMax.z));
-			vCorners[3] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMax.x,mvLocalMin.y,mvLocalMin.z));
-
-			vCorners[4] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMin.x,mvLocalMax.y,mvLocalMax.z));
-			vCorners[5] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMin.x,mvLocalMax.y,mvLocalMin.z));
-			vCorners[6] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMin.x,mvLocalMin.y,mvLocalMax.z));
-			vCorners[7] = cMath::MatrixMul(mtxRot, cVector3f(mvLocalMin.x,mvLocalMin.y,mvLocalMin.z));
-			
-			mvMax = vCorners[0];
-			mvMin = vCorners[0];
+		const float (*m)[4] = a_mtxTransform.m;
+
+	#ifdef HPL_BV_USE_SSE2
+		//Transpose so each register holds a column of the rotation.
+		__m128 vCol0 = _mm_loadu_ps(m[0]);
+		__m128 vCol1 = _mm_loadu_ps(m[1]);
+		__m128 vCol2 = _mm_loadu_ps(m[2]);
+		__m128 vCol3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(vCol0, vCol1, vCol2, vCol3);
+
+		const __m128 vHalf = _mm_set1_ps(0.5f);
+		const __m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		__m128 vLocalMin = _mm_setr_ps(avLocalMin.x, avLocalMin.y, avLocalMin.z, 0);
+		__m128 vLocalMax = _mm_setr_ps(avLocalMax.x, avLocalMax.y, avLocalMax.z, 0);
+		__m128 vCenter = _mm_mul_ps(_mm_add_ps(vLocalMax, vLocalMin), vHalf);
+		__m128 vExtent = _mm_mul_ps(_mm_sub_ps(vLocalMax, vLocalMin), vHalf);
+
+		__m128 vWorldCenter = _mm_add_ps(_mm_add_ps(	_mm_mul_ps(vCol0, _mm_shuffle_ps(vCenter, vCenter, _MM_SHUFFLE(0,0,0,0))),
+														_mm_mul_ps(vCol1, _mm_shuffle_ps(vCenter, vCenter, _MM_SHUFFLE(1,1,1,1)))),
+														_mm_mul_ps(vCol2, _mm_shuffle_ps(vCenter, vCenter, _MM_SHUFFLE(2,2,2,2))));
+		__m128 vWorldExtent = _mm_add_ps(_mm_add_ps(	_mm_mul_ps(_mm_and_ps(vCol0, vAbsMask), _mm_shuffle_ps(vExtent, vExtent, _MM_SHUFFLE(0,0,0,0))),
+														_mm_mul_ps(_mm_and_ps(vCol1, vAbsMask), _mm_shuffle_ps(vExtent, vExtent, _MM_SHUFFLE(1,1,1,1)))),
+														_mm_mul_ps(_mm_and_ps(vCol2, vAbsMask), _mm_shuffle_ps(vExtent, vExtent, _MM_SHUFFLE(2,2,2,2))));
+
+		float vMax[4], vMin[4];
+		_mm_storeu_ps(vMax, _mm_add_ps(vWorldCenter, vWorldExtent));
+		_mm_storeu_ps(vMin, _mm_sub_ps(vWorldCenter, vWorldExtent));
+		avMax = cVector3f(vMax[0], vMax[1], vMax[2]);
+		avMin = cVector3f(vMin[0], vMin[1], vMin[2]);
+	#else
+		cVector3f vCenter = (avLocalMax + avLocalMin) * 0.5f;
+		cVector3f vExtent = (avLocalMax - avLocalMin) * 0.5f;
+
+		cVector3f vWorldCenter(	m[0][0]*vCenter.x + m[0][1]*vCenter.y + m[0][2]*vCenter.z,
+								m[1][0]*vCenter.x + m[1][1]*vCenter.y + m[1][2]*vCenter.z,
+								m[2][0]*vCenter.x + m[2][1]*vCenter.y + m[2][2]*vCenter.z);
+		cVector3f vWorldExtent(	fabsf(m[0][0])*vExtent.x + fabsf(m[0][1])*vExtent.y + fabsf(m[0][2])*vExtent.z,
+								fabsf(m[1][0])*vExtent.x + fabsf(m[1][1])*vExtent.y + fabsf(m[1][2])*vExtent.z,
+								fabsf(m[2][0])*vExtent.x + fabsf(m[2][1])*vExtent.y + fabsf(m[2][2])*vExtent.z);
+
+		avMax = vWorldCenter + vWorldExtent;
+		avMin = vWorldCenter - vWorldExtent;
+	#endif
+	}
 
-			//Calculate the transformed min and max
-            for(int i=1; i<8;i++)
-			{
-				//X
-				if(vCorners[i].x < mvMin.x) mvMin.x = vCorners[i].x;
-				else if(vCorners[i].x > mvMax.x) mvMax.x = vCorners[i].x;
+	//-----------------------------------------------------------------------
+
+	void cBoundingVolume::UpdateSizes(cBoundingVolume **apVolumes, size_t alNum)
+	{
+		for(size_t i=0; i<alNum; ++i)
+		{
+			cBoundingVolume *pBV = apVolumes[i];
+			if(pBV->mbSizeUpdated || pBV->mbPositionUpdated) pBV->UpdateSize();
+		}
+	}
 
-				//Y
-				if(vCorners[i].y < mvMin.y) mvMin.y = vCorners[i].y;
-				else if(vCorners[i].y > mvMax.y) mvMax.y = vCorners[i].y;
+	//-----------------------------------------------------------------------
 
-				//Z
-				if(vCorners[i].z < mvMin.z) mvMin.z = vCorners[i].z;
-				else if(vCorners[i].z > mvMax.z) mvMax.z = vCorners[i].z;
-			}
+	void cBoundingVolume::UpdateSize()
+	{
+		if(mbSizeUpdated)
+		{
+			TransformBox(m_mtxTransform, mvLocalMin, mvLocalMax, mvMin, mvMax);
 			
 			//Get the transformed size.
 			mvSize = mvMax - mvMin;
@@ -20,6 +20,7 @@
 #include "math/Math.h"
 
 #include "math/Frustum.h"
+#include "math/TriangleBVH.h"
 #include "graphics/VertexBuffer.h"
 
 #include "system/LowLevelSystem.h"
@@ -31,10 +32,33 @@
 #include <time.h>
 #include <map>
 
+#ifdef _MSC_VER
+	#define HPL_MATH_THREAD_LOCAL __declspec(thread)
+#else
+	#define HPL_MATH_THREAD_LOCAL __thread
+#endif
+
 namespace hpl {
 
 	static char mpTempChar[1024];
 
+	//State of the random generator used instead of rand() on this thread, 0 if not used.
+	static HPL_MATH_THREAD_LOCAL unsigned int glThreadRandomState = 0;
+
+	//-----------------------------------------------------------------------
+
+	static inline int GetRand()
+	{
+		if(glThreadRandomState==0) return rand();
+
+		//Xorshift, the state never becomes 0.
+		glThreadRandomState ^= glThreadRandomState << 13;
+		glThreadRandomState ^= glThreadRandomState >> 17;
+		glThreadRandomState ^= glThreadRandomState << 5;
+
+		return (int)((glThreadRandomState >> 1) % ((unsigned int)RAND_MAX + 1));
+	}
+
 	//////////////////////////////////////////////////////////////////////////
 	// RANDOM GENERATION
 	//////////////////////////////////////////////////////////////////////////
@@ -43,14 +67,14 @@ namespace hpl {
 	
 	int cMath::RandRectl(int alMin, int alMax)
 	{
-		return (rand()%(alMax-alMin+1))+alMin;
+		return (GetRand()%(alMax-alMin+1))+alMin;
 	}
 	
 	//-----------------------------------------------------------------------
 
 	float cMath::RandRectf(float afMin, float afMax)
 	{
-		float fRand= (float)rand()/(float)RAND_MAX;
+		float fRand= (float)GetRand()/(float)RAND_MAX;
         				
 		return afMin + fRand*(afMax-afMin);
 	}
@@ -111,6 +135,14 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cMath::SetThreadRandomSeed(unsigned int alSeed)
+	{
+		//Spread the bits of small seeds, the first numbers are poor otherwise.
+		glThreadRandomState = alSeed ? (alSeed * 2654435761u) | 1 : 0;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// BIT WISE OPERATIONS
 	//////////////////////////////////////////////////////////////////////////
@@ -2415,16 +2447,81 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	static cVector2f GetTriangleBarycentric(const cVector3f& avPos, const cVector3f& avP0, const cVector3f& avP1, const cVector3f& avP2)
+	{
+		cVector3f vEdge1 = avP1 - avP0;
+		cVector3f vEdge2 = avP2 - avP0;
+		cVector3f vToPos = avPos - avP0;
+
+		float fD11 = cMath::Vector3Dot(vEdge1, vEdge1);
+		float fD12 = cMath::Vector3Dot(vEdge1, vEdge2);
+		float fD22 = cMath::Vector3Dot(vEdge2, vEdge2);
+		float fDenom = fD11 * fD22 - fD12 * fD12;
+		if(fabs(fDenom) < kEpsilonf) return cVector2f(0);
+
+		float fP1 = cMath::Vector3Dot(vToPos, vEdge1);
+		float fP2 = cMath::Vector3Dot(vToPos, vEdge2);
+		
+		return cVector2f((fD22 * fP1 - fD12 * fP2) / fDenom, (fD11 * fP2 - fD12 * fP1) / fDenom);
+	}
+
+	//-----------------------------------------------------------------------
+
 	bool cMath::CheckLineTriVertexBufferIntersection( const cVector3f& avLineStart, const cVector3f& avLineEnd,
 														const cMatrixf& a_mtxInvMeshMtx, iVertexBuffer *apVtxBuffer,
-														cVector3f *apIntersectionPos, float *apT, int *apTriIndex, bool abSkipBackfacing)
-	{
-		return CheckLineTriMeshIntersection(avLineStart, avLineEnd, 
-											a_mtxInvMeshMtx,
-											apVtxBuffer->GetIndices(), apVtxBuffer->GetIndexNum(),
-											apVtxBuffer->GetFloatArray(eVertexBufferElement_Position), 
-											apVtxBuffer->GetElementNum(eVertexBufferElement_Position),
-											apIntersectionPos, apT, apTriIndex, abSkipBackfacing);
+														cVector3f *apIntersectionPos, float *apT, int *apTriIndex, bool abSkipBackfacing,
+														cVector2f *apBarycentric)
+	{
+		////////////////////////////
+		// Dynamic data, check the triangles one by one
+		if(apVtxBuffer->GetUsageType() != eVertexBufferUsageType_Static)
+		{
+			const unsigned int *pIndices = apVtxBuffer->GetIndices();
+			const float *pVertices = apVtxBuffer->GetFloatArray(eVertexBufferElement_Position);
+			int lStride = apVtxBuffer->GetElementNum(eVertexBufferElement_Position);
+
+			float fT;
+			int lTriIdx;
+			if(CheckLineTriMeshIntersection(avLineStart, avLineEnd, a_mtxInvMeshMtx,
+											pIndices, apVtxBuffer->GetIndexNum(), pVertices, lStride,
+											apIntersectionPos, &fT, &lTriIdx, abSkipBackfacing)==false)
+			{
+				return false;
+			}
+
+			if(apT) *apT = fT;
+			if(apTriIndex) *apTriIndex = lTriIdx;
+			if(apBarycentric)
+			{
+				cVector3f vP[3];
+				for(int i=0; i<3; ++i)
+				{
+					const float *pVtx = &pVertices[pIndices[lTriIdx+i]*lStride];
+					vP[i] = cVector3f(pVtx[0], pVtx[1], pVtx[2]);
+				}
+				cVector3f vLocalStart = MatrixMul(a_mtxInvMeshMtx, avLineStart);
+				cVector3f vLocalPos = vLocalStart + (MatrixMul(a_mtxInvMeshMtx, avLineEnd) - vLocalStart)*fT;
+				
+				*apBarycentric = GetTriangleBarycentric(vLocalPos, vP[0], vP[1], vP[2]);
+			}
+			return true;
+		}
+
+		////////////////////////////
+		// Static data, use the cached hierarchy
+		cVector3f vLocalLineStart = MatrixMul(a_mtxInvMeshMtx, avLineStart);
+		cVector3f vLocalLineEnd = MatrixMul(a_mtxInvMeshMtx, avLineEnd);
+
+		cTriangleBVHHit hit;
+		if(apVtxBuffer->GetTriangleBVH()->CheckLineIntersection(vLocalLineStart, vLocalLineEnd, &hit, abSkipBackfacing)==false)
+			return false;
+
+		if(apT) *apT = hit.mfT;
+		if(apIntersectionPos) *apIntersectionPos = avLineStart + (avLineEnd - avLineStart)*hit.mfT;
+		if(apTriIndex) *apTriIndex = hit.mlTriIndex;
+		if(apBarycentric) *apBarycentric = hit.mvBarycentric;
+		
+		return true;
 	}
 
 	//-----------------------------------------------------------------------
@@ -0,0 +1,355 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "math/TriangleBVH.h"
+
+#include "math/Math.h"
+
+#include <algorithm>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static const int glTriangleBVHMaxLeafSize = 4;
+	static const int glTriangleBVHMaxStackSize = 64;
+
+	//-----------------------------------------------------------------------
+
+	class cTriangleBVHCentroidCompare
+	{
+	public:
+		cTriangleBVHCentroidCompare(const std::vector<cVector3f>* apCentroids, int alAxis) : mpCentroids(apCentroids), mlAxis(alAxis){}
+
+		bool operator()(int alA, int alB) const
+		{
+			return (*mpCentroids)[alA].v[mlAxis] < (*mpCentroids)[alB].v[mlAxis];
+		}
+
+	private:
+		const std::vector<cVector3f>* mpCentroids;
+		int mlAxis;
+	};
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Slab test of the line segment against the box. afMaxT is the closest hit found so far.
+	 */
+	static inline bool LineIntersectsBox(	const cVector3f& avStart, const cVector3f& avInvDelta, float afMaxT,
+											const cVector3f& avMin, const cVector3f& avMax, float *apEntryT)
+	{
+		float fMinT = 0;
+		float fMaxT = afMaxT;
+
+		for(int i=0; i<3; ++i)
+		{
+			float fT0 = (avMin.v[i] - avStart.v[i]) * avInvDelta.v[i];
+			float fT1 = (avMax.v[i] - avStart.v[i]) * avInvDelta.v[i];
+			if(fT0 > fT1) std::swap(fT0, fT1);
+
+			//NaN (0*inf) leaves the range as it is, which keeps lines lying in the slab plane.
+			if(fT0 > fMinT) fMinT = fT0;
+			if(fT1 < fMaxT) fMaxT = fT1;
+			if(fMinT > fMaxT) return false;
+		}
+
+		*apEntryT = fMinT;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cTriangleBVH::cTriangleBVH()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	cTriangleBVH::~cTriangleBVH()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::Build(const unsigned int* apIndexArray, int alIndexNum, const float* apVertexArray, int alVtxStride)
+	{
+		Clear();
+
+		int lTriNum = alIndexNum / 3;
+		if(lTriNum <= 0 || apIndexArray==NULL || apVertexArray==NULL) return;
+
+		////////////////////////////
+		// Gather positions and centroids
+		mvTriVertices.resize(lTriNum*3);
+		std::vector<cVector3f> vCentroids(lTriNum);
+		std::vector<int> vOrder(lTriNum);
+
+		for(int tri=0; tri<lTriNum; ++tri)
+		{
+			for(int i=0; i<3; ++i)
+			{
+				const float *pVtx = &apVertexArray[apIndexArray[tri*3 + i]*alVtxStride];
+				mvTriVertices[tri*3 + i] = cVector3f(pVtx[0], pVtx[1], pVtx[2]);
+			}
+			vCentroids[tri] = (mvTriVertices[tri*3] + mvTriVertices[tri*3+1] + mvTriVertices[tri*3+2]) * (1.0f/3.0f);
+			vOrder[tri] = tri;
+		}
+
+		////////////////////////////
+		// Build hierarchy, this sorts the order vector
+		mvNodes.reserve(lTriNum*2/glTriangleBVHMaxLeafSize + 1);
+		mvNodes.push_back(cTriangleBVHNode());
+		BuildNode(0, 0, lTriNum, vOrder, vCentroids);
+
+		////////////////////////////
+		// Store triangles in leaf order
+		std::vector<cVector3f> vVertices;
+		vVertices.swap(mvTriVertices);
+
+		mvTriVertices.resize(lTriNum*3);
+		mvTriIndices.resize(lTriNum);
+		for(int i=0; i<lTriNum; ++i)
+		{
+			int lTri = vOrder[i];
+			mvTriVertices[i*3]		= vVertices[lTri*3];
+			mvTriVertices[i*3 + 1]	= vVertices[lTri*3 + 1];
+			mvTriVertices[i*3 + 2]	= vVertices[lTri*3 + 2];
+			mvTriIndices[i] = lTri*3;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::Clear()
+	{
+		mvNodes.clear();
+		mvTriVertices.clear();
+		mvTriIndices.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cTriangleBVH::CheckLineIntersection(	const cVector3f& avLineStart, const cVector3f& avLineEnd, 
+												cTriangleBVHHit *apHit, bool abSkipBackfacing) const
+	{
+		if(mvNodes.empty()) return false;
+
+		cVector3f vLineDelta = avLineEnd - avLineStart;
+		cVector3f vInvDelta(1.0f / vLineDelta.x, 1.0f / vLineDelta.y, 1.0f / vLineDelta.z);
+
+		float fMinT = 1.0f;
+		int lHitTri = -1;
+		float fHitU=0, fHitV=0;
+
+		int vStack[glTriangleBVHMaxStackSize];
+		int lStackSize = 0;
+		vStack[lStackSize++] = 0;
+
+		while(lStackSize > 0)
+		{
+			const cTriangleBVHNode& node = mvNodes[vStack[--lStackSize]];
+
+			float fEntryT;
+			if(LineIntersectsBox(avLineStart, vInvDelta, fMinT, node.mvMin, node.mvMax, &fEntryT)==false) continue;
+
+			////////////////////////////
+			// Inner node, visit the child closest to the line start first
+			if(node.mlCount == 0)
+			{
+				int lNear = node.mlFirst;
+				int lFar = node.mlFirst+1;
+				if(vLineDelta.v[node.mlSplitAxis] < 0) std::swap(lNear, lFar);
+
+				vStack[lStackSize++] = lFar;
+				vStack[lStackSize++] = lNear;
+				continue;
+			}
+
+			////////////////////////////
+			// Leaf, test triangles
+			for(int tri = node.mlFirst; tri < node.mlFirst + node.mlCount; ++tri)
+			{
+				const cVector3f& vP0 = mvTriVertices[tri*3];
+				cVector3f vEdge1 = mvTriVertices[tri*3 + 1] - vP0;
+				cVector3f vEdge2 = mvTriVertices[tri*3 + 2] - vP0;
+
+				if(abSkipBackfacing)
+				{
+					cVector3f vNormal = cMath::Vector3Cross(vEdge1, vEdge2);
+					if(cMath::Vector3Dot(vNormal, vLineDelta) < 0) continue;
+				}
+
+				cVector3f vDCrossE = cMath::Vector3Cross(vLineDelta, vEdge2);
+				float fEDotN = cMath::Vector3Dot(vEdge1, vDCrossE);
+				if(fabs(fEDotN) < 0.00001f) continue; //Line is parallel
+
+				float fF = 1.0f / fEDotN;
+				cVector3f vTriToStart = avLineStart - vP0;
+
+				float fU = fF * cMath::Vector3Dot(vTriToStart, vDCrossE);
+				if(fU < 0.0f || fU > 1.0f) continue;
+
+				cVector3f vQ = cMath::Vector3Cross(vTriToStart,vEdge1);
+				float fV = fF * cMath::Vector3Dot(vLineDelta, vQ);
+				if(fV < 0.0f || fU + fV > 1.0f) continue;
+
+				float fT = fF * cMath::Vector3Dot(vEdge2, vQ);
+				if(fT < 0 || fT > fMinT) continue;
+
+				//Equal distance picks the lowest index, same as a linear search would
+				if(fT == fMinT && lHitTri >= 0 && mvTriIndices[tri] > lHitTri) continue;
+
+				fMinT = fT;
+				lHitTri = mvTriIndices[tri];
+				fHitU = fU;
+				fHitV = fV;
+			}
+		}
+
+		if(lHitTri < 0) return false;
+
+		if(apHit)
+		{
+			apHit->mfT = fMinT;
+			apHit->mlTriIndex = lHitTri;
+			apHit->mvBarycentric = cVector2f(fHitU, fHitV);
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::FindTrianglesInBox(const cVector3f& avMin, const cVector3f& avMax, std::vector<int>& avTriIndices) const
+	{
+		if(mvNodes.empty()) return;
+
+		int vStack[glTriangleBVHMaxStackSize];
+		int lStackSize = 0;
+		vStack[lStackSize++] = 0;
+
+		while(lStackSize > 0)
+		{
+			const cTriangleBVHNode& node = mvNodes[vStack[--lStackSize]];
+
+			if(cMath::CheckAABBIntersection(node.mvMin, node.mvMax, avMin, avMax)==false) continue;
+
+			if(node.mlCount == 0)
+			{
+				vStack[lStackSize++] = node.mlFirst;
+				vStack[lStackSize++] = node.mlFirst+1;
+				continue;
+			}
+
+			for(int tri = node.mlFirst; tri < node.mlFirst + node.mlCount; ++tri)
+			{
+				const cVector3f *pVtx = &mvTriVertices[tri*3];
+				cVector3f vTriMin = cMath::Vector3Min(cMath::Vector3Min(pVtx[0], pVtx[1]), pVtx[2]);
+				cVector3f vTriMax = cMath::Vector3Max(cMath::Vector3Max(pVtx[0], pVtx[1]), pVtx[2]);
+				
+				if(cMath::CheckAABBIntersection(vTriMin, vTriMax, avMin, avMax))
+					avTriIndices.push_back(mvTriIndices[tri]);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::BuildNode(int alNodeIdx, int alStart, int alEnd, std::vector<int>& avOrder, const std::vector<cVector3f>& avCentroids)
+	{
+		////////////////////////////
+		// Bounds of triangles and centroids
+		cVector3f vMin(100000000.0f), vMax(-100000000.0f);
+		cVector3f vCentMin(100000000.0f), vCentMax(-100000000.0f);
+		
+		for(int i=alStart; i<alEnd; ++i)
+		{
+			int lTri = avOrder[i];
+			for(int j=0; j<3; ++j)
+			{
+				const cVector3f& vP = mvTriVertices[lTri*3 + j];
+				vMin = cMath::Vector3Min(vMin, vP);
+				vMax = cMath::Vector3Max(vMax, vP);
+			}
+			vCentMin = cMath::Vector3Min(vCentMin, avCentroids[lTri]);
+			vCentMax = cMath::Vector3Max(vCentMax, avCentroids[lTri]);
+		}
+
+		mvNodes[alNodeIdx].mvMin = vMin;
+		mvNodes[alNodeIdx].mvMax = vMax;
+
+		////////////////////////////
+		// Leaf
+		int lCount = alEnd - alStart;
+		cVector3f vCentSize = vCentMax - vCentMin;
+		int lAxis = 0;
+		if(vCentSize.y > vCentSize.v[lAxis]) lAxis = 1;
+		if(vCentSize.z > vCentSize.v[lAxis]) lAxis = 2;
+
+		if(lCount <= glTriangleBVHMaxLeafSize || vCentSize.v[lAxis] <= 0)
+		{
+			mvNodes[alNodeIdx].mlFirst = alStart;
+			mvNodes[alNodeIdx].mlCount = lCount;
+			mvNodes[alNodeIdx].mlSplitAxis = 0;
+			return;
+		}
+
+		////////////////////////////
+		// Median split along the longest centroid axis
+		int lMid = alStart + lCount/2;
+		std::nth_element(avOrder.begin()+alStart, avOrder.begin()+lMid, avOrder.begin()+alEnd, 
+						cTriangleBVHCentroidCompare(&avCentroids, lAxis));
+
+		//Children are stored next to each other
+		int lFirstChild = (int)mvNodes.size();
+		mvNodes.push_back(cTriangleBVHNode());
+		mvNodes.push_back(cTriangleBVHNode());
+		mvNodes[alNodeIdx].mlFirst = lFirstChild;
+		mvNodes[alNodeIdx].mlCount = 0;
+		mvNodes[alNodeIdx].mlSplitAxis = lAxis;
+
+		BuildNode(lFirstChild, alStart, lMid, avOrder, avCentroids);
+		BuildNode(lFirstChild+1, lMid, alEnd, avOrder, avCentroids);
+	}
+
+	//-----------------------------------------------------------------------
+}
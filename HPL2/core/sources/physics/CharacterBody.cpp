@@ -127,6 +127,13 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 
 	void cCharacterBodyCollidePush::OnCollision(iPhysicsBody *apBody, cCollideData *apCollideData)
+	{
+		OnCollisionAtPosition(apBody, apCollideData, mpCharBody->GetPosition());
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cCharacterBodyCollidePush::OnCollisionAtPosition(iPhysicsBody *apBody, cCollideData *apCollideData, const cVector3f& avCharPosition)
 	{
 		///////////////////////////////////
 		//Check what bodies not to push.
@@ -143,7 +150,7 @@ namespace hpl {
 
 			float fHitTop = pHitCharBody->GetPosition().y + pHitCharBody->GetSize().y/2;
 			//Make bottom 10% of size longer up to remove uneeded pushing.
-			float fBottom = mpCharBody->GetPosition().y - (mpCharBody->GetSize().y/2 - mpCharBody->GetSize().y*0.1f);
+			float fBottom = avCharPosition.y - (mpCharBody->GetSize().y/2 - mpCharBody->GetSize().y*0.1f);
 
 			//Log("Top: %f Bottom: %f. HitSize: %f Size: %f. HitPos: %f Pos: %f\n",fHitTop, fBottom,pHitCharBody->GetSize().y,mpCharBody->GetSize().y,
 			//																		pHitCharBody->GetPosition().y,mpCharBody->GetPosition().y);
@@ -151,7 +158,7 @@ namespace hpl {
 			//If body is on top of hitbody, skip doing a push.
 			if(fHitTop < fBottom) return;
 
-			cVector3f vDir = pHitCharBody->GetPosition() - mpCharBody->GetPosition();
+			cVector3f vDir = pHitCharBody->GetPosition() - avCharPosition;
 			if(mpCharBody->GetCharacterPushIn2D()) vDir.y =0; 
 			vDir.Normalize();
 
@@ -176,20 +183,20 @@ namespace hpl {
 			vMedianPoint = vMedianPoint / fNumPoints;
 
 			//If median is below (or almost below the player), skip push
-			float fMinY = mpCharBody->GetFeetPosition().y;
+			float fMinY = avCharPosition.y - mpCharBody->GetSize().y/2;
 			fMinY += 0.01f;
 			if(vMedianPoint.y  <  fMinY) return;
 			
 			if(mpCharBody->GetPushIn2D())
 			{
-				cVector3f vDir = vMedianPoint - mpCharBody->GetPosition();
+				cVector3f vDir = vMedianPoint - avCharPosition;
 				vDir.y =0; vDir.Normalize();
 			
 				apBody->AddForceAtPosition(vDir * mpCharBody->GetPushForce(), vMedianPoint);
 			}
 			else
 			{
-				cVector3f vDir = cMath::Vector3Normalize(vMedianPoint - mpCharBody->GetPosition());
+				cVector3f vDir = cMath::Vector3Normalize(vMedianPoint - avCharPosition);
 
 				apBody->AddForceAtPosition(vDir * mpCharBody->GetPushForce(), vMedianPoint);
 			}
@@ -198,6 +205,36 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// COLLIDE DEFER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cCharacterBodyCollideDefer::cCharacterBodyCollideDefer(iCharacterBody *apCharBody)
+	{
+		mpCharBody = apCharBody;
+		mpCallback = NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cCharacterBodyCollideDefer::OnCollision(iPhysicsBody *apBody, cCollideData *apCollideData)
+	{
+		mpCharBody->mvDeferredCallbacks.push_back(cCharacterBodyDeferredCallback());
+		cCharacterBodyDeferredCallback &deferred = mpCharBody->mvDeferredCallbacks.back();
+
+		//Save the contacts and where the character was, the callback is called once the character has moved on.
+		deferred.mpCollideCallback = mpCallback;
+		deferred.mpBody = apBody;
+		deferred.mCollideData.mlNumOfPoints = apCollideData->mlNumOfPoints;
+		deferred.mCollideData.mvContactPoints.assign(	apCollideData->mvContactPoints.begin(), 
+														apCollideData->mvContactPoints.begin() + apCollideData->mlNumOfPoints);
+		deferred.mvCharPosition = mpCharBody->GetPosition();
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// RAY CAST
 	//////////////////////////////////////////////////////////////////////////
@@ -287,6 +324,10 @@ namespace hpl {
 		mpCollideGravityCallback = hplNew( cCharacterBodyCollideGravity, (this) );
 		mpCollidePushCallback = hplNew( cCharacterBodyCollidePush, (this) );
 		mpRayCallback = hplNew( cCharacterBodyRay, () );
+		mpCollideDeferCallback = hplNew( cCharacterBodyCollideDefer, (this) );
+
+		mlQueryThreadIndex = 0;
+		mbDeferCallbacks = false;
 
 		/////////////////////////////
 		//Set up properties
@@ -418,6 +459,7 @@ namespace hpl {
 		hplDelete(mpCollideGravityCallback);
 		hplDelete(mpCollidePushCallback);
 		hplDelete(mpRayCallback);
+		hplDelete(mpCollideDeferCallback);
 	}
 
 	//-----------------------------------------------------------------------
@@ -949,6 +991,17 @@ namespace hpl {
 	{
 		if(mbActive == false) return;
 
+		PreUpdate(afTimeStep);
+		ResolveCollisions(afTimeStep, 0, false);
+		PostUpdate(afTimeStep);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iCharacterBody::PreUpdate(float afTimeStep)
+	{
+		if(mbActive == false) return;
+
 		/////////////////////////
 		// Move delay
 		if(mfMoveDelayCount>0)
@@ -958,7 +1011,6 @@ namespace hpl {
 
 		//////////////////////////
 		//Init
-		PreUpdateConnection(afTimeStep);
 		ClearGravityAttachment();
 
 		//////////////////////////
@@ -985,17 +1037,30 @@ namespace hpl {
 		AlignPosAddAccordingToGroundNormal(vPosAdd);
 
 		mvLastMovePosAdd = vPosAdd;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iCharacterBody::ResolveCollisions(float afTimeStep, int alThreadIndex, bool abDeferCallbacks)
+	{
+		if(mbActive == false) return;
+
+		mlQueryThreadIndex = alThreadIndex;
+		mbDeferCallbacks = abDeferCallbacks;
+
+		//Changes the connected body, so only done when not deferring (such bodies are never resolved in parallel).
+		if(abDeferCallbacks==false) PreUpdateConnection(afTimeStep);
 
 		//////////////////////////
 		//Check for collision.
 		if(mbTestCollision)
 		{
 			//XZ
-			CheckMoveCollision(vPosAdd, afTimeStep);
+			CheckMoveCollision(mvLastMovePosAdd, afTimeStep);
 		}
 		else
 		{
-			mvPosition += vPosAdd;
+			mvPosition += mvLastMovePosAdd;
 		}
 
 		//////////////////////////
@@ -1006,6 +1071,22 @@ namespace hpl {
 			CheckForceCollision(afTimeStep);
 
 		UpdateFriction(afTimeStep);
+
+		mlQueryThreadIndex = 0;
+		mbDeferCallbacks = false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iCharacterBody::PostUpdate(float afTimeStep)
+	{
+		if(mbActive == false)
+		{
+			mvDeferredCallbacks.clear();
+			return;
+		}
+
+		RunDeferredCallbacks();
 		
 		//////////////////////////////
 		//Final updates
@@ -1025,7 +1106,33 @@ namespace hpl {
 
 		PostUpdateConnection(afTimeStep);
 	}
-	
+
+	//-----------------------------------------------------------------------
+
+	void iCharacterBody::GetResolveBounds(float afTimeStep, cVector3f &avMin, cVector3f &avMax)
+	{
+		cBoundingVolume *pBV = mpCurrentBody->GetBoundingVolume();
+		avMin = pBV->GetMin();
+		avMax = pBV->GetMax();
+
+		///////////////////////////
+		// The longest the body can move during the step, including step climbing rays in front of it.
+		float fGravity = mbCustomGravity ? mvCustomGravity.Length() : mpWorld->GetGravity().Length();
+		float fSpeed =	mvVelocity.Length() + mvGravityAttachmentVelocity.Length() + 
+						(fGravity + mvForce.Length() / mfMass) * afTimeStep;
+		
+		float fExpand = mvLastMovePosAdd.Length() + fSpeed * afTimeStep + mpCurrentShape->GetRadius() + 
+						mfStepClimbSpeed * afTimeStep + 0.1f;
+		
+		avMin -= cVector3f(fExpand);
+		avMax += cVector3f(fExpand);
+
+		///////////////////////////
+		// Ground normal ray and step climbing check
+		avMin.y -= mvSize.x*2.0001f;
+		avMax.y += cMath::Max(mfMaxStepHeight, mfMaxStepHeightInAir) + mfClimbHeightAdd;
+	}
+
 	//-----------------------------------------------------------------------
 
 	void iCharacterBody::SetCamera(cCamera *apCam)
@@ -1828,7 +1935,20 @@ namespace hpl {
 			// Check if there was any collision
 			if(bCollide && cMath::Vector3Abs(vPushBack) != cVector3f(0))
 			{
-				if(mpCallback) mpCallback->OnHitGround(this, mvVelocity);
+				if(mpCallback)
+				{
+					if(mbDeferCallbacks)
+					{
+						mvDeferredCallbacks.push_back(cCharacterBodyDeferredCallback());
+						mvDeferredCallbacks.back().mpCollideCallback = NULL;
+						mvDeferredCallbacks.back().mpBody = NULL;
+						mvDeferredCallbacks.back().mvHitGroundVelocity = mvVelocity;
+					}
+					else
+					{
+						mpCallback->OnHitGround(this, mvVelocity);
+					}
+				}
 
 				//Set groundnormal, and make sure it is not too steep!
 				mvLastGroundNormal = cMath::Vector3Normalize(vPushBack);
@@ -2269,10 +2389,36 @@ namespace hpl {
 		if(alShapeIdx <0) alShapeIdx = mlCurrentShapeIdx;
 		iCollideShape *pShape = mvShapes[alShapeIdx];
 
+		//If resolving in parallel, save the collisions and call the callback later.
+		if(mbDeferCallbacks && apCallback)
+		{
+			mpCollideDeferCallback->mpCallback = apCallback;
+			apCallback = mpCollideDeferCallback;
+		}
+
 		return mpWorld->CheckShapeWorldCollision(apPushBackVector, pShape, cMath::MatrixTranslate(avPos),
 												mpCurrentBody, false, true, 
 												apCallback, true,mlMinBodyPushStrength, 
-												mlCollideFlags, false);
+												mlCollideFlags, false, mlQueryThreadIndex);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iCharacterBody::RunDeferredCallbacks()
+	{
+		//Run in the order they were saved, giving the same order as a non parallel update.
+		for(size_t i=0; i<mvDeferredCallbacks.size(); ++i)
+		{
+			cCharacterBodyDeferredCallback &deferred = mvDeferredCallbacks[i];
+
+			if(deferred.mpCollideCallback == mpCollidePushCallback)
+				mpCollidePushCallback->OnCollisionAtPosition(deferred.mpBody, &deferred.mCollideData, deferred.mvCharPosition);
+			else if(deferred.mpCollideCallback)
+				deferred.mpCollideCallback->OnCollision(deferred.mpBody, &deferred.mCollideData);
+			else if(mpCallback)
+				mpCallback->OnHitGround(this, deferred.mvHitGroundVelocity);
+		}
+		mvDeferredCallbacks.clear();
 	}
 	
 	//-----------------------------------------------------------------------
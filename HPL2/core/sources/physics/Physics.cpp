@@ -23,6 +23,7 @@
 #include "physics/PhysicsWorld.h"
 #include "physics/SurfaceData.h"
 #include "system/LowLevelSystem.h"
+#include "system/System.h"
 #include "system/String.h"
 
 #include "haptic/Haptic.h"
@@ -42,6 +43,8 @@ namespace hpl {
 	cPhysics::cPhysics(iLowLevelPhysics *apLowLevelPhysics)  : iUpdateable("HPL_Physics")
 	{
 		mpLowLevelPhysics = apLowLevelPhysics;
+		mpResources = NULL;
+		mpSystem = NULL;
 
 		mlMaxImpacts = 6;
 		mfImpactDuration = 0.4f;
@@ -70,9 +73,10 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void cPhysics::Init(cResources *apResources)
+	void cPhysics::Init(cResources *apResources, cSystem *apSystem)
 	{
 		mpResources = apResources;
+		mpSystem = apSystem;
 	}
 
 	//-----------------------------------------------------------------------
@@ -89,6 +93,8 @@ namespace hpl {
 		iPhysicsWorld * pWorld = mpLowLevelPhysics->CreateWorld();
 		mlstWorlds.push_back(pWorld);
 
+		if(mpSystem) pWorld->SetJobManager(mpSystem->GetJobManager());
+
 		if(abAddSurfaceData)
 		{
 			tSurfaceDataMapIt it = m_mapSurfaceData.begin();
@@ -33,10 +33,49 @@
 #include "graphics/LowLevelGraphics.h"
 #include "scene/World.h"
 #include "system/Platform.h"
+#include "system/JobManager.h"
 #include "scene/SoundEntity.h"
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// CHARACTER RESOLVE JOB
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	class cCharacterBodyResolveJob : public iJob
+	{
+	public:
+		cCharacterBodyResolveJob(iPhysicsWorld *apWorld, int alQueryThread) : mpWorld(apWorld), mlQueryThread(alQueryThread) {}
+
+		void Execute(int alThreadIndex)
+		{
+			mpWorld->ResolveCharacterBodiesForThread(mlQueryThread);
+		}
+
+	private:
+		iPhysicsWorld *mpWorld;
+		int mlQueryThread;
+	};
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// SHAPE CACHE KEY
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cCollideShapeCacheKey::AddShape(eCollideShapeType aType, const cVector3f& avSize, const cMatrixf& a_mtxOffset)
+	{
+		mvData.push_back((float)aType);
+		for(int i=0; i<3; ++i) mvData.push_back(avSize.v[i]);
+		for(int i=0; i<16; ++i) mvData.push_back(a_mtxOffset.v[i]);
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -46,13 +85,22 @@ namespace hpl {
 	iPhysicsWorld::iPhysicsWorld()
 	{
 		mbLogDebug = false;
+
+		mpJobManager = NULL;
+		mbParallelCharacterUpdate = true;
+		mfCharacterResolveTimeStep = 0;
+		mlCharacterResolveThreads = 0;
+
+		mvTempBodies.resize(1);
+
+		mbShapeCacheActive = true;
 	}
 
 	//-----------------------------------------------------------------------
 
 	iPhysicsWorld::~iPhysicsWorld()
 	{
-		
+		STLDeleteAll(mvCharacterResolveJobs);
 	}
 
 	//-----------------------------------------------------------------------
@@ -89,12 +137,7 @@ namespace hpl {
 		////////////////////////////////////
 		//Update character bodies
 		START_TIMING(PhysicsCharacters)		
-		for(tCharacterBodyListIt CharIt = mlstCharBodies.begin(); CharIt != mlstCharBodies.end(); ++CharIt)
-		{
-			iCharacterBody *pBody = *CharIt;
-
-			pBody->Update(afTimeStep);
-		}
+		UpdateCharacterBodies(afTimeStep);
 		STOP_TIMING(PhysicsCharacters)
 
 		
@@ -182,10 +225,37 @@ namespace hpl {
 		apShape->DecUserCount();
 		if(apShape->HasUsers()==false)
 		{
+			//Remove from cache so an equal key does not get a deleted shape
+			for(tCollideShapeCacheMapIt it = m_mapCachedShapes.begin(); it != m_mapCachedShapes.end(); ++it)
+			{
+				if(it->second != apShape) continue;
+				m_mapCachedShapes.erase(it);
+				break;
+			}
+
 			STLFindAndDelete(mlstShapes, apShape);
 		}
 	}
 
+	//-----------------------------------------------------------------------
+
+	iCollideShape* iPhysicsWorld::GetCachedShape(const cCollideShapeCacheKey& aKey)
+	{
+		if(mbShapeCacheActive==false || aKey.IsEmpty()) return NULL;
+
+		tCollideShapeCacheMapIt it = m_mapCachedShapes.find(aKey);
+		if(it == m_mapCachedShapes.end()) return NULL;
+
+		return it->second;
+	}
+
+	void iPhysicsWorld::AddCachedShape(const cCollideShapeCacheKey& aKey, iCollideShape *apShape)
+	{
+		if(mbShapeCacheActive==false || aKey.IsEmpty() || apShape==NULL) return;
+
+		m_mapCachedShapes[aKey] = apShape;
+	}
+
 	//-----------------------------------------------------------------------
 	
 	void iPhysicsWorld::DestroyBody(iPhysicsBody* apBody)
@@ -218,14 +288,29 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void iPhysicsWorld::UpdateBodyBoundingVolumes()
+	{
+		if(mlstBodies.empty()) return;
+
+		mvTempBoundingVolumes.resize(0);
+		for(tPhysicsBodyListIt it = mlstBodies.begin(); it != mlstBodies.end(); ++it)
+		{
+			mvTempBoundingVolumes.push_back((*it)->GetBoundingVolume());
+		}
+		cBoundingVolume::UpdateSizes(&mvTempBoundingVolumes[0], mvTempBoundingVolumes.size());
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iPhysicsWorld::EnableBodiesInBV(cBoundingVolume *apBV, bool abEnabled)
 	{
-		mvTempBodies.resize(0);
-        GetBodiesInBV(apBV, &mvTempBodies);
+		std::vector<iPhysicsBody*> &vTempBodies = mvTempBodies[0];
+		vTempBodies.resize(0);
+        GetBodiesInBV(apBV, &vTempBodies);
 
-		for(size_t i=0; i<mvTempBodies.size(); ++i)
+		for(size_t i=0; i<vTempBodies.size(); ++i)
 		{
-			iPhysicsBody *pBody = mvTempBodies[i];
+			iPhysicsBody *pBody = vTempBodies[i];
 			
 			if(pBody->GetMass() > 0 && cMath::CheckBVIntersection(*apBV,*pBody->GetBoundingVolume()))
 			{
@@ -363,6 +448,7 @@ namespace hpl {
 
 		STLDeleteAll(mlstRopes);
 
+		m_mapCachedShapes.clear();
 		STLDeleteAll(mlstShapes);
 		STLDeleteAll(mlstJoints);
 		STLDeleteAll(mlstControllers);
@@ -436,7 +522,7 @@ namespace hpl {
 							bool abCollideCharacter,
 							int alMinPushStrength,
 							tFlag alCollideFlags,
-							bool abDebug)
+							bool abDebug, int alThreadIndex)
 	{
 		cCollideData collideData;
 
@@ -454,12 +540,13 @@ namespace hpl {
 		int lBefore =0;
 		int lAfter =0;
 		
-		mvTempBodies.resize(0);
-		GetBodiesInBV(&boundingVolume, &mvTempBodies);
+		std::vector<iPhysicsBody*> &vTempBodies = mvTempBodies[alThreadIndex];
+		vTempBodies.resize(0);
+		GetBodiesInBV(&boundingVolume, &vTempBodies);
 		
-		for(size_t i=0; i<mvTempBodies.size(); ++i)
+		for(size_t i=0; i<vTempBodies.size(); ++i)
 		{
-			iPhysicsBody *pBody = mvTempBodies[i];
+			iPhysicsBody *pBody = vTempBodies[i];
 			
 			if(pBody->IsActive()==false)continue;
 			if(pBody->IsCharacter() && abCollideCharacter==false) continue;
@@ -479,7 +566,7 @@ namespace hpl {
 			
 		   	collideData.SetMaxSize(32);
 			bool bRet = CheckShapeCollision(apShape,a_mtxTransform, pBody->GetShape(),pBody->GetLocalMatrix(),
-											collideData, 32, true);
+											collideData, 32, true, alThreadIndex);
 
 			if(bRet && apPushVector)
 			{
@@ -507,4 +594,134 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void iPhysicsWorld::ResolveCharacterBodiesForThread(int alThreadIndex)
+	{
+		for(size_t i=alThreadIndex; i<mvParallelCharBodies.size(); i+=mlCharacterResolveThreads)
+		{
+			mvParallelCharBodies[i]->ResolveCollisions(mfCharacterResolveTimeStep, alThreadIndex, true);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PROTECTED METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void iPhysicsWorld::UpdateCharacterBodies(float afTimeStep)
+	{
+		int lThreads = 1;
+		if(mpJobManager && mbParallelCharacterUpdate && mlstCharBodies.size() > 1)
+		{
+			lThreads = cMath::Min(mpJobManager->GetNumOfThreads(), GetMaxQueryThreads());
+		}
+
+		////////////////////////////////
+		// No threading, update in order
+		if(lThreads < 2)
+		{
+			for(tCharacterBodyListIt CharIt = mlstCharBodies.begin(); CharIt != mlstCharBodies.end(); ++CharIt)
+			{
+				iCharacterBody *pBody = *CharIt;
+
+				pBody->Update(afTimeStep);
+			}
+			return;
+		}
+
+		////////////////////////////////
+		// Pre update, only changes the body itself. 
+		// Note that this means the update order is not the same as when not using threads, see SetParallelCharacterUpdate.
+		mvSerialCharBodies.resize(0);
+		mvParallelCharBodies.resize(0);
+		mvCharBodySweptMin.resize(0);
+		mvCharBodySweptMax.resize(0);
+
+		std::vector<iCharacterBody*> vActiveBodies;
+		vActiveBodies.reserve(mlstCharBodies.size());
+		for(tCharacterBodyListIt CharIt = mlstCharBodies.begin(); CharIt != mlstCharBodies.end(); ++CharIt)
+		{
+			iCharacterBody *pBody = *CharIt;
+			if(pBody->IsActive()==false) continue;
+
+			pBody->PreUpdate(afTimeStep);
+			vActiveBodies.push_back(pBody);
+		}
+
+		////////////////////////////////
+		// Make sure all bounding volumes are updated, so the resolve threads only read them.
+		UpdateBodyBoundingVolumes();
+
+		for(size_t i=0; i<vActiveBodies.size(); ++i)
+		{
+			cVector3f vMin, vMax;
+			vActiveBodies[i]->GetResolveBounds(afTimeStep, vMin, vMax);
+			mvCharBodySweptMin.push_back(vMin);
+			mvCharBodySweptMax.push_back(vMax);
+		}
+
+		////////////////////////////////
+		// Bodies that might touch each other must be resolved in order, the rest can be done in parallel.
+		for(size_t i=0; i<vActiveBodies.size(); ++i)
+		{
+			bool bOverlaps = false;
+			for(size_t j=0; j<vActiveBodies.size(); ++j)
+			{
+				if(i==j) continue;
+				if(cMath::CheckAABBIntersection(mvCharBodySweptMin[i], mvCharBodySweptMax[i],
+												mvCharBodySweptMin[j], mvCharBodySweptMax[j]))
+				{
+					bOverlaps = true;
+					break;
+				}
+			}
+
+			//Turning off the connected body changes the world, so must be done in order.
+			if(vActiveBodies[i]->GetDisablesConnectedBody()) bOverlaps = true;
+
+			if(bOverlaps)	mvSerialCharBodies.push_back(vActiveBodies[i]);
+			else			mvParallelCharBodies.push_back(vActiveBodies[i]);
+		}
+
+		////////////////////////////////
+		// Resolve in parallel
+		if(mvParallelCharBodies.size() > 1)
+		{
+			mlCharacterResolveThreads = cMath::Min(lThreads, (int)mvParallelCharBodies.size());
+			mfCharacterResolveTimeStep = afTimeStep;
+
+			if((int)mvTempBodies.size() < mlCharacterResolveThreads)
+				mvTempBodies.resize(mlCharacterResolveThreads);
+			while((int)mvCharacterResolveJobs.size() < mlCharacterResolveThreads)
+				mvCharacterResolveJobs.push_back(hplNew( cCharacterBodyResolveJob, (this, (int)mvCharacterResolveJobs.size()) ));
+
+			cJobCounter counter;
+			for(int i=0; i<mlCharacterResolveThreads; ++i)
+				mpJobManager->AddJob(mvCharacterResolveJobs[i], &counter);
+			mpJobManager->WaitForCounter(&counter, kJobThreadIndex_Main);
+		}
+		else
+		{
+			for(size_t i=0; i<mvParallelCharBodies.size(); ++i)
+				mvParallelCharBodies[i]->ResolveCollisions(afTimeStep, 0, true);
+		}
+
+		for(size_t i=0; i<mvParallelCharBodies.size(); ++i)
+		{
+			mvParallelCharBodies[i]->PostUpdate(afTimeStep);
+		}
+
+		////////////////////////////////
+		// Resolve the rest in order
+		for(size_t i=0; i<mvSerialCharBodies.size(); ++i)
+		{
+			mvSerialCharBodies[i]->ResolveCollisions(afTimeStep, 0, false);
+			mvSerialCharBodies[i]->PostUpdate(afTimeStep);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 }
@@ -25,6 +25,9 @@
 #include <cstring>
 
 #include "math/CRC.h"
+#include "system/JobManager.h"
+
+#include <algorithm>
 
 // Include SDL Endian code
 #ifdef USE_SDL2
@@ -61,6 +64,135 @@ inline static float UnSwabFloat32(int i) {
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// BLOCK COMPRESSION
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Block compressed data layout (all ints little endian):
+	 *  "HPLZ"	(can never be the start of a zlib stream, since the header check fails)
+	 *  int		version
+	 *  int		uncompressed block size
+	 *  int		number of blocks
+	 *  int		total uncompressed size
+	 *  For each block: int offset (from end of block table), int compressed size, int crc32 of uncompressed data.
+	 *  The blocks, each is a complete zlib stream.
+	 */
+	static const char gvBlockCompressMagic[4] = {'H','P','L','Z'};
+	static const int glBlockCompressVersion = 1;
+	static const size_t glBlockCompressHeaderSize = 20;
+	static const size_t glBlockCompressEntrySize = 12;
+	static const size_t glBlockCompressBlockSize = 256*1024;
+
+	cJobManager* cBinaryBuffer::mpJobManager = NULL;
+	bool cBinaryBuffer::mbUseBlockCompression = true;
+
+	//-----------------------------------------------------------------------
+
+	static inline int ReadBlockInt32(const char *apData, size_t alIdx)
+	{
+		int lX;
+		memcpy(&lX, apData + alIdx*4, 4);
+		return SDL_SwapLE32(lX);
+	}
+
+	//-----------------------------------------------------------------------
+
+	class cBlockCompressJob : public iJob
+	{
+	public:
+		void Execute(int alThreadIndex)
+		{
+			if(mbCompress)
+			{
+				uLongf lDestSize = compressBound((uLong)mlSrcSize);
+				mvCompressed.resize(lDestSize);
+				mbOk = compress2((Bytef*)&mvCompressed[0], &lDestSize, (const Bytef*)mpSrc, (uLong)mlSrcSize, mlLevel) == Z_OK;
+				mvCompressed.resize(lDestSize);
+				mlCRC = crc32(0, (const Bytef*)mpSrc, (uInt)mlSrcSize);
+			}
+			else
+			{
+				uLongf lDestSize = (uLongf)mlDestSize;
+				mbOk =	uncompress((Bytef*)mpDest, &lDestSize, (const Bytef*)mpSrc, (uLong)mlSrcSize) == Z_OK &&
+						lDestSize == (uLongf)mlDestSize &&
+						crc32(0, (const Bytef*)mpDest, (uInt)mlDestSize) == mlCRC;
+			}
+		}
+
+		bool mbCompress;
+		int mlLevel;
+		const char *mpSrc;
+		size_t mlSrcSize;
+		char *mpDest;
+		size_t mlDestSize;
+		std::vector<char> mvCompressed;
+		unsigned int mlCRC;
+		bool mbOk;
+	};
+
+	//-----------------------------------------------------------------------
+
+	static void RunBlockCompressJobs(std::vector<cBlockCompressJob> &avJobs, cJobManager *apJobManager)
+	{
+		if(apJobManager==NULL || apJobManager->GetNumOfWorkers()==0 || avJobs.size() < 2)
+		{
+			for(size_t i=0; i<avJobs.size(); ++i) avJobs[i].Execute(kJobThreadIndex_None);
+			return;
+		}
+
+		//Buffers are used from the save and loader threads too, so only wait and let the workers do the jobs.
+		cJobCounter counter;
+		for(size_t i=0; i<avJobs.size(); ++i)
+			apJobManager->AddJob(&avJobs[i], &counter);
+		apJobManager->WaitForCounter(&counter, kJobThreadIndex_None);
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Gets the sizes from the header of block compressed data and checks that they fit together.
+	 */
+	static bool GetBlockCompressSizes(const char *apSrcData, int alBlockNum, size_t *apBlockSize, size_t *apTotalSize)
+	{
+		int lBlockSize = ReadBlockInt32(apSrcData, 2);
+		int lTotalSize = ReadBlockInt32(apSrcData, 4);
+		if(lBlockSize <= 0 || (size_t)lBlockSize > glBlockCompressBlockSize || lTotalSize < 0) return false;
+		if(((size_t)lTotalSize + lBlockSize-1) / lBlockSize != (size_t)alBlockNum) return false;
+
+		*apBlockSize = (size_t)lBlockSize;
+		*apTotalSize = (size_t)lTotalSize;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Sets up a job decompressing a block from the block table. The destination is not set.
+	 */
+	static bool SetupBlockDecompressJob(cBlockCompressJob &aJob, const char *apSrcData, size_t alSize, int alBlockNum, int alBlock,
+										size_t alBlockSize, size_t alTotalSize)
+	{
+		const char *pEntry = apSrcData + glBlockCompressHeaderSize + alBlock*glBlockCompressEntrySize;
+		size_t lDataStart = glBlockCompressHeaderSize + alBlockNum*glBlockCompressEntrySize;
+		int lOffset = ReadBlockInt32(pEntry, 0);
+		int lSrcSize = ReadBlockInt32(pEntry, 1);
+		if(lOffset < 0 || lSrcSize < 0) return false;
+		if((size_t)lOffset > alSize - lDataStart || (size_t)lSrcSize > alSize - lDataStart - lOffset) return false;
+
+		aJob.mbCompress = false;
+		aJob.mpSrc = apSrcData + lDataStart + lOffset;
+		aJob.mlSrcSize = (size_t)lSrcSize;
+		aJob.mlCRC = (unsigned int)ReadBlockInt32(pEntry, 2);
+		aJob.mlDestSize = std::min(alBlockSize, alTotalSize - alBlock*alBlockSize);
+		aJob.mpDest = NULL;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -275,6 +407,15 @@ namespace hpl {
 			AddInt32(0);
 		}
 
+		///////////////////////////
+		// Large data is split into blocks
+		if(mbUseBlockCompression && alSize > glBlockCompressBlockSize)
+		{
+			bool bRet = CompressBlocksAndAdd(apSrcData, alSize, alCompressionLevel);
+			if(bRet && abWriteDataSize) SetInt32((int)(mlDataPos - lStartPos - 4), lStartPos);
+			return bRet;
+		}
+
 		///////////////////////////
 		// Set up
 		const size_t lMaxChunkSize = 65536;
@@ -326,8 +467,7 @@ namespace hpl {
 		{
 			size_t lTotalDataSize = mlDataPos - lStartPos - 4;
 			
-			int *pSizeDataPtr = (int*)mpData[lStartPos];
-			*pSizeDataPtr = (int)lTotalDataSize;
+			SetInt32((int)lTotalDataSize, lStartPos);
 		}
 
 		//Log("Compress Size: %d\n", mlDataPos - lStartPos);
@@ -343,6 +483,12 @@ namespace hpl {
 		// Check the parameters
 		if(apSrcData==NULL) return false;
 
+		///////////////////////////
+		// Block compressed data
+		if(GetCompressedBlockNum(apSrcData, alSize) > 0)
+		{
+			return DecompressBlocksAndAdd(apSrcData, alSize);
+		}
 		
 		///////////////////////////
 		// Set up
@@ -420,6 +566,45 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	int cBinaryBuffer::GetCompressedBlockNum(const char *apSrcData, size_t alSize)
+	{
+		if(apSrcData==NULL || alSize < glBlockCompressHeaderSize) return 0;
+		if(memcmp(apSrcData, gvBlockCompressMagic, 4) != 0) return 0;
+		if(ReadBlockInt32(apSrcData, 1) != glBlockCompressVersion) return 0;
+
+		int lBlockNum = ReadBlockInt32(apSrcData, 3);
+		if(lBlockNum <= 0 || alSize < glBlockCompressHeaderSize + (size_t)lBlockNum*glBlockCompressEntrySize) return 0;
+
+		return lBlockNum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cBinaryBuffer::DecompressBlockAndAdd(const char *apSrcData, size_t alSize, int alBlock)
+	{
+		int lBlockNum = GetCompressedBlockNum(apSrcData, alSize);
+		if(alBlock < 0 || alBlock >= lBlockNum) return false;
+
+		size_t lBlockSize, lTotalSize;
+		if(GetBlockCompressSizes(apSrcData, lBlockNum, &lBlockSize, &lTotalSize)==false) return false;
+
+		cBlockCompressJob job;
+		if(SetupBlockDecompressJob(job, apSrcData, alSize, lBlockNum, alBlock, lBlockSize, lTotalSize)==false) return false;
+
+		if(mlDataPos + job.mlDestSize > mlReservedDataSize) Reserve(mlDataPos + job.mlDestSize);
+		if(mlDataPos + job.mlDestSize > mlReservedDataSize) return false;
+		job.mpDest = mpData + mlDataPos;
+		
+		job.Execute(kJobThreadIndex_None);
+		if(job.mbOk==false) return false;
+
+		mlDataPos += job.mlDestSize;
+		mlDataSize += job.mlDestSize;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cBinaryBuffer::XorTransform(const char* apKeyData, size_t alKeySize)
 	{
 		size_t lCurrentKeyChar =0;
@@ -957,6 +1142,93 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 	
+	bool cBinaryBuffer::CompressBlocksAndAdd(char *apSrcData, size_t alSize, int alCompressionLevel)
+	{
+		size_t lBlockNum = (alSize + glBlockCompressBlockSize-1) / glBlockCompressBlockSize;
+
+		///////////////////////////
+		// Compress the blocks
+		std::vector<cBlockCompressJob> vJobs(lBlockNum);
+		for(size_t i=0; i<lBlockNum; ++i)
+		{
+			cBlockCompressJob &job = vJobs[i];
+			job.mbCompress = true;
+			job.mlLevel = alCompressionLevel<0 ? Z_DEFAULT_COMPRESSION : alCompressionLevel;
+			job.mpSrc = apSrcData + i*glBlockCompressBlockSize;
+			job.mlSrcSize = std::min(glBlockCompressBlockSize, alSize - i*glBlockCompressBlockSize);
+		}
+
+		RunBlockCompressJobs(vJobs, mpJobManager);
+
+		///////////////////////////
+		// Write header, table and blocks
+		AddData(gvBlockCompressMagic, 4);
+		AddInt32(glBlockCompressVersion);
+		AddInt32((int)glBlockCompressBlockSize);
+		AddInt32((int)lBlockNum);
+		AddInt32((int)alSize);
+
+		size_t lOffset = 0;
+		for(size_t i=0; i<lBlockNum; ++i)
+		{
+			if(vJobs[i].mbOk==false) return false;
+
+			AddInt32((int)lOffset);
+			AddInt32((int)vJobs[i].mvCompressed.size());
+			AddInt32((int)vJobs[i].mlCRC);
+			lOffset += vJobs[i].mvCompressed.size();
+		}
+
+		for(size_t i=0; i<lBlockNum; ++i)
+		{
+			AddData(&vJobs[i].mvCompressed[0], vJobs[i].mvCompressed.size());
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cBinaryBuffer::DecompressBlocksAndAdd(const char *apSrcData, size_t alSize)
+	{
+		int lBlockNum = GetCompressedBlockNum(apSrcData, alSize);
+		size_t lBlockSize, lTotalSize;
+		if(GetBlockCompressSizes(apSrcData, lBlockNum, &lBlockSize, &lTotalSize)==false) return false;
+
+		std::vector<cBlockCompressJob> vJobs(lBlockNum);
+		for(int i=0; i<lBlockNum; ++i)
+		{
+			if(SetupBlockDecompressJob(vJobs[i], apSrcData, alSize, lBlockNum, i, lBlockSize, lTotalSize)==false) return false;
+		}
+
+		///////////////////////////
+		// Make room for all data, the blocks are decompressed straight into the buffer.
+		if(mlDataPos + lTotalSize > mlReservedDataSize) Reserve(mlDataPos + lTotalSize);
+		if(mlDataPos + lTotalSize > mlReservedDataSize) return false;
+
+		for(int i=0; i<lBlockNum; ++i)
+		{
+			vJobs[i].mpDest = mpData + mlDataPos + i*lBlockSize;
+		}
+
+		RunBlockCompressJobs(vJobs, mpJobManager);
+
+		for(int i=0; i<lBlockNum; ++i)
+		{
+			if(vJobs[i].mbOk==false)
+			{
+				Error("Block %d of compressed data is corrupt!\n", i);
+				return false;
+			}
+		}
+
+		mlDataPos += lTotalSize;
+		mlDataSize += lTotalSize;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cBinaryBuffer::InitAndAllocData()
 	{
 		mlCRCStartPos =0;
@@ -77,44 +77,14 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	typedef std::multimap<int,iCollideShape*> tLoaderCollideShapeMap;
-	typedef tLoaderCollideShapeMap::iterator tLoaderCollideShapeMapIt;
+	typedef std::multimap<int,cXmlElement*> tLoaderShapeElementMap;
+	typedef tLoaderShapeElementMap::iterator tLoaderShapeElementMapIt;
 
 	typedef std::multimap<int,iPhysicsBody*> tLoaderPhysicsBodyMap;
 	typedef tLoaderPhysicsBodyMap::iterator tLoaderPhysicsBodyMapIt;
 
 	//-----------------------------------------------------------------------
 
-	static iCollideShape* GetBodyShape(cXmlElement *apBodyElem,iPhysicsWorld *apPhysicsWorld, tLoaderCollideShapeMap &a_setShapes)
-	{
-		////////////////////////////////////////
-		// Get shapes for body
-		tCollideShapeVec vShapes;
-		cXmlNodeListIterator boundShapeIt = apBodyElem->GetChildIterator();
-		while(boundShapeIt.HasNext())
-		{
-			cXmlElement *pShapeElem = boundShapeIt.Next()->ToElement();
-			int lShapeID = pShapeElem->GetAttributeInt("ID");
-
-			tLoaderCollideShapeMapIt it = a_setShapes.find(lShapeID);
-			if(it != a_setShapes.end())
-			{
-				vShapes.push_back(it->second);
-				a_setShapes.erase(it);
-			}
-		}
-		
-		////////////////////////////////////////
-		// Create final shape
-		if(vShapes.empty()) return NULL;
-        if(vShapes.size()==1) return vShapes[0];
-
-		iCollideShape *pCompound = apPhysicsWorld->CreateCompundShape(vShapes);
-		return pCompound;
-	}
-
-	//-----------------------------------------------------------------------
-
 	eCollideShapeType ToCollideShape(const tString& asType)
 	{
 		tString sLowType = cString::ToLowerCase(asType);
@@ -129,33 +99,105 @@ namespace hpl {
 		return eCollideShapeType_Null;
 	}
 
-	static iCollideShape* CreateCollideShape(cXmlElement *apShapeElem, iPhysicsWorld *apPhysicsWorld, const cVector3f &avScale)
+	static void GetCollideShapeData(cXmlElement *apShapeElem, const cVector3f &avScale, 
+									eCollideShapeType &aType, cVector3f &avSize, cMatrixf &a_mtxOffset)
 	{
-		eCollideShapeType type = ToCollideShape(apShapeElem->GetAttributeString("ShapeType"));
-		cVector3f vSize = apShapeElem->GetAttributeVector3f("Scale") * avScale;
+		aType = ToCollideShape(apShapeElem->GetAttributeString("ShapeType"));
+		avSize = apShapeElem->GetAttributeVector3f("Scale") * avScale;
 		cVector3f vPos = apShapeElem->GetAttributeVector3f("RelativeTranslation") * avScale;
 		cVector3f vRot = apShapeElem->GetAttributeVector3f("RelativeRotation");
 
-		cMatrixf mtxOffset = cMath::MatrixRotate(vRot,eEulerRotationOrder_XYZ);
-		mtxOffset.SetTranslation(vPos);
+		a_mtxOffset = cMath::MatrixRotate(vRot,eEulerRotationOrder_XYZ);
+		a_mtxOffset.SetTranslation(vPos);
+
+		if(aType == eCollideShapeType_Cylinder || aType == eCollideShapeType_Capsule)
+			a_mtxOffset = cMath::MatrixMul(a_mtxOffset, cMath::MatrixRotateZ(kPi2f));
+	}
 
-		switch(type)
+	static iCollideShape* CreateCollideShape(	eCollideShapeType aType, const cVector3f &avSize, cMatrixf &a_mtxOffset,
+												iPhysicsWorld *apPhysicsWorld)
+	{
+		switch(aType)
 		{
 		case eCollideShapeType_Box: 
-			return apPhysicsWorld->CreateBoxShape(vSize,&mtxOffset);
+			return apPhysicsWorld->CreateBoxShape(avSize,&a_mtxOffset);
 		case eCollideShapeType_Sphere: 
-			return apPhysicsWorld->CreateSphereShape(vSize,&mtxOffset);
+			return apPhysicsWorld->CreateSphereShape(avSize,&a_mtxOffset);
 		case eCollideShapeType_Cylinder: 
-			mtxOffset = cMath::MatrixMul(mtxOffset, cMath::MatrixRotateZ(kPi2f));
-			return apPhysicsWorld->CreateCylinderShape(vSize.x,vSize.y,&mtxOffset);
+			return apPhysicsWorld->CreateCylinderShape(avSize.x,avSize.y,&a_mtxOffset);
 		case eCollideShapeType_Capsule: 
-			mtxOffset = cMath::MatrixMul(mtxOffset, cMath::MatrixRotateZ(kPi2f));
-			return apPhysicsWorld->CreateCapsuleShape(vSize.x,vSize.y,&mtxOffset);
+			return apPhysicsWorld->CreateCapsuleShape(avSize.x,avSize.y,&a_mtxOffset);
 		}
 
 		return NULL;
 	}
 
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Bodies built from equal shape data share the same shape, so placing the same entity many times only 
+	 * creates the shapes once per physics world.
+	 */
+	static iCollideShape* GetBodyShape(	cXmlElement *apBodyElem,iPhysicsWorld *apPhysicsWorld, 
+										tLoaderShapeElementMap &a_mapShapeElems, const cVector3f &avScale)
+	{
+		////////////////////////////////////////
+		// Get shape data for body
+		std::vector<eCollideShapeType> vTypes;
+		std::vector<cVector3f> vSizes;
+		tMatrixfVec vOffsets;
+		cCollideShapeCacheKey cacheKey;
+
+		cXmlNodeListIterator boundShapeIt = apBodyElem->GetChildIterator();
+		while(boundShapeIt.HasNext())
+		{
+			cXmlElement *pBoundShapeElem = boundShapeIt.Next()->ToElement();
+			int lShapeID = pBoundShapeElem->GetAttributeInt("ID");
+
+			tLoaderShapeElementMapIt it = a_mapShapeElems.find(lShapeID);
+			if(it == a_mapShapeElems.end()) continue;
+
+			cXmlElement *pShapeElem = it->second;
+			a_mapShapeElems.erase(it);
+
+			eCollideShapeType type;
+			cVector3f vSize;
+			cMatrixf mtxOffset;
+			GetCollideShapeData(pShapeElem, avScale, type, vSize, mtxOffset);
+			if(type == eCollideShapeType_Null) continue;
+
+			vTypes.push_back(type);
+			vSizes.push_back(vSize);
+			vOffsets.push_back(mtxOffset);
+			cacheKey.AddShape(type, vSize, mtxOffset);
+		}
+		if(vTypes.empty()) return NULL;
+
+		////////////////////////////////////////
+		// Check if shape has already been created
+		iCollideShape *pShape = apPhysicsWorld->GetCachedShape(cacheKey);
+		if(pShape) return pShape;
+
+		////////////////////////////////////////
+		// Create final shape
+		tCollideShapeVec vShapes;
+		vShapes.reserve(vTypes.size());
+		for(size_t i=0; i<vTypes.size(); ++i)
+		{
+			iCollideShape *pSubShape = CreateCollideShape(vTypes[i], vSizes[i], vOffsets[i], apPhysicsWorld);
+			if(pSubShape) vShapes.push_back(pSubShape);
+		}
+
+		if(vShapes.empty()) return NULL;
+
+		if(vShapes.size()==1)	pShape = vShapes[0];
+		else					pShape = apPhysicsWorld->CreateCompundShape(vShapes);
+
+		apPhysicsWorld->AddCachedShape(cacheKey, pShape);
+		
+		return pShape;
+	}
+
 	//-----------------------------------------------------------------------
 	
 	static iPhysicsBody * FindBody(int alID, tLoaderPhysicsBodyMap &a_setBodies)
@@ -625,8 +667,8 @@ namespace hpl {
 
 
 		////////////////////////////////////////	
-		// Load Shapes
-		tLoaderCollideShapeMap setShapes;
+		// Load Shapes, these are created (or taken from the shape cache) when the bodies are created
+		tLoaderShapeElementMap mapShapeElems;
 
 		if(pPhysicsWorld)
 		{
@@ -637,12 +679,9 @@ namespace hpl {
 				while(shapeIt.HasNext())
 				{
 					cXmlElement *pBodyShapeElem = shapeIt.Next()->ToElement();
-
-					iCollideShape *pCollideShape = CreateCollideShape(pBodyShapeElem, pPhysicsWorld, mvScale);
-					if(pCollideShape == NULL) continue;
 					int lID = pBodyShapeElem->GetAttributeInt("ID");
 
-					setShapes.insert(tLoaderCollideShapeMap::value_type(lID, pCollideShape));
+					mapShapeElems.insert(tLoaderShapeElementMap::value_type(lID, pBodyShapeElem));
 				}
 			}
 		}
@@ -670,7 +709,7 @@ namespace hpl {
 
 					/////////////////////
 					// Get shape
-					iCollideShape *pShape = GetBodyShape(pBodyElem,pPhysicsWorld,setShapes);
+					iCollideShape *pShape = GetBodyShape(pBodyElem,pPhysicsWorld,mapShapeElems,mvScale);
 					if(pShape==NULL){
 						Error("No shapes found for body '%s'\n", sBodyName.c_str());
 						continue;
@@ -715,14 +754,6 @@ namespace hpl {
 				else
 					lstTempEntities.push_back(mpEntity);
 			}
-
-			////////////////////////
-			//Destroy any left over shapes
-			tLoaderCollideShapeMapIt shapeSetIt = setShapes.begin();
-			for(; shapeSetIt != setShapes.end(); ++shapeSetIt)
-			{
-				pPhysicsWorld->DestroyShape(shapeSetIt->second);
-			}
 		}
 		
 		////////////////////////////////////////	
@@ -26,9 +26,30 @@
 #include "resources/Resources.h"
 #include "resources/FileSearcher.h"
 #include "system/Platform.h"
+#include "resources/BinaryBuffer.h"
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// COMPILED FILE FORMAT
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * Compiled language files are stored next to the xml file and contain:
+	 *  Header: int magic, int version, int source file size, 6 ints with the source file modified date.
+	 *  int dir count, for each: string path, bool add sub dirs.
+	 *  int category count, for each: string name, int entry count, for each: string name, int text start, int text length.
+	 *  int text length, followed by all texts as one int array of characters.
+	 */
+	#define LANGUAGE_COMPILED_MAGIC_NUMBER	0x474E414C
+	#define LANGUAGE_COMPILED_VERSION		1
+
+	bool cLanguageFile::mbUseCompiledFiles = true;
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -38,6 +59,7 @@ namespace hpl {
 	cLanguageFile::cLanguageFile(cResources *apResources)
 	{
 		mpResources = apResources;
+		mlLookupMask = 0;
 	}
 
 	//-----------------------------------------------------------------------
@@ -57,15 +79,97 @@ namespace hpl {
 	
 	bool cLanguageFile::AddFromFile(const tWString& asFile, bool abAddResourceDirs, const tWString& asAltPath)
 	{
-		const bool bLog =false;
-		TiXmlDocument *pDoc = hplNew(TiXmlDocument,() );
-
 		tWString sPath = asFile;
 		if (asAltPath.length() > 0 && cPlatform::FileExists(asAltPath + asFile)) {
 			sPath = asAltPath + asFile;
 		}
 
-		FILE *pFile = cPlatform::OpenFile(sPath, _W("rb"));
+		cLanguageFileData fileData;
+
+		///////////////////////////
+		//Use the compiled file if it is up to date, else parse the xml and (re)compile.
+		tWString sCompiledPath = cString::SetFileExtW(sPath, _W("lang_bin"));
+		bool bLoadedCompiled = mbUseCompiledFiles && LoadCompiledFile(sCompiledPath, sPath, &fileData);
+		if(bLoadedCompiled==false)
+		{
+			fileData = cLanguageFileData(); //Might be partly filled by a corrupt compiled file.
+			if(LoadXmlFile(sPath, &fileData)==false)
+			{
+				Error("Couldn't load language file '%ls'\n",asFile.c_str());
+				return false;
+			}
+			if(abAddResourceDirs && fileData.mvDirs.empty())
+			{
+				Warning("No resources element found in '%ls'\n",asFile.c_str());
+			}
+
+			if(mbUseCompiledFiles) SaveCompiledFile(sCompiledPath, sPath, &fileData);
+		}
+		
+		AddData(&fileData, abAddResourceDirs, asAltPath);
+
+		BuildLookupTable();
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	const tWString& cLanguageFile::Translate(const tString& asCat, const tString& asName)
+	{
+		///////////////////////////
+		//Look up in the hash table
+		if(mvLookupTable.empty()==false)
+		{
+			unsigned int lHash = GetLookupHash(asCat, asName);
+			for(unsigned int lIdx = lHash & mlLookupMask; ; lIdx = (lIdx+1) & mlLookupMask)
+			{
+				cLanguageLookupSlot &slot = mvLookupTable[lIdx];
+				if(slot.mpEntry == NULL) break;
+
+				if(slot.mlHash == lHash && *slot.mpName == asName && *slot.mpCategory == asCat)
+				{
+					return slot.mpEntry->mwsText;
+				}
+			}
+		}
+
+		///////////////////////////
+		//Not found, check what is missing
+		tLanguageCategoryMapIt CatIt = m_mapCategories.find(asCat);
+		if(CatIt == m_mapCategories.end())
+		{
+			Warning("Could not find language file category '%s'\n",asCat.c_str());
+			return mwsEmpty;
+		}
+		
+        cLanguageCategory *pCategory = CatIt->second;
+		tLanguageEntryMapIt EntryIt = pCategory->m_mapEntries.find(asName);
+		if(EntryIt == pCategory->m_mapEntries.end())
+		{
+			Warning("Could not find language file entry '%s'\n",asName.c_str());
+			return mwsEmpty;
+		}
+
+		cLanguageEntry *pEntry = EntryIt->second;
+
+		return pEntry->mwsText;
+	}
+	
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cLanguageFile::LoadXmlFile(const tWString& asPath, cLanguageFileData *apData)
+	{
+		const bool bLog =false;
+		TiXmlDocument *pDoc = hplNew(TiXmlDocument,() );
+
+		FILE *pFile = cPlatform::OpenFile(asPath, _W("rb"));
 		bool bRet = false;
 		if (pFile!=NULL) {
 			bRet = pDoc->LoadFile(pFile);
@@ -75,247 +179,468 @@ namespace hpl {
 		if (!bRet)
 		{
 			hplDelete(pDoc);
-			Error("Couldn't load language file '%ls'\n",asFile.c_str());
 			return false;
 		}
 
-		if(bLog) Log("Loading lang file '%ls'\n---------------------\n",asFile.c_str());
+		if(bLog) Log("Loading lang file '%ls'\n---------------------\n",asPath.c_str());
 
 		TiXmlElement *pRootElem = pDoc->FirstChildElement();
 
 		///////////////////////////
 		//Iterate the resources
-		if(abAddResourceDirs)
+		TiXmlElement *pResourceElem = pRootElem->FirstChildElement("RESOURCES");
+		if(pResourceElem)
 		{
-			TiXmlElement *pResourceElem = pRootElem->FirstChildElement("RESOURCES");
-			if(pResourceElem)
+			TiXmlElement *pDirElem = pResourceElem->FirstChildElement("Directory");
+			for(; pDirElem != NULL; pDirElem = pDirElem->NextSiblingElement("Directory"))
 			{
-				TiXmlElement *pDirElem = pResourceElem->FirstChildElement("Directory");
-				for(; pDirElem != NULL; pDirElem = pDirElem->NextSiblingElement("Directory"))
-				{
-						tString sPath = pDirElem->Attribute("Path");
-						if(sPath==""){
-							continue;
-						}
+				tString sPath = cString::ToString(pDirElem->Attribute("Path"),"");
+				if(sPath==""){
+					continue;
+				}
 
-						bool bAddSubDirs = cString::ToBool(pDirElem->Attribute("AddSubDirs"), true);
+				if(sPath[0]=='/' || sPath[0]=='\\') sPath = cString::Sub(sPath, 1);
 
-						if(sPath[0]=='/' || sPath[0]=='\\') sPath = cString::Sub(sPath, 1);
-#ifndef HPL_MINIMAL
-						//Log("Adding lang path: '%s' %d\n", sPath.c_str(), bAddSubDirs);
-						if (asAltPath.length()) {
-							mpResources->AddResourceDir(asAltPath + cString::To16Char(sPath),bAddSubDirs);
-						}
-						mpResources->AddResourceDir(cString::To16Char(sPath),bAddSubDirs);
-#endif
+				cLanguageFileDir dir;
+				dir.msPath = sPath;
+				dir.mbAddSubDirs = cString::ToBool(pDirElem->Attribute("AddSubDirs"), true);
+				apData->mvDirs.push_back(dir);
+			}
+		}
+		
+		///////////////////////////
+		//Iterate the categories
+        TiXmlElement *pCatElem = pRootElem->FirstChildElement("CATEGORY");
+		for(; pCatElem != NULL; pCatElem = pCatElem->NextSiblingElement("CATEGORY"))
+		{
+			apData->mvCategories.push_back(cLanguageFileCategory());
+			cLanguageFileCategory &category = apData->mvCategories.back();
+			category.msName = cString::ToString(pCatElem->Attribute("Name"),"");
+
+			if(bLog) Log("Reading category '%s'\n",category.msName.c_str());
+			
+			///////////////////////////
+            //Iterate the entries
+			TiXmlElement *pEntryElem = pCatElem->FirstChildElement("Entry");
+			for(; pEntryElem != NULL; pEntryElem = pEntryElem->NextSiblingElement("Entry"))
+			{
+				cLanguageFileEntry entry;
+				entry.msName = cString::ToString(pEntryElem->Attribute("Name"),"");
+				entry.mlTextStart = apData->mwsText.size();
+
+				////////////////////////
+				//Add Text, if none is found the entry gets no text.
+				if(pEntryElem->FirstChild())
+				{
+					TiXmlText *pTextNode = pEntryElem->FirstChild()->ToText();
+					if(pTextNode)
+					{
+						DecodeText(pTextNode->Value(), apData->mwsText);
+					}
 				}
+
+				entry.mlTextLength = apData->mwsText.size() - entry.mlTextStart;
+				category.mvEntries.push_back(entry);
 			}
-			else
+		}
+
+		hplDelete(pDoc);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static bool GetCheckedInt32(cBinaryBuffer &aBuffer, int *apValue)
+	{
+		if(aBuffer.GetPos() + sizeof(int) > aBuffer.GetSize()) return false;
+		*apValue = aBuffer.GetInt32();
+		return true;
+	}
+
+	static bool GetCheckedString(cBinaryBuffer &aBuffer, tString *apStr)
+	{
+		//Strings are zero terminated and always followed by more data, so the end must not be reached.
+		aBuffer.GetString(apStr);
+		return aBuffer.IsEOF()==false;
+	}
+
+	static bool HasBytesLeft(cBinaryBuffer &aBuffer, size_t alNum, size_t alMinSize)
+	{
+		return alNum <= (aBuffer.GetSize() - aBuffer.GetPos()) / alMinSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static bool CompiledFileIsCorrupt(const tWString& asCompiledPath)
+	{
+		Warning("Compiled language file '%ls' is corrupt\n",asCompiledPath.c_str());
+		return false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cLanguageFile::LoadCompiledFile(const tWString& asCompiledPath, const tWString& asSourcePath, cLanguageFileData *apData)
+	{
+		if(cPlatform::FileExists(asCompiledPath)==false) return false;
+
+		cBinaryBuffer binBuff(asCompiledPath);
+		if(binBuff.Load()==false) return false;
+
+		////////////////////////////////////////
+		// Header, must match the xml file
+		const size_t lHeaderSize = sizeof(int)*9;
+		if(binBuff.GetSize() < lHeaderSize) return false;
+
+		if(binBuff.GetInt32() != LANGUAGE_COMPILED_MAGIC_NUMBER) return false;
+		if(binBuff.GetInt32() != LANGUAGE_COMPILED_VERSION) return false;
+
+		if(cPlatform::FileExists(asSourcePath))
+		{
+			cDate sourceDate = cPlatform::FileModifiedDate(asSourcePath);
+			cDate compiledDate;
+			int lSourceSize = binBuff.GetInt32();
+			compiledDate.seconds = binBuff.GetInt32();
+			compiledDate.minutes = binBuff.GetInt32();
+			compiledDate.hours = binBuff.GetInt32();
+			compiledDate.month_day = binBuff.GetInt32();
+			compiledDate.month = binBuff.GetInt32();
+			compiledDate.year = binBuff.GetInt32();
+
+			if(	lSourceSize != (int)cPlatform::GetFileSize(asSourcePath) ||
+				compiledDate.seconds != sourceDate.seconds || compiledDate.minutes != sourceDate.minutes ||
+				compiledDate.hours != sourceDate.hours || compiledDate.month_day != sourceDate.month_day ||
+				compiledDate.month != sourceDate.month || compiledDate.year != sourceDate.year)
 			{
-				Warning("No resources element found in '%ls'\n",asFile.c_str());
+				return false;
+			}
+		}
+		//No source file, the compiled file is used as is.
+		else
+		{
+			binBuff.SetPos(lHeaderSize);
+		}
+
+		////////////////////////////////////////
+		// Directories, each is at least an empty string and a bool.
+		int lDirNum;
+		if(GetCheckedInt32(binBuff, &lDirNum)==false || lDirNum < 0 || HasBytesLeft(binBuff, lDirNum, 2)==false)
+			return CompiledFileIsCorrupt(asCompiledPath);
+
+		apData->mvDirs.resize(lDirNum);
+		for(int i=0; i<lDirNum; ++i)
+		{
+			if(GetCheckedString(binBuff, &apData->mvDirs[i].msPath)==false) return CompiledFileIsCorrupt(asCompiledPath);
+			apData->mvDirs[i].mbAddSubDirs = binBuff.GetBool();
+		}
+
+		////////////////////////////////////////
+		// Categories and entries, each category is at least an empty string and an int, each entry an empty string and two ints.
+		int lCatNum;
+		if(GetCheckedInt32(binBuff, &lCatNum)==false || lCatNum < 0 || HasBytesLeft(binBuff, lCatNum, 1+sizeof(int))==false)
+			return CompiledFileIsCorrupt(asCompiledPath);
+
+		apData->mvCategories.resize(lCatNum);
+		for(int i=0; i<lCatNum; ++i)
+		{
+			cLanguageFileCategory &category = apData->mvCategories[i];
+			if(GetCheckedString(binBuff, &category.msName)==false) return CompiledFileIsCorrupt(asCompiledPath);
+
+			int lEntryNum;
+			if(GetCheckedInt32(binBuff, &lEntryNum)==false || lEntryNum < 0 || HasBytesLeft(binBuff, lEntryNum, 1+sizeof(int)*2)==false)
+				return CompiledFileIsCorrupt(asCompiledPath);
+
+			category.mvEntries.resize(lEntryNum);
+			for(int j=0; j<lEntryNum; ++j)
+			{
+				cLanguageFileEntry &entry = category.mvEntries[j];
+				int lTextStart, lTextLength;
+				if(	GetCheckedString(binBuff, &entry.msName)==false ||
+					GetCheckedInt32(binBuff, &lTextStart)==false || GetCheckedInt32(binBuff, &lTextLength)==false ||
+					lTextStart < 0 || lTextLength < 0)
+				{
+					return CompiledFileIsCorrupt(asCompiledPath);
+				}
+				entry.mlTextStart = (size_t)lTextStart;
+				entry.mlTextLength = (size_t)lTextLength;
 			}
 		}
 
+		////////////////////////////////////////
+		// Text
+		int lTextLength;
+		if(GetCheckedInt32(binBuff, &lTextLength)==false || lTextLength < 0 || HasBytesLeft(binBuff, lTextLength, sizeof(int))==false)
+		{
+			return CompiledFileIsCorrupt(asCompiledPath);
+		}
 		
+		const int *pChars = reinterpret_cast<const int*>(binBuff.GetDataPointerAtCurrentPos());
+		apData->mwsText.resize(lTextLength);
+		for(int i=0; i<lTextLength; ++i)
+		{
+			apData->mwsText[i] = (wchar_t)pChars[i];
+		}
+
+		for(size_t i=0; i<apData->mvCategories.size(); ++i)
+		{
+			std::vector<cLanguageFileEntry> &vEntries = apData->mvCategories[i].mvEntries;
+			for(size_t j=0; j<vEntries.size(); ++j)
+			{
+				if(	vEntries[j].mlTextStart > apData->mwsText.size() ||
+					vEntries[j].mlTextLength > apData->mwsText.size() - vEntries[j].mlTextStart)
+				{
+					return CompiledFileIsCorrupt(asCompiledPath);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLanguageFile::SaveCompiledFile(const tWString& asCompiledPath, const tWString& asSourcePath, cLanguageFileData *apData)
+	{
+		cBinaryBuffer binBuff(asCompiledPath);
+
+		////////////////////////////////////////
+		// Header
+		cDate sourceDate = cPlatform::FileModifiedDate(asSourcePath);
+		binBuff.AddInt32(LANGUAGE_COMPILED_MAGIC_NUMBER);
+		binBuff.AddInt32(LANGUAGE_COMPILED_VERSION);
+		binBuff.AddInt32((int)cPlatform::GetFileSize(asSourcePath));
+		binBuff.AddInt32(sourceDate.seconds);
+		binBuff.AddInt32(sourceDate.minutes);
+		binBuff.AddInt32(sourceDate.hours);
+		binBuff.AddInt32(sourceDate.month_day);
+		binBuff.AddInt32(sourceDate.month);
+		binBuff.AddInt32(sourceDate.year);
+
+		////////////////////////////////////////
+		// Directories
+		binBuff.AddInt32((int)apData->mvDirs.size());
+		for(size_t i=0; i<apData->mvDirs.size(); ++i)
+		{
+			binBuff.AddString(apData->mvDirs[i].msPath);
+			binBuff.AddBool(apData->mvDirs[i].mbAddSubDirs);
+		}
+
+		////////////////////////////////////////
+		// Categories and entries
+		binBuff.AddInt32((int)apData->mvCategories.size());
+		for(size_t i=0; i<apData->mvCategories.size(); ++i)
+		{
+			cLanguageFileCategory &category = apData->mvCategories[i];
+			binBuff.AddString(category.msName);
+			binBuff.AddInt32((int)category.mvEntries.size());
+			for(size_t j=0; j<category.mvEntries.size(); ++j)
+			{
+				cLanguageFileEntry &entry = category.mvEntries[j];
+				binBuff.AddString(entry.msName);
+				binBuff.AddInt32((int)entry.mlTextStart);
+				binBuff.AddInt32((int)entry.mlTextLength);
+			}
+		}
+
+		////////////////////////////////////////
+		// Text, as ints since wchar_t differs in size between platforms.
+		std::vector<int> vChars(apData->mwsText.size());
+		for(size_t i=0; i<vChars.size(); ++i) vChars[i] = (int)apData->mwsText[i];
+
+		binBuff.AddInt32((int)vChars.size());
+		if(vChars.empty()==false) binBuff.AddInt32Array(&vChars[0], vChars.size());
+
+		//The folder might be read only, then the xml is simply parsed each time.
+		if(binBuff.Save()==false)
+		{
+			Log("Could not save compiled language file '%ls'\n",asCompiledPath.c_str());
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLanguageFile::AddData(cLanguageFileData *apData, bool abAddResourceDirs, const tWString& asAltPath)
+	{
+		const bool bLog =false;
+
 		///////////////////////////
-		//Iterate the categories
-        TiXmlElement *pCatElem = pRootElem->FirstChildElement("CATEGORY");
-		for(; pCatElem != NULL; pCatElem = pCatElem->NextSiblingElement("CATEGORY"))
+		//Add the resource dirs
+#ifndef HPL_MINIMAL
+		if(abAddResourceDirs)
+		{
+			for(size_t i=0; i<apData->mvDirs.size(); ++i)
+			{
+				cLanguageFileDir &dir = apData->mvDirs[i];
+				//Log("Adding lang path: '%s' %d\n", dir.msPath.c_str(), dir.mbAddSubDirs);
+				if (asAltPath.length()) {
+					mpResources->AddResourceDir(asAltPath + cString::To16Char(dir.msPath),dir.mbAddSubDirs);
+				}
+				mpResources->AddResourceDir(cString::To16Char(dir.msPath),dir.mbAddSubDirs);
+			}
+		}
+#endif
+
+		///////////////////////////
+		//Add the categories
+		for(size_t i=0; i<apData->mvCategories.size(); ++i)
 		{
-			tString sCatName = pCatElem->Attribute("Name");
+			cLanguageFileCategory &fileCategory = apData->mvCategories[i];
 
 			/////////////////////////////////
 			//Get the category or create if it does not exist
             cLanguageCategory *pCategory;
-			tLanguageCategoryMapIt CatIt = m_mapCategories.find(sCatName);
+			tLanguageCategoryMapIt CatIt = m_mapCategories.find(fileCategory.msName);
 			if(CatIt == m_mapCategories.end())
 			{
 				pCategory = hplNew( cLanguageCategory, () );
-				m_mapCategories.insert(tLanguageCategoryMap::value_type(sCatName, pCategory));
+				m_mapCategories.insert(tLanguageCategoryMap::value_type(fileCategory.msName, pCategory));
 				
-				if(bLog) Log("Creating category '%s'\n",sCatName.c_str());
+				if(bLog) Log("Creating category '%s'\n",fileCategory.msName.c_str());
 			}
 			else
 			{
 				pCategory = CatIt->second;
 
-				if(bLog) Log("Got existing category '%s'\n",sCatName.c_str());
+				if(bLog) Log("Got existing category '%s'\n",fileCategory.msName.c_str());
 			}
 
-			
 			///////////////////////////
-            //Iterate the entries
-			TiXmlElement *pEntryElem = pCatElem->FirstChildElement("Entry");
-			for(; pEntryElem != NULL; pEntryElem = pEntryElem->NextSiblingElement("Entry"))
+            //Add the entries
+			for(size_t j=0; j<fileCategory.mvEntries.size(); ++j)
 			{
-				tString sEntryName = pEntryElem->Attribute("Name");
-				
+				cLanguageFileEntry &fileEntry = fileCategory.mvEntries[j];
+
 				///////////////////////////////////
 				//Check if the entry already exists, if so, just continue.
-				if(pCategory->m_mapEntries.find(sEntryName) != pCategory->m_mapEntries.end())
+				if(pCategory->m_mapEntries.find(fileEntry.msName) != pCategory->m_mapEntries.end())
 				{
-					if(bLog) Log("Entry '%s' already exist!\n",sEntryName.c_str());
+					if(bLog) Log("Entry '%s' already exist!\n",fileEntry.msName.c_str());
 
 					continue;
 				}
-				
-				////////////////////////
-				//Create entry
+
 				cLanguageEntry *pEntry = hplNew( cLanguageEntry, () );
-				
-				if(bLog) Log("Creating Entry '%s'\n",sEntryName.c_str());
+				pEntry->mwsText = apData->mwsText.substr(fileEntry.mlTextStart, fileEntry.mlTextLength);
 
+				if(bLog) Log("Creating Entry '%s'\n",fileEntry.msName.c_str());
 
-				////////////////////////
-				//Add Text
-				if(pEntryElem->FirstChild())
+				pCategory->m_mapEntries.insert(tLanguageEntryMap::value_type(fileEntry.msName,pEntry));
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLanguageFile::DecodeText(const tString& asString, tWString& asDest)
+	{
+		const tString &sString = asString;
+
+		for(size_t i=0; i< sString.length(); ++i)
+		{
+			unsigned char c = sString[i];
+			if(c=='[')
+			{
+				bool bFoundCommand = true;
+				tString sCommand = "";
+				int lCount =1;
+
+				while(sString[i+lCount] != ']' && i+lCount<sString.length() && lCount < 16)
 				{
-					TiXmlText *pTextNode = pEntryElem->FirstChild()->ToText();
-					if(pTextNode)
-					{
-						//pEntry->msText = pTextNode->Value();
-						//pEntry->msText = cString::ReplaceStringTo(pEntry->msText,"[br]","\n");
-
-						tString sString = pTextNode->Value();
-						pEntry->mwsText = _W("");
-
-						//if(sCatName == "TEST") Log("String: '%s' %d\n",sString.c_str(),sString.size());
-
-						for(size_t i=0; i< sString.length(); ++i)
-						{
-							unsigned char c = sString[i];
-							if(c=='[')
-							{
-								bool bFoundCommand = true;
-								tString sCommand = "";
-								int lCount =1;
-
-								while(sString[i+lCount] != ']' && i+lCount<sString.length() && lCount < 16)
-								{
-									sCommand += sString[i+lCount];
-									lCount++;
-								}
-
-								if(sCommand=="br")
-								{
-									pEntry->mwsText += _W('\n');
-								}
-								else if(sCommand[0]=='u')
-								{
-									int lNum = cString::ToInt(sCommand.substr(1).c_str(),0);	
-									pEntry->mwsText += (wchar_t)lNum;
-								}
-								else
-								{
-									bFoundCommand = false;
-								}
-
-								//Go forward or add [ to string
-								if(bFoundCommand)
-								{
-									i += lCount;
-								}
-								else
-								{
-									pEntry->mwsText += sString[i];
-								}
-							}
-							//Decode UTF-8!
-							else if(c >= 128)
-							{
-								unsigned char c2 = sString[i+1];
-
-								int lNum = c & 0x1f; // c AND 0001 1111
-								lNum = lNum << 6;
-								lNum = lNum | (c2 & 0x3f);// c AND 0011 1111
-
-								pEntry->mwsText += (wchar_t)lNum;
-								++i;
-								//Log(" %d: (%x %x) -> %d\n",i,c,c2,(wchar_t)lNum);
-							}
-							else
-							{
-								//if(sCatName == "TEST") Log(" %d: %c | %d\n",i,c,c);
-								pEntry->mwsText += c;
-								//if(sCatName == "TEST") Log(" '%s'\n",cString::To8Char(pEntry->mwsText).c_str());
-							}
-						}
+					sCommand += sString[i+lCount];
+					lCount++;
+				}
 
-					}
+				if(sCommand=="br")
+				{
+					asDest += _W('\n');
+				}
+				else if(sCommand[0]=='u')
+				{
+					int lNum = cString::ToInt(sCommand.substr(1).c_str(),0);	
+					asDest += (wchar_t)lNum;
 				}
-				//////////
-				// No text found, add no text.
 				else
 				{
-					pEntry->mwsText = _W("");
+					bFoundCommand = false;
 				}
 
-				//if(sE == "Motion blur:") Log("After String: '%s'\n",cString::To8Char(pEntry->mwsText).c_str());
-
-				std::pair<tLanguageEntryMap::iterator,bool> ret = pCategory->m_mapEntries.insert(tLanguageEntryMap::value_type(sEntryName,pEntry));
-				if(ret.second==false){
-					Warning("Language entry '%s' in category '%s' already exists!\n",sEntryName.c_str(), sCatName.c_str());
-					hplDelete(pEntry);
+				//Go forward or add [ to string
+				if(bFoundCommand)
+				{
+					i += lCount;
 				}
-			}
-		}
-
-		hplDelete(pDoc);
-
-		/*{
-			FILE *pFile = fopen("raw_lang_text.txt","w+");
-			
-			tLanguageCategoryMapIt CatIt = m_mapCategories.begin();
-			for(; CatIt != m_mapCategories.end(); ++CatIt)
-			{
-				cLanguageCategory *pCategory = CatIt->second;
-				tLanguageEntryMapIt EntryIt = pCategory->m_mapEntries.begin();
-                for(; EntryIt != pCategory->m_mapEntries.end(); ++EntryIt)				
+				else
 				{
-					cLanguageEntry *pEntry = EntryIt->second;
-					fputs(cString::To8Char(pEntry->mwsText + _W("\n\n")).c_str(), pFile);
+					asDest += sString[i];
 				}
 			}
-			
-			fclose(pFile);
-		}*/
+			//Decode UTF-8!
+			else if(c >= 128)
+			{
+				unsigned char c2 = sString[i+1];
 
+				int lNum = c & 0x1f; // c AND 0001 1111
+				lNum = lNum << 6;
+				lNum = lNum | (c2 & 0x3f);// c AND 0011 1111
 
-		return true;
+				asDest += (wchar_t)lNum;
+				++i;
+			}
+			else
+			{
+				asDest += c;
+			}
+		}
 	}
 
 	//-----------------------------------------------------------------------
 
-	const tWString& cLanguageFile::Translate(const tString& asCat, const tString& asName)
+	void cLanguageFile::BuildLookupTable()
 	{
-		tLanguageCategoryMapIt CatIt = m_mapCategories.find(asCat);
-		if(CatIt == m_mapCategories.end())
-		{
-			Warning("Could not find language file category '%s'\n",asCat.c_str());
-			return mwsEmpty;
-		}
-		
-        cLanguageCategory *pCategory = CatIt->second;
-		tLanguageEntryMapIt EntryIt = pCategory->m_mapEntries.find(asName);
-		if(EntryIt == pCategory->m_mapEntries.end())
+		size_t lEntryNum=0;
+		for(tLanguageCategoryMapIt CatIt = m_mapCategories.begin(); CatIt != m_mapCategories.end(); ++CatIt)
 		{
-			Warning("Could not find language file entry '%s'\n",asName.c_str());
-			return mwsEmpty;
+			lEntryNum += CatIt->second->m_mapEntries.size();
 		}
 
-		cLanguageEntry *pEntry = EntryIt->second;
+		///////////////////////////
+		//Open addressing table, kept at most half full.
+		size_t lTableSize = 16;
+		while(lTableSize < lEntryNum*2) lTableSize *= 2;
 
-		return pEntry->mwsText;
-	}
-	
-	//-----------------------------------------------------------------------
+		cLanguageLookupSlot emptySlot;
+		emptySlot.mlHash = 0;
+		emptySlot.mpCategory = NULL;
+		emptySlot.mpName = NULL;
+		emptySlot.mpEntry = NULL;
 
-	//////////////////////////////////////////////////////////////////////////
-	// PRIVATE METHODS
-	//////////////////////////////////////////////////////////////////////////
+		mvLookupTable.assign(lTableSize, emptySlot);
+		mlLookupMask = (unsigned int)lTableSize - 1;
+
+		for(tLanguageCategoryMapIt CatIt = m_mapCategories.begin(); CatIt != m_mapCategories.end(); ++CatIt)
+		{
+			tLanguageEntryMap &mapEntries = CatIt->second->m_mapEntries;
+			for(tLanguageEntryMapIt EntryIt = mapEntries.begin(); EntryIt != mapEntries.end(); ++EntryIt)
+			{
+				unsigned int lHash = GetLookupHash(CatIt->first, EntryIt->first);
+				unsigned int lIdx = lHash & mlLookupMask;
+				while(mvLookupTable[lIdx].mpEntry != NULL) lIdx = (lIdx+1) & mlLookupMask;
+
+				cLanguageLookupSlot &slot = mvLookupTable[lIdx];
+				slot.mlHash = lHash;
+				slot.mpCategory = &CatIt->first;
+				slot.mpName = &EntryIt->first;
+				slot.mpEntry = EntryIt->second;
+			}
+		}
+	}
 
 	//-----------------------------------------------------------------------
 
-	
+	unsigned int cLanguageFile::GetLookupHash(const tString& asCat, const tString& asName)
+	{
+		return cString::GetHash(asCat) * 0x9E3779B1 ^ cString::GetHash(asName);
+	}
+
 	//-----------------------------------------------------------------------
 }
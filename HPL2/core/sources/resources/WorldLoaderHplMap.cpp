@@ -1829,37 +1829,51 @@ namespace hpl {
 	void cWorldLoaderHplMap::CreateShapeBody(cHplMapShapeBody* apShapeBody)
 	{
 		////////////////////////////////////
-		// Create sub shapes
-		std::vector<iCollideShape*> vShapes;
-		vShapes.resize(apShapeBody->mvColliders.size());
-		
-		for(size_t i=0; i<vShapes.size(); ++i)
+		// Check if an equal shape has already been created
+		cCollideShapeCacheKey cacheKey;
+		for(size_t i=0; i<apShapeBody->mvColliders.size(); ++i)
 		{
 			cHplMapShape* pMapShape = apShapeBody->mvColliders[i];
-			cMatrixf *pOffset = &pMapShape->m_mtxOffset;
+			cacheKey.AddShape(pMapShape->mType, pMapShape->mvSize, pMapShape->m_mtxOffset);
+		}
 
-			switch(pMapShape->mType)
+		iCollideShape *pShape = mpCurrentPhysicsWorld->GetCachedShape(cacheKey);
+		if(pShape==NULL)
+		{
+			////////////////////////////////////
+			// Create sub shapes
+			std::vector<iCollideShape*> vShapes;
+			vShapes.resize(apShapeBody->mvColliders.size());
+			
+			for(size_t i=0; i<vShapes.size(); ++i)
 			{
-			case eCollideShapeType_Box: 
-				vShapes[i] = mpCurrentPhysicsWorld->CreateBoxShape(pMapShape->mvSize,pOffset);
-				break;
-			case eCollideShapeType_Sphere: 
-				vShapes[i] = mpCurrentPhysicsWorld->CreateSphereShape(pMapShape->mvSize,pOffset);
-				break;
-			case eCollideShapeType_Cylinder: 
-				vShapes[i] = mpCurrentPhysicsWorld->CreateCylinderShape(pMapShape->mvSize.x,pMapShape->mvSize.y,pOffset);
-				break;
-			case eCollideShapeType_Capsule: 
-				vShapes[i] = mpCurrentPhysicsWorld->CreateCapsuleShape(pMapShape->mvSize.x,pMapShape->mvSize.y,pOffset);
-				break;
+				cHplMapShape* pMapShape = apShapeBody->mvColliders[i];
+				cMatrixf *pOffset = &pMapShape->m_mtxOffset;
+
+				switch(pMapShape->mType)
+				{
+				case eCollideShapeType_Box: 
+					vShapes[i] = mpCurrentPhysicsWorld->CreateBoxShape(pMapShape->mvSize,pOffset);
+					break;
+				case eCollideShapeType_Sphere: 
+					vShapes[i] = mpCurrentPhysicsWorld->CreateSphereShape(pMapShape->mvSize,pOffset);
+					break;
+				case eCollideShapeType_Cylinder: 
+					vShapes[i] = mpCurrentPhysicsWorld->CreateCylinderShape(pMapShape->mvSize.x,pMapShape->mvSize.y,pOffset);
+					break;
+				case eCollideShapeType_Capsule: 
+					vShapes[i] = mpCurrentPhysicsWorld->CreateCapsuleShape(pMapShape->mvSize.x,pMapShape->mvSize.y,pOffset);
+					break;
+				}
 			}
-		}
 
-		/////////////////////////////////////
-		// Create final shape
-		iCollideShape *pShape = NULL;
-		if(vShapes.size() > 1)	pShape = mpCurrentPhysicsWorld->CreateCompundShape(vShapes);
-		else					pShape = vShapes[0];
+			/////////////////////////////////////
+			// Create final shape
+			if(vShapes.size() > 1)	pShape = mpCurrentPhysicsWorld->CreateCompundShape(vShapes);
+			else					pShape = vShapes[0];
+
+			mpCurrentPhysicsWorld->AddCachedShape(cacheKey, pShape);
+		}
 
 		/////////////////////////////////////
 		// Create Body
@@ -190,7 +190,14 @@ namespace hpl {
 		}
 
 		//Update callbacks
-		if(mlstCallbacks.empty() || abUpdateCallbacks==false) return;
+		if(abUpdateCallbacks) RunTransformUpdateCallbacks();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::RunTransformUpdateCallbacks()
+	{
+		if(mlstCallbacks.empty()) return;
 
 		tEntityCallbackListIt it = mlstCallbacks.begin();
 		for(; it!= mlstCallbacks.end(); ++it)
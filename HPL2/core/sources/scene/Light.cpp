@@ -92,6 +92,10 @@ namespace hpl {
 
 		mfFadeTime =0;
 
+		mbDeferFadeAndFlicker = false;
+		mbFadeAndFlickerUpdated = false;
+		mlFlickerEvents = 0;
+
 		///////////////////////////////
 		//Data init
 		mpFalloffMap = mpTextureManager->Create1D("core_falloff_linear",false);
@@ -169,13 +173,13 @@ namespace hpl {
 			//Log("Fading: %f / %f\n",afTimeStep,mfFadeTime);
 
 			float fNewRadius = mfRadius + mfRadiusAdd*afTimeStep;
-			SetRadius(fNewRadius);
+			SetFadeRadius(fNewRadius);
 			
 			mDiffuseColor.r += mColAdd.r*afTimeStep;
 			mDiffuseColor.g += mColAdd.g*afTimeStep;
 			mDiffuseColor.b += mColAdd.b*afTimeStep;
 			mDiffuseColor.a += mColAdd.a*afTimeStep;
-			SetDiffuseColor(mDiffuseColor);
+			SetFadeDiffuseColor(mDiffuseColor);
 
 			mfFadeTime-=afTimeStep;
 
@@ -183,7 +187,7 @@ namespace hpl {
 			if(mfFadeTime<=0)
 			{
 				mfFadeTime =0;
-				SetDiffuseColor(mDestCol);
+				SetFadeDiffuseColor(mDestCol);
 				mfRadius = mfDestRadius;
 			}
 		}
@@ -201,25 +205,14 @@ namespace hpl {
 					mbFlickerOn = false;
 					if(!mbFlickerFade)
 					{
-						SetDiffuseColor(mFlickerOffColor);
-						SetRadius(mfFlickerOffRadius);
+						SetFadeDiffuseColor(mFlickerOffColor);
+						SetFadeRadius(mfFlickerOffRadius);
 					}
 					else
 					{
 						FadeTo(mFlickerOffColor,mfFlickerOffRadius, cMath::RandRectf(mfFlickerOffFadeMinLength, mfFlickerOffFadeMaxLength));
 					}
-					//Sound
-					if(msFlickerOffSound!=""){
-						cSoundEntity *pSound = mpWorld->CreateSoundEntity("FlickerOff",
-																			msFlickerOffSound,true);
-						if(pSound)
-						{
-							pSound->SetIsSaved(false);
-							pSound->SetPosition(GetWorldPosition());
-						}
-					}
-
-					OnFlickerOff();
+					RunFlickerEvent(false);
 
 					mfFlickerTime =0;
 					mfFlickerStateLength = cMath::RandRectf(mfFlickerOffMinLength,mfFlickerOffMaxLength);
@@ -234,23 +227,14 @@ namespace hpl {
 					mbFlickerOn = true;
 					if(!mbFlickerFade)
 					{
-						SetDiffuseColor(mFlickerOnColor);
-						SetRadius(mfFlickerOnRadius);
+						SetFadeDiffuseColor(mFlickerOnColor);
+						SetFadeRadius(mfFlickerOnRadius);
 					}
 					else
 					{
 						FadeTo(mFlickerOnColor,mfFlickerOnRadius,cMath::RandRectf(mfFlickerOnFadeMinLength, mfFlickerOnFadeMaxLength));
 					}
-					if(msFlickerOnSound!=""){
-						cSoundEntity *pSound = mpWorld->CreateSoundEntity("FlickerOn", msFlickerOnSound,true);
-						if(pSound)
-						{
-							pSound->SetIsSaved(false);
-							pSound->SetPosition(GetWorldPosition());
-						}
-					}
-
-					OnFlickerOn();
+					RunFlickerEvent(true);
 
 					mfFlickerTime =0;
 					mfFlickerStateLength = cMath::RandRectf(mfFlickerOnMinLength,mfFlickerOnMaxLength);
@@ -268,6 +252,21 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void iLight::UpdateFadeAndFlicker(float afTimeStep)
+	{
+		mfPrevRadius = mfRadius;
+		mPrevDiffuseColor = mDiffuseColor;
+		mlFlickerEvents = 0;
+
+		mbDeferFadeAndFlicker = true;
+		UpdateLight(afTimeStep);
+		mbDeferFadeAndFlicker = false;
+
+		mbFadeAndFlickerUpdated = true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iLight::FadeTo(const cColor& aCol, float afRadius, float afTime)
 	{
 		if(afTime<=0) afTime = 0.0001f;
@@ -381,7 +380,11 @@ namespace hpl {
 
 	void iLight::UpdateLogic(float afTimeStep)
 	{
-		UpdateLight(afTimeStep);
+		if(mbFadeAndFlickerUpdated)
+			ApplyFadeAndFlicker();
+		else
+			UpdateLight(afTimeStep);
+
 		if(mfFadeTime>0 || mbFlickering)
 		{
 			mbUpdateBoundingVolume = true;
@@ -594,6 +597,65 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 	
+	void iLight::SetFadeRadius(float afX)
+	{
+		if(mbDeferFadeAndFlicker)	mfRadius = afX;
+		else						SetRadius(afX);
+	}
+
+	void iLight::SetFadeDiffuseColor(const cColor& aColor)
+	{
+		if(mbDeferFadeAndFlicker)	mDiffuseColor = aColor;
+		else						SetDiffuseColor(aColor);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iLight::RunFlickerEvent(bool abOn)
+	{
+		if(mbDeferFadeAndFlicker)
+		{
+			mlFlickerEvents |= abOn ? eFlagBit_1 : eFlagBit_0;
+			return;
+		}
+
+		const tString& sSound = abOn ? msFlickerOnSound : msFlickerOffSound;
+		if(sSound!=""){
+			cSoundEntity *pSound = mpWorld->CreateSoundEntity(abOn ? "FlickerOn" : "FlickerOff", sSound,true);
+			if(pSound)
+			{
+				pSound->SetIsSaved(false);
+				pSound->SetPosition(GetWorldPosition());
+			}
+		}
+
+		if(abOn)	OnFlickerOn();
+		else		OnFlickerOff();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iLight::ApplyFadeAndFlicker()
+	{
+		mbFadeAndFlickerUpdated = false;
+
+		//Set the values again using the setters, starting from the values before the update.
+		float fRadius = mfRadius;
+		cColor diffuseColor = mDiffuseColor;
+		
+		mfRadius = mfPrevRadius;
+		mDiffuseColor = mPrevDiffuseColor;
+
+		SetRadius(fRadius);
+		if((diffuseColor == mPrevDiffuseColor)==false) SetDiffuseColor(diffuseColor);
+
+		if(mlFlickerEvents & eFlagBit_0) RunFlickerEvent(false);
+		if(mlFlickerEvents & eFlagBit_1) RunFlickerEvent(true);
+		mlFlickerEvents = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iLight::OnFlickerOff()
 	{
 		//Particle system
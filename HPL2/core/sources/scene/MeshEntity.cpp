@@ -52,6 +52,9 @@
 
 namespace hpl {
 
+	//Used to spread out the frames that entities with the same animation update interval are updated.
+	static int glAnimationUpdateOffsetCount = 0;
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -105,6 +108,16 @@ namespace hpl {
 		mbUpdatedBones = false;
 		mbHasUpdatedAnimation = true;
 
+		mbAnimationPoseUpdated = false;
+		mbAnimationPoseActive = false;
+		mbAnimationPoseTransformUpdated = false;
+
+		mbHasAnimationPose = false;
+		mlAnimationUpdateInterval = 1;
+		mlAnimationUpdateCount = glAnimationUpdateOffsetCount++;
+		mlBoneMatricesUpdateCount = 0;
+		mlBoneChildrenTransformCount = -1;
+
 		////////////////////////////////////////////////
 		//Create sub entities
 		for(int i=0;i<mpMesh->GetSubMeshNum();i++)
@@ -331,6 +344,123 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 	
 
+	bool cMeshEntity::UpdateSkeletonPose(float afTimeStep, bool abAnimationActive, bool abUpdateStates)
+	{
+		bool bUpdateTransform = false;
+		mbHasAnimationPose = true;
+
+		//////////
+		//Reset all bones states
+		if(	abAnimationActive || mbUpdatedBones == false ||
+			(mbSkeletonPhysics && !mbSkeletonPhysicsSleeping))
+		{
+			for(size_t i=0;i < mvBoneStates.size(); i++)
+			{
+				cNode3D *pState = mvBoneStates[i];
+				cBone* pBone = mpMesh->GetSkeleton()->GetBoneByIndex((int)i);
+
+				if(pState->IsActive())
+				{
+					pState->SetMatrix(pBone->GetLocalTransform(),false);
+				}
+				
+				//can optimize this by doing it in the order of the tree
+				//and using recursive. (should be enough as is...)
+				if(mbSkeletonPhysics && mfSkeletonPhysicsWeight!=1.0f)
+				{
+					mvTempBoneStates[i]->SetMatrix(pBone->GetLocalTransform(),false);
+				}
+			}
+
+			bUpdateTransform = true;
+		}
+
+		///////////////////////////
+		// Update skeleton physics
+		if(	mbSkeletonPhysics && (!mbSkeletonPhysicsSleeping || mbUpdatedBones==false))
+		{
+			mbUpdatedBones = true;
+			cNode3DIterator BoneIt = mpBoneStateRoot->GetChildIterator();
+			while(BoneIt.HasNext())
+			{
+				cBoneState *pBoneState = static_cast<cBoneState*>(BoneIt.Next());
+                    
+				SetBoneMatrixFromBodyRec(mpBoneStateRoot->GetWorldMatrix(),pBoneState);
+			}
+			
+			//Interpolate matrices
+			if(mfSkeletonPhysicsWeight!=1.0f)
+			{	
+				for(size_t i=0;i < mvBoneStates.size(); i++)
+				{
+					cMatrixf mtxMixLocal = cMath::MatrixSlerp(	mfSkeletonPhysicsWeight,
+																mvTempBoneStates[i]->GetLocalMatrix(),
+																mvBoneStates[i]->GetLocalMatrix(),
+																true);
+					
+					mvBoneStates[i]->SetMatrix(mtxMixLocal, false);
+				}
+			}
+		}
+
+		//////////////////////////////////
+		//Go the weight mul (in case weights are normalized!)
+		float fAnimationWeightMul = GetAnimationWeightMul();
+
+		//////////////////////////////////
+		//Go through all animations states and update the bones 
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			cAnimationState *pAnimState = mvAnimationStates[i];
+
+			if(pAnimState->IsActive())
+			{
+				cAnimation *pAnim = pAnimState->GetAnimation();
+
+				/////////////////////////////////////
+				//Go through all tracks in animation and apply to nodes
+				for(int i=0; i<pAnim->GetTrackNum(); i++)
+				{
+					cAnimationTrack *pTrack = pAnim->GetTrack(i);
+					
+					///////////////////////////////////
+					//If index not yet set, get it!
+					if(pTrack->GetNodeIndex()==-1) SetupAnimationTrackIndex(pTrack);
+					
+					cNode3D* pState = GetBoneState(pTrack->GetNodeIndex());
+					
+					///////////////////////////////////
+					//Apply the animation track to node.
+					if(pState && pState->IsActive())
+					{
+						pTrack->ApplyToNode(pState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul, pAnimState->IsLooping());
+					}
+				}
+
+			
+				if(abUpdateStates) pAnimState->Update(afTimeStep);
+			}
+		}
+		
+		//////////////////////////////////
+		//Go through all states and update the matrices (and thereby adding the animations together).
+		if(abAnimationActive)
+		{
+			cNode3DIterator NodeIt = mpBoneStateRoot->GetChildIterator();
+			while(NodeIt.HasNext())
+			{
+				cNode3D *pBoneState = static_cast<cNode3D*>(NodeIt.Next());
+				UpdateNodeMatrixRec(pBoneState);
+			}
+
+			//Entities are updated after BV is calculated, as the entity has the rootnode attached to it.
+		}
+
+		return bUpdateTransform;
+	}
+
+	//-----------------------------------------------------------------------
+
 	/**
 	 * This function will make less work be made in UpdateMatrix(...), else that might demand alot!
 	 */
@@ -360,10 +490,157 @@ namespace hpl {
 	
 	//-----------------------------------------------------------------------
 	
+	bool cMeshEntity::CanUpdateAnimationPoseInParallel()
+	{
+		if(mbStatic || mpMesh->GetSkeleton()==NULL || mbSkeletonPhysics) return false;
+		if(IsAnimationPoseFrame()==false) return false;
+
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			if(mvAnimationStates[i]->IsActive()) return true;
+		}
+		return false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::SetupAnimationTrackIndices()
+	{
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			cAnimationState *pAnimState = mvAnimationStates[i];
+			if(pAnimState->IsActive()==false) continue;
+
+			cAnimation *pAnim = pAnimState->GetAnimation();
+			for(int j=0; j<pAnim->GetTrackNum(); j++)
+			{
+				cAnimationTrack *pTrack = pAnim->GetTrack(j);
+				if(pTrack->GetNodeIndex()==-1) SetupAnimationTrackIndex(pTrack);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::UpdateAnimationPose(float afTimeStep)
+	{
+		mbAnimationPoseActive = false;
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			if(mvAnimationStates[i]->IsActive()){
+				mbAnimationPoseActive = true;
+				break;
+			}
+		}
+
+		mbAnimationPoseTransformUpdated = UpdateSkeletonPose(afTimeStep, mbAnimationPoseActive, false);
+		SaveAnimationPoseInputs();
+		mbAnimationPoseUpdated = true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cMeshEntity::GetLastRenderFrameCount()
+	{
+		int lCount = -1;
+		for(size_t i=0; i<mvSubMeshes.size(); ++i)
+		{
+			lCount = cMath::Max(lCount, mvSubMeshes[i]->GetRenderFrameCount());
+		}
+		return lCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMeshEntity::HasBoneEntityChildren()
+	{
+		for(size_t i=0; i<mvBoneStates.size(); ++i)
+		{
+			if(mvBoneStates[i]->GetEntityIterator().HasNext()) return true;
+		}
+		return false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::SetupAnimationTrackIndex(cAnimationTrack *apTrack)
+	{
+		int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(apTrack->GetName());
+		if(lBoneIdx==-1)
+		{
+			// XXX: This line is commented to avoid log clutter 
+			//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", apTrack->GetName().c_str(), mpMesh->GetName().c_str());
+			apTrack->SetNodeIndex(-2);
+		}
+		else
+			apTrack->SetNodeIndex(lBoneIdx);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::UpdateAnimationStates(float afTimeStep)
+	{
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			if(mvAnimationStates[i]->IsActive()) mvAnimationStates[i]->Update(afTimeStep);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::SaveAnimationPoseInputs()
+	{
+		mvAnimationPoseInputs.resize(mvAnimationStates.size());
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			cAnimationState *pAnimState = mvAnimationStates[i];
+			cAnimationPoseInput &input = mvAnimationPoseInputs[i];
+
+			input.mbActive = pAnimState->IsActive();
+			input.mbLoop = pAnimState->IsLooping();
+			input.mfWeight = pAnimState->GetWeight();
+			input.mfTimePos = pAnimState->GetTimePosition();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMeshEntity::AnimationPoseInputsChanged()
+	{
+		if(mvAnimationPoseInputs.size() != mvAnimationStates.size()) return true;
+
+		for(size_t i=0; i< mvAnimationStates.size(); i++)
+		{
+			cAnimationState *pAnimState = mvAnimationStates[i];
+			const cAnimationPoseInput &input = mvAnimationPoseInputs[i];
+
+			if(	input.mbActive != pAnimState->IsActive() || input.mbLoop != pAnimState->IsLooping() ||
+				input.mfWeight != pAnimState->GetWeight() || input.mfTimePos != pAnimState->GetTimePosition())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMeshEntity::IsAnimationPoseFrame()
+	{
+		if(mlAnimationUpdateInterval==1 || mbHasAnimationPose==false || mbSkeletonPhysics) return true;
+		if(mlAnimationUpdateInterval<=0) return false;
+
+		return (mlAnimationUpdateCount % mlAnimationUpdateInterval)==0;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cMeshEntity::UpdateLogic(float afTimeStep)
 	{	
 		if(mbStatic) return; //No update on static models
 
+		bool bPoseSkipped = false;
+
 		/////////////////////////////////////////////
 		//Update the skeleton physics fade
 		if(mbSkeletonPhysicsFading && mbSkeletonPhysics)
@@ -399,18 +676,34 @@ namespace hpl {
 				//mbSkeletonPhysicsSleeping = true;
 			}
 		}
+		/////////////////////////////////////////////
+		//A pose calculated before the update is thrown away if the animations were changed after it (by a script or event).
+		bool bPoseThrownAway = false;
+		if(mbAnimationPoseUpdated && (mbSkeletonPhysics || AnimationPoseInputsChanged()))
+		{
+			mbAnimationPoseUpdated = false;
+			bPoseThrownAway = true;
+		}
+
 		/////////////////////////////////////////////
 		//Update animations and skeleton physics
 		if(mvAnimationStates.empty()==false || mbSkeletonPhysics)
 		{
 			////////////////////////
-			//Check if it is animated
+			//Check if it is animated (the state might have changed if the pose was already updated)
 			bool bAnimationActive = false;
-			for(size_t i=0; i< mvAnimationStates.size(); i++)
+			if(mbAnimationPoseUpdated)
 			{
-				if(mvAnimationStates[i]->IsActive()){
-					bAnimationActive = true;
-					break;
+				bAnimationActive = mbAnimationPoseActive;
+			}
+			else
+			{
+				for(size_t i=0; i< mvAnimationStates.size(); i++)
+				{
+					if(mvAnimationStates[i]->IsActive()){
+						bAnimationActive = true;
+						break;
+					}
 				}
 			}
 
@@ -420,128 +713,30 @@ namespace hpl {
 			{
 				//If transform needs to be updated.
 				bool bUpdateTransform = false;
-
-				//////////
-				//Reset all bones states
-				if(	bAnimationActive || mbUpdatedBones == false ||
-					(mbSkeletonPhysics && !mbSkeletonPhysicsSleeping))
+				if(mbAnimationPoseUpdated)
 				{
-					for(size_t i=0;i < mvBoneStates.size(); i++)
-					{
-						cNode3D *pState = mvBoneStates[i];
-						cBone* pBone = mpMesh->GetSkeleton()->GetBoneByIndex((int)i);
-
-						if(pState->IsActive())
-						{
-							pState->SetMatrix(pBone->GetLocalTransform(),false);
-						}
-						
-						//can optimize this by doing it in the order of the tree
-						//and using recursive. (should be enough as is...)
-						if(mbSkeletonPhysics && mfSkeletonPhysicsWeight!=1.0f)
-						{
-							mvTempBoneStates[i]->SetMatrix(pBone->GetLocalTransform(),false);
-						}
-					}
-
-					bUpdateTransform = true;
+					bUpdateTransform = mbAnimationPoseTransformUpdated;
+					mbAnimationPoseUpdated = false;
+					UpdateAnimationStates(afTimeStep);
 				}
-
-				///////////////////////////
-				// Update skeleton physics
-				if(	mbSkeletonPhysics && (!mbSkeletonPhysicsSleeping || mbUpdatedBones==false))
+				else if(IsAnimationPoseFrame() || bPoseThrownAway)
 				{
-					mbUpdatedBones = true;
-					cNode3DIterator BoneIt = mpBoneStateRoot->GetChildIterator();
-					while(BoneIt.HasNext())
-					{
-						cBoneState *pBoneState = static_cast<cBoneState*>(BoneIt.Next());
-	                    
-						SetBoneMatrixFromBodyRec(mpBoneStateRoot->GetWorldMatrix(),pBoneState);
-					}
-					
-					//Interpolate matrices
-					if(mfSkeletonPhysicsWeight!=1.0f)
-					{	
-						for(size_t i=0;i < mvBoneStates.size(); i++)
-						{
-							cMatrixf mtxMixLocal = cMath::MatrixSlerp(	mfSkeletonPhysicsWeight,
-																		mvTempBoneStates[i]->GetLocalMatrix(),
-																		mvBoneStates[i]->GetLocalMatrix(),
-																		true);
-							
-							mvBoneStates[i]->SetMatrix(mtxMixLocal, false);
-						}
-					}
+					bUpdateTransform = UpdateSkeletonPose(afTimeStep, bAnimationActive, true);
 				}
-
-				//////////////////////////////////
-				//Go the weight mul (in case weights are normalized!)
-				float fAnimationWeightMul = GetAnimationWeightMul();
-
-				//////////////////////////////////
-				//Go through all animations states and update the bones 
-				for(size_t i=0; i< mvAnimationStates.size(); i++)
+				else
 				{
-					cAnimationState *pAnimState = mvAnimationStates[i];
-
-					if(pAnimState->IsActive())
-					{
-						cAnimation *pAnim = pAnimState->GetAnimation();
-
-						/////////////////////////////////////
-						//Go through all tracks in animation and apply to nodes
-						for(int i=0; i<pAnim->GetTrackNum(); i++)
-						{
-							cAnimationTrack *pTrack = pAnim->GetTrack(i);
-							
-							///////////////////////////////////
-							//If index not yet set, get it!
-							if(pTrack->GetNodeIndex()==-1)
-							{
-								int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(pTrack->GetName());
-								if(lBoneIdx==-1)
-								{
-									// XXX: This line is commented to avoid log clutter 
-									//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", pTrack->GetName().c_str(), mpMesh->GetName().c_str());
-									pTrack->SetNodeIndex(-2);
-								}
-								else
-									pTrack->SetNodeIndex(lBoneIdx);
-							}
-							
-							cNode3D* pState = GetBoneState(pTrack->GetNodeIndex());
-							
-							///////////////////////////////////
-							//Apply the animation track to node.
-							if(pState && pState->IsActive())
-							{
-								pTrack->ApplyToNode(pState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul, pAnimState->IsLooping());
-							}
-						}
-
-					
-						pAnimState->Update(afTimeStep);
-					}
+					//Hold the pose, but keep the animations going so time and events are the same as when updated.
+					UpdateAnimationStates(afTimeStep);
+					bPoseSkipped = true;
 				}
-				
-				//////////////////////////////////
-				//Go through all states and update the matrices (and thereby adding the animations together).
-				if(bAnimationActive)
-				{
-					cNode3DIterator NodeIt = mpBoneStateRoot->GetChildIterator();
-					while(NodeIt.HasNext())
-					{
-						cNode3D *pBoneState = static_cast<cNode3D*>(NodeIt.Next());
-						UpdateNodeMatrixRec(pBoneState);
-					}
 
-					//Entities are updated after BV is calculated, as the entity has the rootnode attached to it.
-				}
+				//A held pose still moves with the entity, so attached entities and colliders must follow it.
+				bool bBonesMoved = bPoseSkipped==false || mlBoneChildrenTransformCount != GetTransformUpdateCount();
+				mlBoneChildrenTransformCount = GetTransformUpdateCount();
 
 				////////////////////////////
 				//Update attached entities
-				if(bAnimationActive || mbSkeletonPhysics)
+				if((bAnimationActive && bBonesMoved) || mbSkeletonPhysics)
 				{
 					for(size_t i=0;i < mvBoneStates.size(); i++)
 					{
@@ -552,7 +747,7 @@ namespace hpl {
 				//////////////////////////////////
 				//Update the colliders if they are active
 				//Note this must be done after all bone states are updated.
-				if(mbSkeletonColliders && mbSkeletonPhysics==false)
+				if(mbSkeletonColliders && mbSkeletonPhysics==false && bBonesMoved)
 				{
 					for(size_t i=0;i < mvBoneStates.size(); i++)
 					{
@@ -680,8 +875,14 @@ namespace hpl {
 				{
 					cAnimationEvent *pEvent = pState->GetEvent(j);
 
-					if(	pEvent->mfTime >= pState->GetPreviousTimePosition() &&
-						pEvent->mfTime < pState->GetTimePosition())
+					//If the animation looped, the events from the previous position to the end and from the start are passed.
+					bool bPassed = false;
+					if(pState->GetTimePosition() >= pState->GetPreviousTimePosition())
+						bPassed = pEvent->mfTime >= pState->GetPreviousTimePosition() && pEvent->mfTime < pState->GetTimePosition();
+					else if(pState->IsLooping())
+						bPassed = pEvent->mfTime >= pState->GetPreviousTimePosition() || pEvent->mfTime < pState->GetTimePosition();
+					
+					if(bPassed)
 					{
 						HandleAnimationEvent(pEvent);
 					}
@@ -691,7 +892,9 @@ namespace hpl {
 
 		/////////////////////////////////////////
 		/// Final things
-		if(mpMesh->GetSkeleton()) mbBoneMatricesNeedUpdate = true;
+		if(mpMesh->GetSkeleton() && bPoseSkipped==false) mbBoneMatricesNeedUpdate = true;
+
+		mlAnimationUpdateCount++;
 	}
 
 	//-----------------------------------------------------------------------
@@ -1178,6 +1381,7 @@ namespace hpl {
 
 		mlBoneMatricesTransformCount = GetTransformUpdateCount();
 		mbBoneMatricesNeedUpdate = false;
+		mlBoneMatricesUpdateCount++;
 
 		///////////////////////////////////
 		//Update the bone matrices
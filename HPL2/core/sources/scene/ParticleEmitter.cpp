@@ -152,6 +152,7 @@ namespace hpl {
 
 		mbUpdateGfx = true;
 		mbUpdateBV = true;
+		mbCallbacksDeferred = false;
 
 		mlDirectionUpdateCount = -1;
 		mvDirection = cVector3f(0,0,0);
@@ -227,7 +228,7 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 
 	//Seems like this fucntion is never called any more...
-	void iParticleEmitter::UpdateLogic(float afTimeStep)
+	void iParticleEmitter::UpdateLogic(float afTimeStep, bool abDeferCallbacks)
 	{
 		if(IsActive()==false) return;
 
@@ -262,7 +263,18 @@ namespace hpl {
 
 		UpdateMotion(afTimeStep);
 
-		SetTransformUpdated();
+		SetTransformUpdated(abDeferCallbacks==false);
+		if(abDeferCallbacks) mbCallbacksDeferred = true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iParticleEmitter::RunDeferredCallbacks()
+	{
+		if(mbCallbacksDeferred==false) return;
+		mbCallbacksDeferred = false;
+
+		RunTransformUpdateCallbacks();
 	}
 
 	//-----------------------------------------------------------------------
@@ -395,23 +395,40 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	bool cParticleEmitterData_UserData::OnIntersect(iPhysicsBody *pBody,cPhysicsRayParams *apParams)
+	/**
+	 * Kept on the stack so that emitters sharing data can be updated from several threads.
+	 */
+	class cParticleCollisionRayCallback : public iPhysicsRayCallback
 	{
-		if(pBody->IsActive()==false || pBody->GetCollide()==false || pBody->IsCharacter())
-		{
-			return true;
-		}
+	public:
+		cParticleCollisionRayCallback(cVector3f *apPosVec, cVector3f *apNormalVec) : 
+				mfShortestDist(99999.0f), mbIntersected(false), mpIntersectNormal(apNormalVec), mpIntersectPos(apPosVec) {}
 
-		if(mfShortestDist > apParams->mfDist)
+		bool OnIntersect(iPhysicsBody *pBody,cPhysicsRayParams *apParams)
 		{
-			mbIntersected = true;
-			mfShortestDist = apParams->mfDist;
-			*mpIntersectPos = apParams->mvPoint;
-			*mpIntersectNormal = apParams->mvNormal;
+			if(pBody->IsActive()==false || pBody->GetCollide()==false || pBody->IsCharacter())
+			{
+				return true;
+			}
+
+			if(mfShortestDist > apParams->mfDist)
+			{
+				mbIntersected = true;
+				mfShortestDist = apParams->mfDist;
+				*mpIntersectPos = apParams->mvPoint;
+				*mpIntersectNormal = apParams->mvNormal;
+			}
+
+			return true;		
 		}
 
-		return true;		
-	}
+		float mfShortestDist;
+		bool mbIntersected;
+		cVector3f *mpIntersectNormal;
+		cVector3f *mpIntersectPos;
+	};
+
+	//-----------------------------------------------------------------------
 
 	bool cParticleEmitterData_UserData::CheckCollision(	const cVector3f& avStart, 
 																const cVector3f &avEnd,
@@ -419,16 +436,11 @@ namespace hpl {
 																cVector3f *apNormalVec,
 																cVector3f *apPosVec)
 	{
-		cVector3f vNormal;
-		mfShortestDist = 99999.0f;
-		mbIntersected = false;
-
-		mpIntersectPos = apPosVec;
-		mpIntersectNormal = apNormalVec;
+		cParticleCollisionRayCallback rayCallback(apPosVec, apNormalVec);
 
-		apPhysicsWorld->CastRay(this,avStart,avEnd,true,true,true);
+		apPhysicsWorld->CastRay(&rayCallback,avStart,avEnd,true,true,true);
 
-		return mbIntersected;
+		return rayCallback.mbIntersected;
 	}
 	
 	//-----------------------------------------------------------------------
@@ -291,7 +291,7 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 	
-	void cParticleSystem::UpdateLogic(float afTimeStep)
+	void cParticleSystem::UpdateLogic(float afTimeStep, bool abDeferCallbacks)
 	{
 		if(IsActive()==false) return;
 
@@ -312,7 +312,7 @@ namespace hpl {
 
 					while(fTime >0)
 					{
-						pPE->UpdateLogic(fStepSize);
+						pPE->UpdateLogic(fStepSize, abDeferCallbacks);
 						fTime -= fStepSize;
 					}
 				}
@@ -320,7 +320,7 @@ namespace hpl {
 			
 			//////////////////////////
 			//Update
-			pPE->UpdateLogic(afTimeStep);
+			pPE->UpdateLogic(afTimeStep, abDeferCallbacks);
 		}
 
 		//No loner first time!
@@ -329,6 +329,16 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cParticleSystem::RunDeferredCallbacks()
+	{
+		for(size_t i=0; i< mvEmitters.size(); ++i)
+		{
+			mvEmitters[i]->RunDeferredCallbacks();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cParticleSystem::AddEmitter(iParticleEmitter* apEmitter)
 	{
 		mvEmitters.push_back(apEmitter);
@@ -827,8 +827,17 @@ namespace hpl {
 		// Update tree for objects that have moved
 		if(m_setObjectsToUpdate.empty()==false)
 		{
+			//Update the bounding volumes of all moved objects in one pass first.
+			mvObjectsToUpdateBVs.resize(0);
 			tRenderableSetIt it = m_setObjectsToUpdate.begin();
 			for(; it != m_setObjectsToUpdate.end(); ++it)
+			{
+				mvObjectsToUpdateBVs.push_back((*it)->GetBoundingVolume());
+			}
+			cBoundingVolume::UpdateSizes(&mvObjectsToUpdateBVs[0], mvObjectsToUpdateBVs.size());
+
+			it = m_setObjectsToUpdate.begin();
+			for(; it != m_setObjectsToUpdate.end(); ++it)
 			{
 				iRenderable *pObject = *it;
 				
@@ -256,6 +256,8 @@ namespace hpl {
 				
 				if(pRenderer && pViewPort->GetWorld() && pFrustum)
 				{
+					pViewPort->GetWorld()->SetAnimationLODCameraPosition(pFrustum->GetOrigin());
+
 					START_TIMING(RenderWorld)
 					pRenderer->Render(	afFrameTime,pFrustum,
 										pViewPort->GetWorld(),pViewPort->GetRenderSettings(), 
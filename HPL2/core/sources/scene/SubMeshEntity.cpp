@@ -57,17 +57,20 @@ namespace hpl {
 		mpMaterialManager = apMaterialManager;
 
 		mbGraphicsUpdated = false;
+		mlSkinnedBoneMatricesCount = -1;
 
 		if(mpMeshEntity->GetMesh()->GetSkeleton())
 		{
 			mpDynVtxBuffer = mpSubMesh->GetVertexBuffer()->CreateCopy(eVertexBufferType_Hardware,eVertexBufferUsageType_Dynamic,eFlagBit_All);
-			mvDynTriangles = *mpSubMesh->GetTriangleVecPtr();
 		}
 		else
 		{
 			mpDynVtxBuffer = NULL;
 		}
 
+		mpDynTriangles = NULL;
+		mlDynTrianglesBoneMatricesCount = -1;
+
 		mpLocalNode = NULL;
 
 		mpEntityCallback = hplNew( cSubMeshEntityBodyUpdate, () );
@@ -89,6 +92,7 @@ namespace hpl {
 		hplDelete(mpEntityCallback);
 
 		if(mpDynVtxBuffer) hplDelete(mpDynVtxBuffer);
+		if(mpDynTriangles) hplDelete(mpDynTriangles);
 
 		/* Clear any custom textures here*/	
 		if(mpMaterial) mpMaterialManager->Destroy(mpMaterial);
@@ -199,7 +203,14 @@ namespace hpl {
 				return;
 			}
 			
+			//Skip if the bone matrices have not changed since last skinning (for instance when the pose is held).
+			if(mbGraphicsUpdated && mlSkinnedBoneMatricesCount == mpMeshEntity->mlBoneMatricesUpdateCount)
+			{
+				return;
+			}
+			
 			mbGraphicsUpdated = true;
+			mlSkinnedBoneMatricesCount = mpMeshEntity->mlBoneMatricesUpdateCount;
 
 			const float *pBindPos = mpSubMesh->GetVertexBuffer()->GetFloatArray(eVertexBufferElement_Position);
 			const float *pBindNormal = mpSubMesh->GetVertexBuffer()->GetFloatArray(eVertexBufferElement_Normal);
@@ -273,15 +284,6 @@ namespace hpl {
 
 			//Update buffer
 			mpDynVtxBuffer->UpdateData(eVertexElementFlag_Position | eVertexElementFlag_Normal | eVertexElementFlag_Texture1,false);
-			
-			//No stencil shadows:
-			/*if(mpMeshEntity->GetRenderFlagBit(eRenderableFlag_ShadowCaster))
-			{
-				//Update triangles
-				cMath::CreateTriangleData(mvDynTriangles,
-					mpDynVtxBuffer->GetIndices(), mpDynVtxBuffer->GetIndexNum(),
-					pSkinPosArray, lVtxStride, lVtxNum);
-			}*/
 		}
 		
 	}
@@ -401,25 +403,41 @@ namespace hpl {
 
 	cTriangleData& cSubMeshEntity::GetTriangle(int alIndex)
 	{ 
-		if(mpDynVtxBuffer)
-			return mvDynTriangles[alIndex];
-		else
-			return (*mpSubMesh->GetTriangleVecPtr())[alIndex];
+		return (*GetTriangleVecPtr())[alIndex];
 	}
 	int cSubMeshEntity::GetTriangleNum()
 	{ 
-		if(mpDynVtxBuffer)
-			return (int)mvDynTriangles.size();
-		else
-			return (int)mpSubMesh->GetTriangleVecPtr()->size();
+		return (int)GetTriangleVecPtr()->size();
 	}
 
 	tTriangleDataVec* cSubMeshEntity::GetTriangleVecPtr()
 	{ 
-		if(mpDynVtxBuffer)
-			return &mvDynTriangles;
-		else
-			return mpSubMesh->GetTriangleVecPtr();
+		if(mpDynVtxBuffer==NULL) return mpSubMesh->GetTriangleVecPtr();
+
+		////////////////////////////
+		// Create from the skinned positions, and update if skinned again since
+		if(mpDynTriangles==NULL) mpDynTriangles = hplNew( tTriangleDataVec, () );
+
+		if(mlDynTrianglesBoneMatricesCount != mlSkinnedBoneMatricesCount || mpDynTriangles->empty())
+		{
+			mlDynTrianglesBoneMatricesCount = mlSkinnedBoneMatricesCount;
+
+			cMath::CreateTriangleData(	*mpDynTriangles, mpDynVtxBuffer->GetIndices(), mpDynVtxBuffer->GetIndexNum(),
+										mpDynVtxBuffer->GetFloatArray(eVertexBufferElement_Position),
+										mpDynVtxBuffer->GetElementNum(eVertexBufferElement_Position),
+										mpDynVtxBuffer->GetVertexNum());
+		}
+		return mpDynTriangles;
+	}
+
+	void cSubMeshEntity::DestroyTriangleData()
+	{
+		if(mpDynTriangles)
+		{
+			hplDelete(mpDynTriangles);
+			mpDynTriangles = NULL;
+		}
+		mlDynTrianglesBoneMatricesCount = -1;
 	}
 	
 	//-----------------------------------------------------------------------
@@ -71,6 +71,7 @@
 
 #include "system/System.h"
 #include "system/Platform.h"
+#include "system/JobManager.h"
 
 #include "sound/SoundEntityData.h"
 #include "sound/Sound.h"
@@ -91,6 +92,62 @@
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// UPDATE JOB
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	enum eWorldUpdateJobType
+	{
+		eWorldUpdateJobType_AnimationPose,
+		eWorldUpdateJobType_Particles,
+		eWorldUpdateJobType_Lights,
+	};
+
+	// Number of render frames that an entity counts as visible after it was last rendered.
+	static const int glAnimationLODVisibleFrames = 3;
+
+	// Less than this and the update is not split into jobs.
+	static const int glMinItemsForUpdateJobs = 8;
+	static const int glMinItemsPerUpdateJob = 4;
+
+	//-----------------------------------------------------------------------
+
+	class cWorldUpdateJob : public iJob
+	{
+	public:
+		void Execute(int alThreadIndex)
+		{
+			//Particles and lights use the rand funcs, which must not use rand() outside of the main thread.
+			cMath::SetThreadRandomSeed(mlRandomSeed);
+
+			for(int i=mlStart; i<mlEnd; ++i)
+			{
+				switch(mType)
+				{
+				case eWorldUpdateJobType_AnimationPose:	(*mpMeshEntities)[i]->UpdateAnimationPose(mfTimeStep); break;
+				case eWorldUpdateJobType_Particles:		(*mpParticleSystems)[i]->UpdateLogic(mfTimeStep, true); break;
+				case eWorldUpdateJobType_Lights:		(*mpLights)[i]->UpdateFadeAndFlicker(mfTimeStep); break;
+				}
+			}
+
+			cMath::SetThreadRandomSeed(0);
+		}
+
+		eWorldUpdateJobType mType;
+		int mlStart;
+		int mlEnd;
+		float mfTimeStep;
+		unsigned int mlRandomSeed;
+
+		std::vector<cMeshEntity*> *mpMeshEntities;
+		std::vector<cParticleSystem*> *mpParticleSystems;
+		std::vector<iLight*> *mpLights;
+	};
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -122,6 +179,11 @@ namespace hpl {
 
 		mlSoundCreationIDCount =0;
 
+		mbAnimationLODActive = true;
+		mfAnimationLODHalfRateDist = 20;
+		mfAnimationLODFrozenDist = 50;
+		mbAnimationLODCameraSet = false;
+
 		//TODO: Have the container type as param and create.
 		mpRenderableContainer[eWorldContainerType_Static] = hplNew( cRenderableContainer_BoxTree, () );
 		mpRenderableContainer[eWorldContainerType_Dynamic] = hplNew( cRenderableContainer_DynBoxTree, () );
@@ -173,6 +235,8 @@ namespace hpl {
 		}
 
 		hplDelete(mpRootNode);
+
+		STLDeleteAll(mvUpdateJobs);
 	}
 
 	//-----------------------------------------------------------------------
@@ -1168,11 +1232,10 @@ namespace hpl {
 				cDate dateMapFile = cPlatform::FileModifiedDate(sMapPath);
 				cDate dateAIFile = cPlatform::FileModifiedDate(sAiFileName);
 
-				if(dateAIFile > dateMapFile || cResources::GetForceCacheLoadingAndSkipSaving())
-				{
-					bLoadedFromFile = true;
-					pContainer->LoadFromFile(sAiFileName);
-				}
+				//Binary files are checked against the nodes and static geometry, so they are used even if the
+				//map has been saved since. Old XML files still need to be newer than the map.
+				bool bFileIsNewer = dateAIFile > dateMapFile || cResources::GetForceCacheLoadingAndSkipSaving();
+				bLoadedFromFile = pContainer->LoadFromFile(sAiFileName, bFileIsNewer);
 			}
 			
 			if(bLoadedFromFile==false)
@@ -1323,14 +1386,34 @@ namespace hpl {
 
 	void cWorld::UpdateParticles(float afTimeStep)
 	{
+		//////////////////////////
+		// Update the systems as jobs. The world transforms are calculated first, since systems can share parents.
+		// The render container is not thread safe, so it is told about the moved emitters after the jobs are done.
+		mvTempUpdateParticleSystems.clear();
+		for(tParticleSystemListIt it = mlstParticleSystems.begin(); it != mlstParticleSystems.end(); ++it)
+		{
+			cParticleSystem *pPS = *it;
+			if(pPS->IsActive()==false) continue;
+			
+			for(int i=0; i< pPS->GetEmitterNum();++i) pPS->GetEmitter(i)->GetWorldMatrix();
+			mvTempUpdateParticleSystems.push_back(pPS);
+		}
+
+		RunUpdateJobs(eWorldUpdateJobType_Particles, (int)mvTempUpdateParticleSystems.size(), afTimeStep);
+
+		for(size_t i=0; i<mvTempUpdateParticleSystems.size(); ++i)
+		{
+			mvTempUpdateParticleSystems[i]->RunDeferredCallbacks();
+		}
+
+		//////////////////////////
+		// Remove dead systems
 		tParticleSystemListIt it = mlstParticleSystems.begin();
 
 		while(it != mlstParticleSystems.end())
 		{
 			cParticleSystem *pPS = *it;
 
-			pPS->UpdateLogic(afTimeStep);
-
 			//Check if the system is alive, else destroy
 			if(pPS->GetRemoveWhenDead() && pPS->IsDead())
 			{
@@ -1352,6 +1435,29 @@ namespace hpl {
 
 	void cWorld::UpdateEntities(float afTimeStep)
 	{
+		//////////////////////////
+		// Calculate skeleton poses as jobs, the rest of the update touches other entities and is done below.
+		mvTempUpdateMeshEntities.clear();
+		for(tMeshEntityListIt it = mlstDynamicMeshEntities.begin(); it != mlstDynamicMeshEntities.end(); ++it)
+		{
+			cMeshEntity *pEntity = *it;
+			if(pEntity->IsActive()==false) continue;
+			
+			UpdateAnimationLOD(pEntity);
+			
+			if(pEntity->CanUpdateAnimationPoseInParallel())
+			{
+				pEntity->SetupAnimationTrackIndices();
+				mvTempUpdateMeshEntities.push_back(pEntity);
+			}
+		}
+
+		if((int)mvTempUpdateMeshEntities.size() >= glMinItemsForUpdateJobs)
+			RunUpdateJobs(eWorldUpdateJobType_AnimationPose, (int)mvTempUpdateMeshEntities.size(), afTimeStep);
+
+		//////////////////////////
+		// Update logic
+
 		//static size_t lLastSize = 0;
 		//bool bRenderDebug = lLastSize != mlstDynamicMeshEntities.size() && mlstDynamicMeshEntities.size()>=2;
 		//if(mlstDynamicMeshEntities.size()>=2) lLastSize = mlstDynamicMeshEntities.size();
@@ -1378,6 +1484,20 @@ namespace hpl {
 
 	void cWorld::UpdateLights(float afTimeStep)
 	{
+		//////////////////////////
+		// Fading and flickering is calculated as jobs and then applied in UpdateLogic.
+		mvTempUpdateLights.clear();
+		for(tLightListIt it = mlstLights.begin(); it != mlstLights.end(); ++it)
+		{
+			iLight *pLight = *it;
+			if(pLight->IsActive()) mvTempUpdateLights.push_back(pLight);
+		}
+
+		if((int)mvTempUpdateLights.size() >= glMinItemsForUpdateJobs)
+			RunUpdateJobs(eWorldUpdateJobType_Lights, (int)mvTempUpdateLights.size(), afTimeStep);
+
+		//////////////////////////
+		// Update logic
 		tLightListIt it = mlstLights.begin();
 
 		while(it != mlstLights.end())
@@ -1392,6 +1512,68 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cWorld::UpdateAnimationLOD(cMeshEntity *apEntity)
+	{
+		if(mbAnimationLODActive==false || mbAnimationLODCameraSet==false || apEntity->GetMesh()->GetSkeleton()==NULL)
+		{
+			apEntity->SetAnimationUpdateInterval(1);
+			return;
+		}
+
+		float fDistSqr = cMath::Vector3DistSqr(apEntity->GetWorldPosition(), mvAnimationLODCameraPos);
+		bool bVisible = iRenderer::GetRenderFrameCount() - apEntity->GetLastRenderFrameCount() <= glAnimationLODVisibleFrames;
+		//Lights, billboards, etc attached to the bones might be seen even if the mesh is not.
+		if(bVisible==false && apEntity->HasBoneEntityChildren()) bVisible = true;
+		
+		int lInterval =1;
+		if(bVisible)	lInterval = fDistSqr < mfAnimationLODHalfRateDist*mfAnimationLODHalfRateDist ? 1 : 2;
+		else			lInterval = fDistSqr < mfAnimationLODFrozenDist*mfAnimationLODFrozenDist ? 2 : 0;
+		
+		apEntity->SetAnimationUpdateInterval(lInterval);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cWorld::RunUpdateJobs(int alType, int alNum, float afTimeStep)
+	{
+		if(alNum <= 0) return;
+
+		cJobManager *pJobManager = mpSystem ? mpSystem->GetJobManager() : NULL;
+		int lNumOfJobs = 1;
+		if(pJobManager && pJobManager->GetNumOfWorkers()>0 && alNum >= glMinItemsForUpdateJobs)
+		{
+			lNumOfJobs = cMath::Min(pJobManager->GetNumOfThreads(), alNum / glMinItemsPerUpdateJob);
+		}
+		
+		while((int)mvUpdateJobs.size() < lNumOfJobs) mvUpdateJobs.push_back(hplNew(cWorldUpdateJob, ()) );
+
+		int lItemsPerJob = (alNum + lNumOfJobs-1) / lNumOfJobs;
+		for(int i=0; i<lNumOfJobs; ++i)
+		{
+			cWorldUpdateJob *pJob = mvUpdateJobs[i];
+			pJob->mType = (eWorldUpdateJobType)alType;
+			pJob->mlStart = i*lItemsPerJob;
+			pJob->mlEnd = cMath::Min(alNum, (i+1)*lItemsPerJob);
+			pJob->mfTimeStep = afTimeStep;
+			pJob->mlRandomSeed = (unsigned int)cMath::RandRectl(1, 0x7fff);
+			pJob->mpMeshEntities = &mvTempUpdateMeshEntities;
+			pJob->mpParticleSystems = &mvTempUpdateParticleSystems;
+			pJob->mpLights = &mvTempUpdateLights;
+		}
+
+		if(lNumOfJobs==1)
+		{
+			mvUpdateJobs[0]->Execute(kJobThreadIndex_Main);
+			return;
+		}
+
+		cJobCounter counter;
+		for(int i=0; i<lNumOfJobs; ++i) pJobManager->AddJob(mvUpdateJobs[i], &counter);
+		pJobManager->WaitForCounter(&counter, kJobThreadIndex_Main);
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cWorld::UpdateSoundEntities(float afTimeStep)
 	{
 		tSoundEntityListIt it = mlstSoundEntities.begin();
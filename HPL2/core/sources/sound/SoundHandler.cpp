@@ -21,6 +21,8 @@
 
 #include "resources/Resources.h"
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/Timer.h"
 #include "system/String.h"
 #include "math/Math.h"
 #include "sound/LowLevelSound.h"
@@ -67,6 +69,48 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	//////////////////////////////////////////////////////////////////////////
+	// OCCLUSION JOB
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cSoundOcclusionJob::cSoundOcclusionJob()
+	{
+		mpPhysicsWorld = NULL;
+		mpQueries = NULL;
+		mlNumOfQueries = 0;
+		mfTime = 0;
+
+		mpTimer = cPlatform::CreateTimer();
+	}
+
+	cSoundOcclusionJob::~cSoundOcclusionJob()
+	{
+		hplDelete(mpTimer);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSoundOcclusionJob::Execute(int alThreadIndex)
+	{
+		mpTimer->Start();
+
+		for(int i=0; i<mlNumOfQueries; ++i)
+		{
+			cSoundOcclusionQuery &query = mpQueries[i];
+
+			mRayCallback.Reset();
+			mpPhysicsWorld->CastRay(&mRayCallback, query.mvStart, query.mvEnd, false,false,false,true);
+			query.mbBlocked = mRayCallback.HasCollided();
+		}
+
+		mpTimer->Stop();
+		mfTime = mpTimer->GetTimeInMilliSec();
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// SOUND ENTRY
 	//////////////////////////////////////////////////////////////////////////
@@ -110,6 +154,10 @@ namespace hpl {
 		mfBlockFadeDest = 1;
 		mfBlockFadeSpeed = 0;
 
+		mbBlocked = false;
+		mlLastOcclusionQueryFrame = -100000;
+		mlOcclusionQuery = -1;
+
 		mpCallback = NULL;
 
 		if(gbLogEntry)Log("Creating sound entry %d id: %d\n", this, mlId);
@@ -318,7 +366,20 @@ namespace hpl {
 
 		////////////////////////////////////////
 		// Check if sound is blocked
-		if(mpSoundHandler->CheckSoundIsBlocked(mpSound->GetPosition()))
+		// The first time this is checked right away, after that the sound is queried at an interval and 
+		// the result is ready at the next update.
+		if(mbFirstTime)
+		{
+			mbBlocked = mpSoundHandler->CheckSoundIsBlocked(mpSound->GetPosition());
+			mlLastOcclusionQueryFrame = mpSoundHandler->mlCount;
+		}
+		else if(mlOcclusionQuery < 0 &&
+				mpSoundHandler->mlCount - mlLastOcclusionQueryFrame >= mpSoundHandler->mlOcclusionQueryInterval)
+		{
+			mpSoundHandler->AddOcclusionQuery(this, mpSound->GetPosition());
+		}
+
+		if(mbBlocked)
 		{
 			mfBlockFadeDest = 0.0f;
 			mfBlockFadeSpeed = -1.0f / 0.55f;
@@ -477,6 +538,11 @@ namespace hpl {
 
 		mbSilent = false;
 
+		mlOcclusionQueryInterval = 4;
+		mlMaxOcclusionQueriesPerFrame = 32;
+		mlOcclusionQueriesLastFrame = 0;
+		mfOcclusionQueryTimeLastFrame = 0;
+
 		mfGlobalVolume[0] = 1;
 		mfGlobalVolume[1] = 1;
 		mfGlobalSpeed[0] = 1;
@@ -488,6 +554,7 @@ namespace hpl {
 	cSoundHandler::~cSoundHandler()
 	{
 		STLDeleteAll(m_lstSoundEntries);
+		STLDeleteAll(mvOcclusionJobs);
 	}
 
 	//-----------------------------------------------------------------------
@@ -531,6 +598,10 @@ namespace hpl {
 			}
 		}
 
+		///////////////////////////////////////////////
+		// Cast the rays queried by the entries, results are used next update.
+		UpdateOcclusionQueries();
+
 		mlCount++;
 	}
 	
@@ -928,6 +999,104 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cSoundHandler::AddOcclusionQuery(cSoundEntry *apEntry, const cVector3f& avSoundPosition)
+	{
+		if((int)mvOcclusionQueries.size() >= mlMaxOcclusionQueriesPerFrame) return false;
+		
+		apEntry->mlOcclusionQuery = (int)mvOcclusionQueries.size();
+		apEntry->mlLastOcclusionQueryFrame = mlCount;
+
+		cSoundOcclusionQuery query;
+		query.mvStart = avSoundPosition;
+		query.mvEnd = mpLowLevelSound->GetListenerPosition();
+		query.mbBlocked = false;
+		mvOcclusionQueries.push_back(query);
+		
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSoundHandler::UpdateOcclusionQueries()
+	{
+		mlOcclusionQueriesLastFrame = (int)mvOcclusionQueries.size();
+		mfOcclusionQueryTimeLastFrame = 0;
+		if(mvOcclusionQueries.empty()) return;
+
+		if(mpWorld==NULL || mpWorld->GetPhysicsWorld()==NULL)
+		{
+			for(size_t i=0; i<mvOcclusionQueries.size(); ++i) mvOcclusionQueries[i].mbBlocked = false;
+		}
+		else
+		{
+			CastOcclusionRays(mpWorld->GetPhysicsWorld());
+		}
+
+		//////////////////////////
+		// Give the results to the entries, entries that have been destroyed are simply skipped.
+		for(tSoundEntryListIt it = m_lstSoundEntries.begin(); it != m_lstSoundEntries.end(); ++it)
+		{
+			cSoundEntry *pEntry = *it;
+			if(pEntry->mlOcclusionQuery < 0) continue;
+
+			pEntry->mbBlocked = mvOcclusionQueries[pEntry->mlOcclusionQuery].mbBlocked;
+			pEntry->mlOcclusionQuery = -1;
+		}
+
+		mvOcclusionQueries.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cSoundHandler::CastOcclusionRays(iPhysicsWorld *apPhysicsWorld)
+	{
+		cJobManager *pJobManager = apPhysicsWorld->GetJobManager();
+
+		//////////////////////////
+		// Split the queries among the threads, with a minimum amount per job
+		const int lMinQueriesPerJob = 4;
+		int lNumOfQueries = (int)mvOcclusionQueries.size();
+		int lNumOfJobs = pJobManager ? cMath::Min(pJobManager->GetNumOfThreads(), (lNumOfQueries + lMinQueriesPerJob-1) / lMinQueriesPerJob) : 1;
+		if(pJobManager && pJobManager->GetNumOfWorkers()==0) lNumOfJobs = 1;
+
+		while((int)mvOcclusionJobs.size() < lNumOfJobs) mvOcclusionJobs.push_back(hplNew(cSoundOcclusionJob, ()) );
+
+		//Rounding up the size can leave the last jobs without any queries, so only use as many as are needed.
+		int lQueriesPerJob = (lNumOfQueries + lNumOfJobs-1) / lNumOfJobs;
+		lNumOfJobs = (lNumOfQueries + lQueriesPerJob-1) / lQueriesPerJob;
+		for(int i=0; i<lNumOfJobs; ++i)
+		{
+			cSoundOcclusionJob *pJob = mvOcclusionJobs[i];
+			int lStart = i*lQueriesPerJob;
+			
+			pJob->mpPhysicsWorld = apPhysicsWorld;
+			pJob->mpQueries = &mvOcclusionQueries[lStart];
+			pJob->mlNumOfQueries = cMath::Min(lQueriesPerJob, lNumOfQueries - lStart);
+			pJob->mfTime = 0;
+		}
+
+		//////////////////////////
+		// Cast the rays, one job means no need for threads
+		if(lNumOfJobs == 1)
+		{
+			mvOcclusionJobs[0]->Execute(kJobThreadIndex_Main);
+		}
+		else
+		{
+			//Bounding volumes are updated when read, so make sure the jobs only read them.
+			//The world must not change until the jobs are done, so wait right away.
+			apPhysicsWorld->UpdateBodyBoundingVolumes();
+
+			for(int i=0; i<lNumOfJobs; ++i)
+				pJobManager->AddJob(mvOcclusionJobs[i], &mOcclusionJobCounter);
+			pJobManager->WaitForCounter(&mOcclusionJobCounter, kJobThreadIndex_Main);
+		}
+
+		for(int i=0; i<lNumOfJobs; ++i) mfOcclusionQueryTimeLastFrame += mvOcclusionJobs[i]->mfTime;
+	}
+
+	//-----------------------------------------------------------------------
+
 	cSoundEntry* cSoundHandler::GetEntry(const tString& asName)
 	{
 		tString sLowName = cString::ToLowerCase(asName);
@@ -0,0 +1,365 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "system/JobManager.h"
+
+#include "system/Platform.h"
+#include "system/Mutex.h"
+#include "system/Semaphore.h"
+#include "system/LowLevelSystem.h"
+#include "system/MemoryManager.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// WORKER
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cJobWorker::cJobWorker(cJobManager *apManager, int alThreadIndex)
+	{
+		mpManager = apManager;
+		mlThreadIndex = alThreadIndex;
+
+		mpThread = cPlatform::CreateThread(this);
+		mpThread->SetSleepTime(0);
+	}
+
+	//-----------------------------------------------------------------------
+
+	cJobWorker::~cJobWorker()
+	{
+		hplDelete(mpThread);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobWorker::UpdateThread()
+	{
+		//Sleep until there is a job (or the manager is exiting)
+		mpManager->mpJobSemaphore->Wait();
+
+		//Check if exiting, if so signal so that the next worker also wakes up.
+		if(mpManager->mbExiting)
+		{
+			mpManager->mpJobSemaphore->Signal();
+			return;
+		}
+
+		//The job might already have been taken by a waiting thread, so this can fail.
+		mpManager->RunNextJob(mlThreadIndex);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cJobManager::cJobManager(int alNumOfWorkers)
+	{
+		mpMutex = cPlatform::CreateMutEx();
+		mpJobSemaphore = cPlatform::CreateSemaPhore(0);
+		mbExiting = false;
+		mlNextQueue = 0;
+
+		//One queue per thread, the first one is for the threads that are not workers.
+		for(int i=0; i<alNumOfWorkers+1; ++i)
+		{
+			cJobQueue *pQueue = hplNew( cJobQueue, () );
+			pQueue->mpMutex = cPlatform::CreateMutEx();
+			mvQueues.push_back(pQueue);
+		}
+
+		for(int i=0; i<alNumOfWorkers; ++i)
+		{
+			cJobWorker *pWorker = hplNew( cJobWorker, (this, i+1) );
+			mvWorkers.push_back(pWorker);
+			pWorker->GetThread()->Start();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	cJobManager::~cJobManager()
+	{
+		//Wake all workers up so they can see that we are exiting.
+		mbExiting = true;
+		mpJobSemaphore->Signal();
+
+		for(size_t i=0; i<mvWorkers.size(); ++i)
+		{
+			mvWorkers[i]->GetThread()->Stop();
+		}
+		STLDeleteAll(mvWorkers);
+
+		for(size_t i=0; i<mvQueues.size(); ++i)
+		{
+			hplDelete(mvQueues[i]->mpMutex);
+			hplDelete(mvQueues[i]);
+		}
+		STLDeleteAll(mvFreeWaiterSemaphores);
+
+		hplDelete(mpJobSemaphore);
+		hplDelete(mpMutex);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cJobManager::AddJob(iJob *apJob, cJobCounter *apCounter, int alThreadIndex)
+	{
+		mpMutex->Lock();
+		if(apCounter) apCounter->mlCount++;
+		mpMutex->Unlock();
+
+		QueueJob(cQueuedJob(apJob, apCounter), alThreadIndex);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobManager::AddDependentJob(iJob *apJob, cJobCounter *apCounter, cJobCounter *apDependency)
+	{
+		mpMutex->Lock();
+		if(apCounter) apCounter->mlCount++;
+		
+		//If the dependency is not done, wait with queuing until it is.
+		if(apDependency && apDependency->mlCount > 0)
+		{
+			mlstDependentJobs.push_back(cQueuedJob(apJob, apCounter, apDependency));
+			mpMutex->Unlock();
+			return;
+		}
+		mpMutex->Unlock();
+
+		QueueJob(cQueuedJob(apJob, apCounter), -1);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobManager::WaitForCounter(cJobCounter *apCounter, int alThreadIndex)
+	{
+		while(CounterIsDone(apCounter)==false)
+		{
+			//Help out while waiting, only threads with an index of their own can do that.
+			if(alThreadIndex >= 0 && RunNextJob(alThreadIndex)) continue;
+
+			//Without workers, jobs are only run by waiting threads, so this one cannot sleep.
+			if(mvWorkers.empty()) continue;
+
+			//No job is queued, so the remaining ones are being run by other threads.
+			SleepUntilCounterIsDone(apCounter);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cJobManager::CounterIsDone(cJobCounter *apCounter)
+	{
+		mpMutex->Lock();
+		bool bDone = apCounter->mlCount <= 0;
+		mpMutex->Unlock();
+
+		return bDone;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cJobManager::QueueJob(const cQueuedJob& aJob, int alThreadIndex)
+	{
+		int lQueue = alThreadIndex;
+		if(lQueue < 0 || lQueue >= (int)mvQueues.size())
+		{
+			mpMutex->Lock();
+			lQueue = mlNextQueue;
+			mlNextQueue = (mlNextQueue+1) % (int)mvQueues.size();
+			mpMutex->Unlock();
+		}
+
+		cJobQueue *pQueue = mvQueues[lQueue];
+		pQueue->mpMutex->Lock();
+		pQueue->mdqJobs.push_back(aJob);
+		pQueue->mpMutex->Unlock();
+
+		if(mvWorkers.empty()==false) mpJobSemaphore->Signal();
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cJobManager::PopJob(int alQueue, bool abFront, cQueuedJob *apJob)
+	{
+		cJobQueue *pQueue = mvQueues[alQueue];
+
+		pQueue->mpMutex->Lock();
+		if(pQueue->mdqJobs.empty())
+		{
+			pQueue->mpMutex->Unlock();
+			return false;
+		}
+		
+		if(abFront)
+		{
+			*apJob = pQueue->mdqJobs.front();
+			pQueue->mdqJobs.pop_front();
+		}
+		else
+		{
+			*apJob = pQueue->mdqJobs.back();
+			pQueue->mdqJobs.pop_back();
+		}
+		pQueue->mpMutex->Unlock();
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cJobManager::RunNextJob(int alThreadIndex)
+	{
+		int lQueueNum = (int)mvQueues.size();
+		int lOwnQueue = alThreadIndex < lQueueNum ? alThreadIndex : 0;
+
+		//////////////////////////
+		// Take the newest job from the own queue, else steal the oldest from the others.
+		cQueuedJob job(NULL, NULL);
+		bool bFound = PopJob(lOwnQueue, false, &job);
+		for(int i=1; i<lQueueNum && bFound==false; ++i)
+		{
+			bFound = PopJob((lOwnQueue + i) % lQueueNum, true, &job);
+		}
+		if(bFound==false) return false;
+
+		job.mpJob->Execute(alThreadIndex);
+
+		if(job.mpCounter==NULL) return true;
+
+		//////////////////////////
+		// Decrease counter and queue any jobs waiting for it.
+		std::vector<cQueuedJob> vReadyJobs;
+		
+		std::vector<iSemaphore*> vWakeSemaphores;
+
+		mpMutex->Lock();
+		job.mpCounter->mlCount--;
+		if(job.mpCounter->mlCount <= 0 && mlstCounterWaiters.empty()==false)
+		{
+			std::list<cCounterWaiter>::iterator it = mlstCounterWaiters.begin();
+			while(it != mlstCounterWaiters.end())
+			{
+				if(it->mpCounter == job.mpCounter)
+				{
+					vWakeSemaphores.push_back(it->mpSemaphore);
+					it = mlstCounterWaiters.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+		if(job.mpCounter->mlCount <= 0 && mlstDependentJobs.empty()==false)
+		{
+			std::list<cQueuedJob>::iterator it = mlstDependentJobs.begin();
+			while(it != mlstDependentJobs.end())
+			{
+				if(it->mpDependency == job.mpCounter)
+				{
+					vReadyJobs.push_back(cQueuedJob(it->mpJob, it->mpCounter));
+					it = mlstDependentJobs.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+		mpMutex->Unlock();
+
+		for(size_t i=0; i<vReadyJobs.size(); ++i)
+		{
+			QueueJob(vReadyJobs[i], alThreadIndex);
+		}
+
+		//The counter may be gone as soon as a waiter wakes up, so it must not be touched after this.
+		for(size_t i=0; i<vWakeSemaphores.size(); ++i)
+		{
+			vWakeSemaphores[i]->Signal();
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobManager::SleepUntilCounterIsDone(cJobCounter *apCounter)
+	{
+		//////////////////////////
+		// Add a waiter that the thread finishing the last job signals. 
+		// This is done under the same lock as the counter is decreased, so the signal cannot be missed.
+		mpMutex->Lock();
+		if(apCounter->mlCount <= 0)
+		{
+			mpMutex->Unlock();
+			return;
+		}
+
+		iSemaphore *pSemaphore = NULL;
+		if(mvFreeWaiterSemaphores.empty())
+		{
+			pSemaphore = cPlatform::CreateSemaPhore(0);
+		}
+		else
+		{
+			pSemaphore = mvFreeWaiterSemaphores.back();
+			mvFreeWaiterSemaphores.pop_back();
+		}
+
+		cCounterWaiter waiter;
+		waiter.mpCounter = apCounter;
+		waiter.mpSemaphore = pSemaphore;
+		mlstCounterWaiters.push_back(waiter);
+		mpMutex->Unlock();
+
+		//////////////////////////
+		// Sleep, the waiter is removed by the signaling thread.
+		pSemaphore->Wait();
+
+		mpMutex->Lock();
+		mvFreeWaiterSemaphores.push_back(pSemaphore);
+		mpMutex->Unlock();
+	}
+
+	//-----------------------------------------------------------------------
+
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "system/LinearAllocator.h"
+
+#include "system/MemoryManager.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cLinearAllocator::cLinearAllocator(size_t alBlockSize)
+	{
+		mlBlockSize = alBlockSize;
+		mlCurrentBlock = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cLinearAllocator::~cLinearAllocator()
+	{
+		for(size_t i=0; i<mvBlocks.size(); ++i)
+		{
+			hplDeleteArray(mvBlocks[i].mpData);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void* cLinearAllocator::Allocate(size_t alSize, size_t alAlign)
+	{
+		//////////////////////////
+		// Try the current and any later (already allocated) blocks
+		for(; mlCurrentBlock < mvBlocks.size(); ++mlCurrentBlock)
+		{
+			cLinearAllocatorBlock &block = mvBlocks[mlCurrentBlock];
+
+			size_t lAddress = (size_t)(block.mpData + block.mlUsed);
+			size_t lPadding = (alAlign - (lAddress % alAlign)) % alAlign;
+
+			if(block.mlUsed + lPadding + alSize <= block.mlSize)
+			{
+				void *pData = block.mpData + block.mlUsed + lPadding;
+				block.mlUsed += lPadding + alSize;
+				return pData;
+			}
+		}
+
+		//////////////////////////
+		// No room, add a block large enough for the data and any padding
+		AddBlock(alSize + alAlign);
+		return Allocate(alSize, alAlign);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLinearAllocator::Reset()
+	{
+		if(mvBlocks.size() > 1)
+		{
+			size_t lTotalSize = GetReservedSize();
+			for(size_t i=0; i<mvBlocks.size(); ++i)
+			{
+				hplDeleteArray(mvBlocks[i].mpData);
+			}
+			mvBlocks.clear();
+
+			AddBlock(lTotalSize);
+		}
+
+		for(size_t i=0; i<mvBlocks.size(); ++i)
+		{
+			mvBlocks[i].mlUsed = 0;
+		}
+		mlCurrentBlock = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	size_t cLinearAllocator::GetUsedSize()
+	{
+		size_t lSize = 0;
+		for(size_t i=0; i<mvBlocks.size(); ++i) lSize += mvBlocks[i].mlUsed;
+		return lSize;
+	}
+
+	size_t cLinearAllocator::GetReservedSize()
+	{
+		size_t lSize = 0;
+		for(size_t i=0; i<mvBlocks.size(); ++i) lSize += mvBlocks[i].mlSize;
+		return lSize;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cLinearAllocator::AddBlock(size_t alMinSize)
+	{
+		cLinearAllocatorBlock block;
+		block.mlSize = alMinSize > mlBlockSize ? alMinSize : mlBlockSize;
+		block.mpData = hplNewArray(char, block.mlSize);
+		block.mlUsed = 0;
+
+		mvBlocks.push_back(block);
+	}
+
+	//-----------------------------------------------------------------------
+
+};
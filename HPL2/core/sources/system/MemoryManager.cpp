@@ -21,6 +21,20 @@
 
 #include "system/LowLevelSystem.h"
 
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#ifdef _MSC_VER
+	#define HPL_MEMORY_THREAD_LOCAL __declspec(thread)
+#else
+	#define HPL_MEMORY_THREAD_LOCAL __thread
+#endif
+
 namespace hpl {
 
 
@@ -29,6 +43,212 @@ namespace hpl {
 	bool cMemoryManager::mbLogDeletion = false;
 	bool cMemoryManager::mbLogCreation = false;
 	int cMemoryManager::mlCreationCount =0;
+	int cMemoryManager::mlStatsSampleRate = 64;
+
+	//////////////////////////////////////////////////////////////////////////
+	// STATISTICS DATA
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * All of the stats data is plain static arrays, so it can be used by allocations made before main and
+	 * never allocates memory itself. Threads beyond the max share the last block (and may lose a few counts).
+	 * Frees are counted for the tag of the file doing the delete, since no per pointer data is kept, so the alloc and
+	 * free numbers of a tag only roughly match when memory is made in one subsystem and released in another.
+	 */
+	#define kMemoryStatsMaxThreads 32
+	#define kMemoryStatsMaxSamples 128
+	#define kMemoryStatsMaxTagNameLength 32
+	#define kMemoryStatsFileCacheSize 256
+
+	class cMemoryStatsSample
+	{
+	public:
+		const char *mpFile;
+		int mlLine;
+		int mlTag;
+		size_t mlMemory;
+	};
+
+	class cMemoryThreadStats
+	{
+	public:
+		size_t mvAllocCount[kMemoryStatsMaxTags];
+		size_t mvAllocBytes[kMemoryStatsMaxTags];
+		size_t mvFreeCount[kMemoryStatsMaxTags];
+
+		int mlSampleCount;
+		int mlSamplePos;
+		cMemoryStatsSample mvSamples[kMemoryStatsMaxSamples];
+	};
+
+	class cMemoryStatsFileCacheSlot
+	{
+	public:
+		const char *mpFile;
+		int mlTag;
+	};
+
+	static cMemoryThreadStats gvThreadStats[kMemoryStatsMaxThreads];
+	static volatile long glThreadStatsNum = 0;
+	static HPL_MEMORY_THREAD_LOCAL cMemoryThreadStats *gpCurrentThreadStats = NULL;
+
+	static char gvStatsTagNames[kMemoryStatsMaxTags][kMemoryStatsMaxTagNameLength] = { "other" };
+	static volatile long glStatsTagNum = 1;
+	static volatile long glStatsTagLock = 0;
+
+	//Kept per thread so it can be read without the lock.
+	static HPL_MEMORY_THREAD_LOCAL cMemoryStatsFileCacheSlot gvStatsFileCache[kMemoryStatsFileCacheSize];
+
+	static cMemoryStatsTag gvStatsTags[kMemoryStatsMaxTags];
+
+	//-----------------------------------------------------------------------
+
+	static long StatsAtomicIncrement(volatile long *apValue)
+	{
+	#ifdef WIN32
+		return InterlockedIncrement(apValue);
+	#else
+		return __sync_add_and_fetch(apValue, 1);
+	#endif
+	}
+
+	static void StatsLock()
+	{
+	#ifdef WIN32
+		while(InterlockedCompareExchange(&glStatsTagLock, 1, 0) != 0){}
+	#else
+		while(__sync_val_compare_and_swap(&glStatsTagLock, 0, 1) != 0){}
+	#endif
+	}
+
+	static void StatsUnlock()
+	{
+	#ifdef WIN32
+		InterlockedExchange(&glStatsTagLock, 0);
+	#else
+		__sync_lock_release(&glStatsTagLock);
+	#endif
+	}
+
+	//-----------------------------------------------------------------------
+
+	static cMemoryThreadStats* GetThreadStats()
+	{
+		if(gpCurrentThreadStats==NULL)
+		{
+			long lIdx = StatsAtomicIncrement(&glThreadStatsNum) - 1;
+			if(lIdx >= kMemoryStatsMaxThreads) lIdx = kMemoryStatsMaxThreads-1;
+
+			gpCurrentThreadStats = &gvThreadStats[lIdx];
+		}
+		return gpCurrentThreadStats;
+	}
+
+	//-----------------------------------------------------------------------
+
+	/**
+	 * The tag is the directory after "sources", "src" or "include" in the path, else the folder of the file.
+	 */
+	static void GetStatsTagNameFromFile(const char *apFile, char *apDest)
+	{
+		const char *pTagStart = NULL;
+		size_t lTagLength = 0;
+
+		const char *pPrevDir = NULL;
+		size_t lPrevDirLength = 0;
+		bool bPrevWasRoot = false;
+
+		const char *pComp = apFile;
+		while(*pComp)
+		{
+			const char *pCompEnd = pComp;
+			while(*pCompEnd && *pCompEnd != '/' && *pCompEnd != '\\') ++pCompEnd;
+			
+			//Only directories are used
+			if(*pCompEnd==0) break;
+
+			size_t lLength = pCompEnd - pComp;
+			if(bPrevWasRoot)
+			{
+				pTagStart = pComp;
+				lTagLength = lLength;
+			}
+			bPrevWasRoot =	(lLength==7 && strncmp(pComp, "sources",7)==0) ||
+							(lLength==3 && strncmp(pComp, "src",3)==0) ||
+							(lLength==7 && strncmp(pComp, "include",7)==0);
+
+			pPrevDir = pComp;
+			lPrevDirLength = lLength;
+			pComp = pCompEnd+1;
+		}
+
+		if(pTagStart==NULL)
+		{
+			pTagStart = pPrevDir;
+			lTagLength = lPrevDirLength;
+		}
+		if(pTagStart==NULL || lTagLength==0)
+		{
+			pTagStart = "other";
+			lTagLength = 5;
+		}
+
+		if(lTagLength > kMemoryStatsMaxTagNameLength-1) lTagLength = kMemoryStatsMaxTagNameLength-1;
+		memcpy(apDest, pTagStart, lTagLength);
+		apDest[lTagLength] = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static int GetStatsTagFromFile(const char *apFile)
+	{
+		////////////////////////////
+		// Check the thread's cache, __FILE__ strings have a fixed address.
+		size_t lSlot = (((size_t)apFile) >> 3) & (kMemoryStatsFileCacheSize-1);
+		cMemoryStatsFileCacheSlot &slot = gvStatsFileCache[lSlot];
+		if(slot.mpFile == apFile) return slot.mlTag;
+
+		////////////////////////////
+		// Find or add the tag
+		char sTagName[kMemoryStatsMaxTagNameLength];
+		GetStatsTagNameFromFile(apFile, sTagName);
+
+		StatsLock();
+
+		int lTag = -1;
+		for(int i=0; i<glStatsTagNum; ++i)
+		{
+			if(strcmp(gvStatsTagNames[i], sTagName)==0)
+			{
+				lTag = i;
+				break;
+			}
+		}
+		if(lTag < 0)
+		{
+			if(glStatsTagNum < kMemoryStatsMaxTags)
+			{
+				lTag = (int)glStatsTagNum;
+				memcpy(gvStatsTagNames[lTag], sTagName, kMemoryStatsMaxTagNameLength);
+				glStatsTagNum++;
+			}
+			else
+			{
+				lTag = 0;
+			}
+		}
+
+		slot.mlTag = lTag;
+		slot.mpFile = apFile;
+
+		StatsUnlock();
+
+		return lTag;
+	}
+
+	//-----------------------------------------------------------------------
 	
 	//////////////////////////////////////////////////////////////////////////
 	// ALLOCATED POINTER
@@ -177,5 +397,166 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void* cMemoryManager::AddStatsAllocation(void *apData, const char* apFile, int alLine, size_t alMemory)
+	{
+		if(apData==NULL) return NULL;
+
+		cMemoryThreadStats *pStats = GetThreadStats();
+		int lTag = GetStatsTagFromFile(apFile);
+
+		pStats->mvAllocCount[lTag]++;
+		pStats->mvAllocBytes[lTag] += alMemory;
+
+		if(mlStatsSampleRate > 0 && ++pStats->mlSampleCount >= mlStatsSampleRate)
+		{
+			pStats->mlSampleCount = 0;
+
+			cMemoryStatsSample &sample = pStats->mvSamples[pStats->mlSamplePos];
+			sample.mpFile = apFile;
+			sample.mlLine = alLine;
+			sample.mlTag = lTag;
+			sample.mlMemory = alMemory;
+			pStats->mlSamplePos = (pStats->mlSamplePos+1) % kMemoryStatsMaxSamples;
+		}
+
+		return apData;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void* cMemoryManager::UpdateStatsAllocation(void *apOldData, void *apNewData, const char* apFile, int alLine, size_t alMemory)
+	{
+		//A failed realloc keeps the old data, one with zero size frees it.
+		if(apNewData==NULL && alMemory > 0) return NULL;
+
+		AddStatsFree(apOldData, apFile);
+		return AddStatsAllocation(apNewData, apFile, alLine, alMemory);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryManager::AddStatsFree(const void *apData, const char* apFile)
+	{
+		if(apData==NULL) return;
+
+		GetThreadStats()->mvFreeCount[GetStatsTagFromFile(apFile)]++;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMemoryManager::UpdateFrameStats()
+	{
+		int lThreadNum = glThreadStatsNum < kMemoryStatsMaxThreads ? (int)glThreadStatsNum : kMemoryStatsMaxThreads;
+		int lTagNum = (int)glStatsTagNum;
+
+		for(int i=0; i<lTagNum; ++i)
+		{
+			size_t lAllocCount=0, lAllocBytes=0, lFreeCount=0;
+			for(int thread=0; thread<lThreadNum; ++thread)
+			{
+				cMemoryThreadStats &threadStats = gvThreadStats[thread];
+				lAllocCount += threadStats.mvAllocCount[i];
+				lAllocBytes += threadStats.mvAllocBytes[i];
+				lFreeCount += threadStats.mvFreeCount[i];
+			}
+
+			cMemoryStatsTag &tag = gvStatsTags[i];
+			tag.mlFrameAllocCount = lAllocCount - tag.mlTotalAllocCount;
+			tag.mlFrameAllocBytes = lAllocBytes - tag.mlTotalAllocBytes;
+			tag.mlFrameFreeCount = lFreeCount - tag.mlTotalFreeCount;
+
+			tag.mlTotalAllocCount = lAllocCount;
+			tag.mlTotalAllocBytes = lAllocBytes;
+			tag.mlTotalFreeCount = lFreeCount;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	class cMemoryStatsCallSite
+	{
+	public:
+		const char *mpFile;
+		int mlLine;
+		size_t mlCount;
+		size_t mlMemory;
+
+		bool operator<(const cMemoryStatsCallSite& aOther) const { return mlMemory > aOther.mlMemory; }
+	};
+
+	void cMemoryManager::LogFrameStats()
+	{
+		Log("\n|--Memory Stats Report--------------------------------|\n");
+		Log("| tag\t\t frame allocs\t frame bytes\t frame frees\t total allocs\t total bytes\n");
+		Log("|------------------------------------------------------------\n");
+		for(int i=0; i<GetStatsTagNum(); ++i)
+		{
+			const cMemoryStatsTag &tag = gvStatsTags[i];
+			if(tag.mlTotalAllocCount==0 && tag.mlTotalFreeCount==0) continue;
+
+			Log("| %-16s %lu\t\t %lu\t\t %lu\t\t %lu\t\t %lu\n", gvStatsTagNames[i],
+				(unsigned long)tag.mlFrameAllocCount, (unsigned long)tag.mlFrameAllocBytes, (unsigned long)tag.mlFrameFreeCount,
+				(unsigned long)tag.mlTotalAllocCount, (unsigned long)tag.mlTotalAllocBytes);
+		}
+
+		////////////////////////////
+		// Sum the recent samples per call site
+		std::vector<cMemoryStatsCallSite> vCallSites;
+		int lThreadNum = glThreadStatsNum < kMemoryStatsMaxThreads ? (int)glThreadStatsNum : kMemoryStatsMaxThreads;
+		for(int thread=0; thread<lThreadNum; ++thread)
+		{
+			for(int i=0; i<kMemoryStatsMaxSamples; ++i)
+			{
+				const cMemoryStatsSample &sample = gvThreadStats[thread].mvSamples[i];
+				if(sample.mpFile==NULL) continue;
+
+				size_t lSite=0;
+				for(; lSite<vCallSites.size(); ++lSite)
+				{
+					if(vCallSites[lSite].mpFile == sample.mpFile && vCallSites[lSite].mlLine == sample.mlLine) break;
+				}
+				if(lSite == vCallSites.size())
+				{
+					cMemoryStatsCallSite site;
+					site.mpFile = sample.mpFile;
+					site.mlLine = sample.mlLine;
+					site.mlCount = 0;
+					site.mlMemory = 0;
+					vCallSites.push_back(site);
+				}
+				vCallSites[lSite].mlCount++;
+				vCallSites[lSite].mlMemory += sample.mlMemory;
+			}
+		}
+		std::sort(vCallSites.begin(), vCallSites.end());
+
+		Log("|\n| Top sampled call sites (1 of %d allocations):\n", mlStatsSampleRate);
+		for(size_t i=0; i<vCallSites.size() && i<16; ++i)
+		{
+			Log("| %s:%d\t samples: %lu\t bytes: %lu\n", vCallSites[i].mpFile, vCallSites[i].mlLine,
+				(unsigned long)vCallSites[i].mlCount, (unsigned long)vCallSites[i].mlMemory);
+		}
+		Log("|------------------------------------------------------|\n\n");
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cMemoryManager::GetStatsTagNum()
+	{
+		return (int)glStatsTagNum;
+	}
+
+	const char* cMemoryManager::GetStatsTagName(int alIdx)
+	{
+		return gvStatsTagNames[alIdx];
+	}
+
+	const cMemoryStatsTag& cMemoryManager::GetStatsTag(int alIdx)
+	{
+		return gvStatsTags[alIdx];
+	}
+
+	//-----------------------------------------------------------------------
+
 
 }
@@ -286,6 +286,18 @@ namespace hpl {
 
 		if(apData==NULL) return;
 
+		//Use the cached element if there is one, saves walking all of the members.
+		const TiXmlElement* pCachedElem = apData->Serialize_GetCachedElement();
+		if(pCachedElem)
+		{
+			TiXmlElement* pCopyElem = static_cast<TiXmlElement*>(apParent->InsertEndChild(*pCachedElem));
+			pCopyElem->SetValue(abIsPointer ? "class_ptr" : "class");
+			pCopyElem->SetAttribute("name",asName.c_str());
+
+			if(gbLog) Log("---Saved class '%s' from cache---\n",apData->Serialize_GetTopClass().c_str());
+			return;
+		}
+
 		//Create element
 		TiXmlElement* pClassElem=NULL;
 
@@ -1328,6 +1328,197 @@ namespace hpl {
 	
 	//-----------------------------------------------------------------------
 
+	static inline bool IsValueSeparator(char c)
+	{
+		return c==' ' || c=='\n' || c=='\r' || c=='\t' || c==',';
+	}
+
+	static inline const char* SkipValueSeparators(const char* apString)
+	{
+		while(IsValueSeparator(*apString)) ++apString;
+		return apString;
+	}
+
+	static inline const char* SkipValue(const char* apString)
+	{
+		while(*apString && IsValueSeparator(*apString)==false) ++apString;
+		return apString;
+	}
+
+	static const double gvParsePow10[] = {	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+											1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	/**
+	 * Parses a float at the start of the string, returns a pointer to after the value.
+	 * Values with at most 15 significant digits and a small exponent are exact in a double, everything else goes to strtod.
+	 */
+	static const char* ParseFloatValue(const char* apString, float *apValue)
+	{
+		const char *pChar = apString;
+
+		bool bNegative = false;
+		if(*pChar == '-')		{ bNegative = true; ++pChar; }
+		else if(*pChar == '+')	{ ++pChar; }
+
+		unsigned long long lMantissa = 0;
+		int lDigits = 0;
+		int lExp = 0;
+		bool bHasDigits = false;
+
+		//Integer part
+		for(; *pChar >= '0' && *pChar <= '9'; ++pChar)
+		{
+			bHasDigits = true;
+			if(lDigits < 18)
+			{
+				lMantissa = lMantissa*10 + (*pChar - '0');
+				if(lMantissa) ++lDigits;
+			}
+			else
+			{
+				++lExp;
+				++lDigits;
+			}
+		}
+
+		//Fraction
+		if(*pChar == '.')
+		{
+			++pChar;
+			for(; *pChar >= '0' && *pChar <= '9'; ++pChar)
+			{
+				bHasDigits = true;
+				if(lDigits < 18)
+				{
+					lMantissa = lMantissa*10 + (*pChar - '0');
+					if(lMantissa) ++lDigits;
+					--lExp;
+				}
+				else
+				{
+					++lDigits;
+				}
+			}
+		}
+
+		//Exponent, only used if there are digits after the 'e'
+		if(bHasDigits && (*pChar == 'e' || *pChar == 'E'))
+		{
+			const char *pExpChar = pChar+1;
+			bool bNegativeExp = false;
+			if(*pExpChar == '-')		{ bNegativeExp = true; ++pExpChar; }
+			else if(*pExpChar == '+')	{ ++pExpChar; }
+
+			if(*pExpChar >= '0' && *pExpChar <= '9')
+			{
+				int lValueExp = 0;
+				for(; *pExpChar >= '0' && *pExpChar <= '9'; ++pExpChar)
+				{
+					if(lValueExp < 10000) lValueExp = lValueExp*10 + (*pExpChar - '0');
+				}
+				lExp += bNegativeExp ? -lValueExp : lValueExp;
+				pChar = pExpChar;
+			}
+		}
+
+		////////////////////////////
+		// Fast path
+		if(bHasDigits && lDigits <= 15 && lExp >= -22 && lExp <= 22)
+		{
+			double fValue = (double)lMantissa;
+			if(lExp < 0)	fValue /= gvParsePow10[-lExp];
+			else			fValue *= gvParsePow10[lExp];
+
+			*apValue = (float)(bNegative ? -fValue : fValue);
+			return pChar;
+		}
+
+		////////////////////////////
+		// Slow path, for long values, large exponents and things like "inf".
+		char *pEnd = NULL;
+		*apValue = (float)strtod(apString, &pEnd);
+		if(pEnd == apString) *apValue = 0;
+
+		return pEnd > pChar ? pEnd : pChar;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cString::ParseFloatArray(float *apArray, int alMaxSize, const char* apString, const char** apStringEnd)
+	{
+		int lCount = 0;
+		const char *pChar = apString;
+
+		if(pChar)
+		{
+			while(lCount < alMaxSize)
+			{
+				pChar = SkipValueSeparators(pChar);
+				if(*pChar == 0) break;
+
+				pChar = ParseFloatValue(pChar, &apArray[lCount]);
+				pChar = SkipValue(pChar); //Skip anything that is not part of the number
+				++lCount;
+			}
+		}
+
+		if(apStringEnd) *apStringEnd = pChar;
+		return lCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cString::ParseIntArray(int *apArray, int alMaxSize, const char* apString, const char** apStringEnd)
+	{
+		int lCount = 0;
+		const char *pChar = apString;
+
+		if(pChar)
+		{
+			while(lCount < alMaxSize)
+			{
+				pChar = SkipValueSeparators(pChar);
+				if(*pChar == 0) break;
+
+				bool bNegative = false;
+				if(*pChar == '-')		{ bNegative = true; ++pChar; }
+				else if(*pChar == '+')	{ ++pChar; }
+
+				int lValue = 0;
+				for(; *pChar >= '0' && *pChar <= '9'; ++pChar)
+				{
+					lValue = lValue*10 + (*pChar - '0');
+				}
+				apArray[lCount] = bNegative ? -lValue : lValue;
+
+				pChar = SkipValue(pChar);
+				++lCount;
+			}
+		}
+
+		if(apStringEnd) *apStringEnd = pChar;
+		return lCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cString::GetValueCount(const char* apString)
+	{
+		if(apString==NULL) return 0;
+
+		int lCount = 0;
+		const char *pChar = SkipValueSeparators(apString);
+		while(*pChar)
+		{
+			++lCount;
+			pChar = SkipValueSeparators(SkipValue(pChar));
+		}
+
+		return lCount;
+	}
+
+	//-----------------------------------------------------------------------
+
 	int cString::CountCharsInString(const tString& aString, const tString& aChar)
 	{
 		int lCount = 0;
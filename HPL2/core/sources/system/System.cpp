@@ -21,6 +21,9 @@
 #include "system/LowLevelSystem.h"
 #include "system/LogicTimer.h"
 #include "system/String.h"
+#include "system/JobManager.h"
+#include "system/Platform.h"
+#include "resources/BinaryBuffer.h"
 
 namespace hpl {
 	
@@ -33,6 +36,12 @@ namespace hpl {
 	cSystem::cSystem(iLowLevelSystem *apLowLevelSystem)
 	{
 		mpLowLevelSystem = apLowLevelSystem;
+
+		int lNumOfWorkers = cPlatform::GetNumberOfCores()-1;
+		mpJobManager = hplNew( cJobManager, (lNumOfWorkers) );
+		Log("  Created %d job workers\n", lNumOfWorkers);
+
+		cBinaryBuffer::SetJobManager(mpJobManager);
 	}
 	
 	//-----------------------------------------------------------------------
@@ -41,6 +50,9 @@ namespace hpl {
 	{
 		Log("Exiting System Module\n");
 		Log("--------------------------------------------------------\n");
+
+		cBinaryBuffer::SetJobManager(NULL);
+		hplDelete(mpJobManager);
 		
 		Log("--------------------------------------------------------\n\n");
 	}
@@ -0,0 +1,290 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+//////////////////////////////////////////////////////////////////////////
+// Renderer benchmark
+//
+// Loads a map with the null graphics and renders a number of frames from
+// scripted camera paths. Nothing is drawn, so this measures the CPU side of
+// the renderer (culling, render list sorting, occlusion query and shadow
+// bookkeeping) and can run without a GPU.
+//
+// Usage:
+//  RendererBenchmark <map file> [-frames N] [-path <path file>]... [-noupdate]
+//
+// A path file has one key per line: "x y z yaw pitch" with angles in degrees.
+// Lines starting with # are skipped. The camera moves linearly between keys
+// over the frames. Without a path the camera orbits the middle of the map.
+//////////////////////////////////////////////////////////////////////////
+
+#include "hpl.h"
+#include "system/Timer.h"
+#include "impl/LowLevelGraphicsNull.h"
+
+#include <stdio.h>
+
+using namespace hpl;
+
+//-----------------------------------------------------------------------
+
+class cCameraKey
+{
+public:
+	cCameraKey(){}
+	cCameraKey(const cVector3f& avPos, float afYaw, float afPitch) : mvPos(avPos), mfYaw(afYaw), mfPitch(afPitch){}
+
+	cVector3f mvPos;
+	float mfYaw;
+	float mfPitch;
+};
+
+typedef std::vector<cCameraKey> tCameraKeyVec;
+
+//-----------------------------------------------------------------------
+
+class cCameraPath
+{
+public:
+	tString msName;
+	tCameraKeyVec mvKeys;
+
+	cCameraKey GetKey(float afT)
+	{
+		if(mvKeys.size()==1) return mvKeys[0];
+
+		float fPos = cMath::Clamp(afT,0.0f,1.0f) * (float)(mvKeys.size()-1);
+		int lIdx = cMath::Min((int)fPos, (int)mvKeys.size()-2);
+		float fT = fPos - (float)lIdx;
+
+		const cCameraKey& keyA = mvKeys[lIdx];
+		const cCameraKey& keyB = mvKeys[lIdx+1];
+		return cCameraKey(	keyA.mvPos*(1-fT) + keyB.mvPos*fT,
+							keyA.mfYaw*(1-fT) + keyB.mfYaw*fT,
+							keyA.mfPitch*(1-fT) + keyB.mfPitch*fT);
+	}
+};
+
+//-----------------------------------------------------------------------
+
+static bool LoadCameraPath(const tString& asFile, cCameraPath *apPath)
+{
+	FILE *pFile = fopen(asFile.c_str(), "r");
+	if(pFile==NULL)
+	{
+		Error("Could not open camera path '%s'\n", asFile.c_str());
+		return false;
+	}
+
+	apPath->msName = cString::GetFileName(asFile);
+
+	char sLine[512];
+	while(fgets(sLine, sizeof(sLine), pFile))
+	{
+		if(sLine[0]=='#') continue;
+
+		tFloatVec vValues;
+		cString::GetFloatVec(sLine, vValues);
+		if(vValues.size() < 5) continue;
+
+		apPath->mvKeys.push_back(cCameraKey(cVector3f(vValues[0],vValues[1],vValues[2]), vValues[3], vValues[4]));
+	}
+	fclose(pFile);
+
+	if(apPath->mvKeys.empty())
+	{
+		Error("Camera path '%s' has no keys\n", asFile.c_str());
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+static void CreateOrbitPath(cWorld *apWorld, cCameraPath *apPath)
+{
+	apPath->msName = "orbit";
+
+	iRenderableContainer *pContainer = apWorld->GetRenderableContainer(eWorldContainerType_Static);
+	cVector3f vMin = pContainer->GetRoot()->GetMin();
+	cVector3f vMax = pContainer->GetRoot()->GetMax();
+	cVector3f vCenter = (vMin + vMax) * 0.5f;
+	float fRadius = cMath::Max(cMath::Max(vMax.x - vMin.x, vMax.z - vMin.z) * 0.25f, 2.0f);
+
+	const int lKeyNum = 16;
+	for(int i=0; i<=lKeyNum; ++i)
+	{
+		float fAngle = ((float)i / (float)lKeyNum) * k2Pif;
+		cVector3f vPos = vCenter + cVector3f(cos(fAngle)*fRadius, 0, sin(fAngle)*fRadius);
+		apPath->mvKeys.push_back(cCameraKey(vPos, cMath::ToDeg(fAngle) + 90.0f, -10.0f));
+	}
+}
+
+//-----------------------------------------------------------------------
+
+static void RunPath(cEngine *apEngine, cCamera *apCamera, cCameraPath *apPath, int alFrames, bool abUpdate)
+{
+	cLowLevelGraphicsNull *pLowLevelGfx = static_cast<cLowLevelGraphicsNull*>(apEngine->GetGraphics()->GetLowLevel());
+	cScene *pScene = apEngine->GetScene();
+	iTimer *pTimer = cPlatform::CreateTimer();
+
+	const float fStepSize = 1.0f / 60.0f;
+
+	double fRenderTimeTotal=0;
+	double fRenderTimeMin=0;
+	double fRenderTimeMax=0;
+
+	pLowLevelGfx->ResetCounters();
+
+	for(int i=0; i<alFrames; ++i)
+	{
+		cCameraKey key = apPath->GetKey(alFrames > 1 ? (float)i / (float)(alFrames-1) : 0.0f);
+		apCamera->SetPosition(key.mvPos);
+		apCamera->SetYaw(cMath::ToRad(key.mfYaw));
+		apCamera->SetPitch(cMath::ToRad(key.mfPitch));
+
+		if(abUpdate)
+		{
+			apEngine->GetUpdater()->RunMessage(eUpdateableMessage_PreUpdate, fStepSize);
+			apEngine->GetUpdater()->RunMessage(eUpdateableMessage_Update, fStepSize);
+			apEngine->GetUpdater()->RunMessage(eUpdateableMessage_PostUpdate, fStepSize);
+		}
+
+		pTimer->Start();
+		pScene->Render(fStepSize, tSceneRenderFlag_All);
+		pTimer->Stop();
+
+		pLowLevelGfx->SwapBuffers();
+
+		double fTime = pTimer->GetTimeInMilliSec();
+		fRenderTimeTotal += fTime;
+		if(i==0 || fTime < fRenderTimeMin) fRenderTimeMin = fTime;
+		if(i==0 || fTime > fRenderTimeMax) fRenderTimeMax = fTime;
+	}
+
+	hplDelete(pTimer);
+
+	/////////////////////////
+	// Report
+	const cNullGraphicsCounters& counters = pLowLevelGfx->GetTotalCounters();
+	float fFrames = (float)cMath::Max(alFrames,1);
+
+	char sReport[2048];
+	snprintf(sReport, sizeof(sReport),
+		"path: %s frames: %d\n"
+		" render ms    avg: %.3f min: %.3f max: %.3f\n"
+		" per frame    draws: %.1f tris: %.1f states: %.1f matrices: %.1f\n"
+		"              texture binds: %.1f program binds: %.1f program vars: %.1f vertex binds: %.1f\n"
+		"              frame buffer binds: %.1f clears: %.1f occlusion queries: %.1f\n",
+		apPath->msName.c_str(), alFrames,
+		fRenderTimeTotal / fFrames, fRenderTimeMin, fRenderTimeMax,
+		counters.mlDrawCalls / fFrames, counters.mlDrawnTriangles / fFrames, counters.mlStateChanges / fFrames, counters.mlMatrixChanges / fFrames,
+		counters.mlTextureBinds / fFrames, counters.mlProgramBinds / fFrames, counters.mlProgramVariableSets / fFrames, counters.mlVertexBufferBinds / fFrames,
+		counters.mlFrameBufferBinds / fFrames, counters.mlFrameBufferClears / fFrames, counters.mlOcclusionQueries / fFrames);
+
+	printf("%s", sReport);
+	Log("%s", sReport);
+}
+
+//-----------------------------------------------------------------------
+
+int hplMain(const tString &asCommandline)
+{
+	/////////////////////////
+	// Parse arguments
+	tString sMapFile = "";
+	int lFrames = 500;
+	bool bUpdate = true;
+	tStringVec vPathFiles;
+
+	tStringVec vArgs;
+	cString::GetStringVec(cString::ReplaceCharTo(asCommandline,"\"",""), vArgs);
+	for(size_t i=0; i<vArgs.size(); ++i)
+	{
+		if(vArgs[i] == "-frames" && i+1 < vArgs.size())		lFrames = cString::ToInt(vArgs[++i].c_str(), lFrames);
+		else if(vArgs[i] == "-path" && i+1 < vArgs.size())	vPathFiles.push_back(vArgs[++i]);
+		else if(vArgs[i] == "-noupdate")						bUpdate = false;
+		else													sMapFile = vArgs[i];
+	}
+
+	if(sMapFile == "")
+	{
+		printf("Usage: RendererBenchmark <map file> [-frames N] [-path <path file>]... [-noupdate]\n");
+		return 1;
+	}
+
+	SetLogFile(_W("RendererBenchmark.log"));
+
+	/////////////////////////
+	// Create engine
+	cEngineInitVars vars;
+	vars.mGraphics.mvScreenSize = cVector2l(1280,720);
+	cEngine *pEngine = CreateHPLEngine(eHplAPI_Null, eHplSetup_Screen, &vars);
+
+	tWString sMapDir = cString::To16Char(cString::GetFilePath(sMapFile));
+	if(sMapDir != _W("")) pEngine->GetResources()->AddResourceDir(sMapDir,false);
+	pEngine->GetResources()->LoadResourceDirsFile("resources.cfg");
+
+	/////////////////////////
+	// Load map
+	iTimer *pLoadTimer = cPlatform::CreateTimer();
+	pLoadTimer->Start();
+	cWorld *pWorld = pEngine->GetScene()->LoadWorld(cString::GetFileName(sMapFile), 0);
+	pLoadTimer->Stop();
+	if(pWorld == NULL)
+	{
+		Error("Could not load world '%s'\n", sMapFile.c_str());
+		hplDelete(pLoadTimer);
+		DestroyHPLEngine(pEngine);
+		return 1;
+	}
+	printf("map: %s load ms: %.1f\n", sMapFile.c_str(), pLoadTimer->GetTimeInMilliSec());
+	hplDelete(pLoadTimer);
+
+	cCamera *pCamera = pEngine->GetScene()->CreateCamera(eCameraMoveMode_Fly);
+	pCamera->SetNearClipPlane(0.05f);
+	pCamera->SetFarClipPlane(1000);
+	pEngine->GetScene()->CreateViewport(pCamera, pWorld);
+
+	/////////////////////////
+	// Run paths
+	std::vector<cCameraPath> vPaths;
+	for(size_t i=0; i<vPathFiles.size(); ++i)
+	{
+		cCameraPath path;
+		if(LoadCameraPath(vPathFiles[i], &path)) vPaths.push_back(path);
+	}
+	if(vPaths.empty())
+	{
+		cCameraPath path;
+		CreateOrbitPath(pWorld, &path);
+		vPaths.push_back(path);
+	}
+
+	for(size_t i=0; i<vPaths.size(); ++i)
+	{
+		RunPath(pEngine, pCamera, &vPaths[i], lFrames, bUpdate);
+	}
+
+	DestroyHPLEngine(pEngine);
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------
@@ -113,6 +113,7 @@ void cLuxDebugHandler::LoadUserConfig()
 	//////////////////////
 	//Load from config
 	mbShowFPS = gpBase->mpUserConfig->GetBool("Debug", "ShowFPS", true);
+	mbShowMemoryStats = gpBase->mpUserConfig->GetBool("Debug", "ShowMemoryStats", false);
 	mbShowSoundPlaying = gpBase->mpUserConfig->GetBool("Debug", "ShowSoundPlaying", true);
 	mbShowPlayerInfo = gpBase->mpUserConfig->GetBool("Debug", "ShowPlayerInfo", true);
 	mbShowEntityInfo = gpBase->mpUserConfig->GetBool("Debug", "ShowEntityInfo", true);
@@ -132,6 +133,7 @@ void cLuxDebugHandler::LoadUserConfig()
 	{
 		#ifndef SKIP_PTEST_TESTS
 			mbShowFPS = false;
+			mbShowMemoryStats = false;
 			mbShowSoundPlaying = false;
 			mbShowPlayerInfo = false;
 			mbShowEntityInfo = false;
@@ -155,6 +157,7 @@ void cLuxDebugHandler::LoadUserConfig()
 void cLuxDebugHandler::SaveUserConfig()
 {
 	 gpBase->mpUserConfig->SetBool("Debug", "ShowFPS", mbShowFPS);
+	 gpBase->mpUserConfig->SetBool("Debug", "ShowMemoryStats", mbShowMemoryStats);
 	 gpBase->mpUserConfig->SetBool("Debug", "ShowSoundPlaying", mbShowSoundPlaying);
 	 gpBase->mpUserConfig->SetBool("Debug", "ShowPlayerInfo", mbShowPlayerInfo);
 	 gpBase->mpUserConfig->SetBool("Debug", "ShowEntityInfo", mbShowEntityInfo);
@@ -393,6 +396,22 @@ void cLuxDebugHandler::OnDraw(float afFrameTime)
 		fY+=13.0f;
 	}
 
+	////////////////////
+	// Memory allocations last frame, per subsystem
+	if(mbShowMemoryStats)
+	{
+		for(int i=0; i<cMemoryManager::GetStatsTagNum(); ++i)
+		{
+			const cMemoryStatsTag &tag = cMemoryManager::GetStatsTag(i);
+			if(tag.mlFrameAllocCount==0 && tag.mlFrameFreeCount==0) continue;
+
+			gpBase->mpGameDebugSet->DrawFont(gpBase->mpDefaultFont, cVector3f(5,fY,10),14,cColor(1,1),
+				_W("%ls: %d allocs (%.1f kb) %d frees\n"),cString::To16Char(cMemoryManager::GetStatsTagName(i)).c_str(),
+				(int)tag.mlFrameAllocCount, (float)tag.mlFrameAllocBytes / 1024.0f, (int)tag.mlFrameFreeCount);
+			fY+=13.0f;
+		}
+	}
+
 	////////////////////
 	// Messages
 	if(mbShowDebugMessages || mbShowErrorMessages)
@@ -961,7 +980,7 @@ void cLuxDebugHandler::CreateGuiWindow()
 
 	///////////////////////////
 	//Window
-	cVector2f vSize = cVector2f(250, 780);
+	cVector2f vSize = cVector2f(250, 800);
 	vGroupSize.x = vSize.x - 20;
 	cVector3f vPos = cVector3f(mpGuiSet->GetVirtualSize().x - vSize.x - 10, 10, 0);
 	mpDebugWindow = mpGuiSet->CreateWidgetWindow(0,vPos,vSize,_W("Debug Toolbar") );
@@ -984,6 +1003,13 @@ void cLuxDebugHandler::CreateGuiWindow()
 		pCheckBox->AddCallback(eGuiMessage_CheckChange,this, kGuiCallback(ChangeDebugText));
 		vGroupPos.y += 22;
 
+		//Show memory stats
+		pCheckBox = mpGuiSet->CreateWidgetCheckBox(vGroupPos,vSize,_W("Show memory allocations"),pGroup);
+		pCheckBox->SetChecked(mbShowMemoryStats);
+		pCheckBox->SetUserValue(18);
+		pCheckBox->AddCallback(eGuiMessage_CheckChange,this, kGuiCallback(ChangeDebugText));
+		vGroupPos.y += 22;
+
 		//Show player info
 		pCheckBox = mpGuiSet->CreateWidgetCheckBox(vGroupPos,vSize,_W("Show player info"),pGroup);
 		pCheckBox->SetChecked(mbShowPlayerInfo);
@@ -1579,6 +1605,12 @@ bool cLuxDebugHandler::ChangeDebugText(iWidget* apWidget, const cGuiMessageData&
 	else if(lNum == 14)  gpBase->mpPlayer->SetFreeCamSpeed( cMath::Max((float)aData.mlVal/ 100.0f, 0.001f) );
 
 	else if(lNum == 17)  SetFastForward(bActive);
+	else if(lNum == 18)
+	{
+		//Log the full report (with the sampled call sites) when turned off
+		if(bActive==false) cMemoryManager::LogFrameStats();
+		mbShowMemoryStats = bActive;
+	}
 	
 
 	return true;
@@ -164,6 +164,7 @@ private:
 	tWidgetList mlstScriptOutputWidgets;
 
 	bool mbShowFPS;
+	bool mbShowMemoryStats;
 	bool mbShowSoundPlaying;
 	bool mbShowPlayerInfo;
 	bool mbShowEntityInfo;
@@ -454,6 +454,11 @@ iLuxEnemy::iLuxEnemy(const tString &asName, int alID, cLuxMap *apMap, eLuxEnemyT
 	mbPlayerDetected = false;
 	mbPlayerInRange = false;
 
+	mlLineOfSightRays =0;
+	mlLineOfSightChecks =0;
+	mlLineOfSightRaysLastFrame =0;
+	mlLineOfSightChecksLastFrame =0;
+
 	mfCheckAtDoorCount =0;
 	mbStuckAtDoor = false;
 
@@ -630,6 +635,13 @@ void iLuxEnemy::OnUpdate(float afTimeStep)
 		return;
 	}
 
+	//////////////////////
+	// Line of sight budget
+	mlLineOfSightRaysLastFrame = mlLineOfSightRays;
+	mlLineOfSightChecksLastFrame = mlLineOfSightChecks;
+	mlLineOfSightRays =0;
+	mlLineOfSightChecks =0;
+
 	//////////////////////
 	// Helpers
 	mpPathfinder->OnUpdate(afTimeStep);
@@ -1185,6 +1197,10 @@ float iLuxEnemy::DrawDebug(cGuiSet *apSet,iFontData *apFont,float afStartY)
 						mlCurrentPatrolNode, mpMover->CalculateSpeedMul(1.0f/60.0f));
 	afStartY += 14;
 
+	apSet->DrawFont(apFont, cVector3f(5,afStartY,10),13,cColor(1,1), 
+		_W("  LineOfSight checks: %d rays: %d"), mlLineOfSightChecksLastFrame, mlLineOfSightRaysLastFrame);
+	afStartY += 14;
+
 	//apSet->DrawFont(apFont, cVector3f(5,afStartY,10),13,cColor(1,1), 
 	//	_W("  Climbing: %d"), mpCharBody->IsClimbing());
 	//afStartY += 14;
@@ -1940,31 +1956,34 @@ bool iLuxEnemy::LineOfSight(const cVector3f &avPos, const cVector3f &avSize, boo
 	const float fHalfHeight = avSize.y * 0.4f;
 
 	////////////////////////////
-	// Init variables
-	//Count of 2 is need for a line of sight success.
-	int lCount=0;
+	// Setup rays
 	const int lMaxAdds = 9;
+	cVector3f vStarts[lMaxAdds];
+	cVector3f vEnds[lMaxAdds];
 	
-	///////////////////////////////////
-	//Iterate through all the rays.
 	for(int i=0; i< lMaxAdds; ++i)
 	{
 		cVector3f vAdd = vRight * (gvPosAdds[i].x*fHalfWidth) + vUp * (gvPosAdds[i].y*fHalfHeight);
-		cVector3f vStart = vStartCenter + vAdd;
-		cVector3f vEnd = vEndCenter + vAdd;
-
-		if(gpBase->mpMapHelper->CheckLineOfSight(vStart, vEnd,false))
-		{
-			lCount++;
-		}
-
-		if(lCount==2)
-		{
-			return true;
-		}
+		vStarts[i] = vStartCenter + vAdd;
+		vEnds[i] = vEndCenter + vAdd;
 	}
 	
-	return false;
+	///////////////////////////////////
+	//Count of 2 is need for a line of sight success.
+	return CheckLineOfSightRays(vStarts, vEnds, lMaxAdds, 2, false) >= 2;
+}
+
+//-----------------------------------------------------------------------
+
+int iLuxEnemy::CheckLineOfSightRays(const cVector3f* apStarts, const cVector3f* apEnds, int alRayNum, int alRequiredFree, bool abCheckShadows)
+{
+	int lRaysCast =0;
+	int lFree = gpBase->mpMapHelper->CheckLineOfSightBundle(apStarts, apEnds, alRayNum, alRequiredFree, abCheckShadows, &lRaysCast);
+
+	mlLineOfSightChecks++;
+	mlLineOfSightRays += lRaysCast;
+
+	return lFree;
 }
 
 //-----------------------------------------------------------------------
@@ -508,6 +508,9 @@ public:
 	// Debug
 	float DrawDebug(cGuiSet *apSet,iFontData *apFont,float afStartY);
 
+	int GetLineOfSightRaysLastFrame(){ return mlLineOfSightRaysLastFrame;}
+	int GetLineOfSightChecksLastFrame(){ return mlLineOfSightChecksLastFrame;}
+
 	//////////////////////
 	//Save data stuff
 	virtual void SaveToSaveData(iLuxEntity_SaveData* apSaveData);
@@ -561,6 +564,7 @@ protected:
 
 	bool LineOfSight(const cVector3f &avPos, const cVector3f &avSize, bool abCheckFOV);
 	bool LineOfSight(const cVector3f &avPos, const cVector3f &avSize, bool abCheckFOV, const cVector3f& avSourcePos);
+	int CheckLineOfSightRays(const cVector3f* apStarts, const cVector3f* apEnds, int alRayNum, int alRequiredFree, bool abCheckShadows);
 
 	int CreateAttackShape(cWorld *apWorld, cVector3f &avSize, eCollideShapeType aType=eCollideShapeType_Box);
 
@@ -632,6 +636,11 @@ protected:
 	bool mbPlayerDetected;
 	bool mbPlayerInRange;
 
+	int mlLineOfSightRays;
+	int mlLineOfSightChecks;
+	int mlLineOfSightRaysLastFrame;
+	int mlLineOfSightChecksLastFrame;
+
 	float mfCheckAtDoorCount;
 	bool mbStuckAtDoor;
 	int mlStuckDoorID;
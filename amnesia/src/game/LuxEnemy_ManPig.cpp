@@ -2149,13 +2149,11 @@ bool cLuxEnemy_ManPig::InsidePlayerView()
 	vPositions[1] = mpCharBody->GetPosition() + vSideAdd;
 	vPositions[2] = mpCharBody->GetPosition() - vSideAdd;
 	
-	for(int i=0; i<3; ++i)
+	cVector3f vStarts[3] = {vStart, vStart, vStart};
+	if(CheckLineOfSightRays(vStarts, vPositions, 3, 1, true) > 0)
 	{
-		if(gpBase->mpMapHelper->CheckLineOfSight(vStart, vPositions[i], true))
-		{
-			//Log(" true: ray %d!\n", i);
-			return true;
-		}
+		//Log(" true: ray!\n");
+		return true;
 	}
 
 	//Log(" false: no rays!\n");
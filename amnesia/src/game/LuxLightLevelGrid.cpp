@@ -0,0 +1,662 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LuxLightLevelGrid.h"
+
+#include "LuxMap.h"
+#include "LuxMapHelper.h"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------
+
+#define LIGHT_LEVEL_CACHE_MAGIC_NUMBER	0x4C4C4743
+#define LIGHT_LEVEL_CACHE_VERSION		2
+
+static const float gfLightLevelCellSize = 1.0f;
+static const int glLightLevelBlockSize = 8; //Cells per side in a block
+static const int glLightLevelBlockCells = glLightLevelBlockSize*glLightLevelBlockSize*glLightLevelBlockSize;
+static const int glLightLevelNodeMaxLights = 4;
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// BAKE RAY CALLBACK
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+/**
+ * Only static geometry is used when baking, dynamic objects (doors, etc) are moved about too much.
+ * They are only checked by the line of sight test in cells that static geometry partly blocks.
+ */
+class cLuxLightLevelBakeCallback : public cLuxLineOfSightCallback
+{
+public:
+	bool BeforeIntersect(iPhysicsBody *apBody)
+	{
+		if(apBody->GetMass() != 0) return false;
+		return cLuxLineOfSightCallback::BeforeIntersect(apBody);
+	}
+};
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// CONSTRUCTORS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+cLuxLightLevelGrid::cLuxLightLevelGrid()
+{
+	mpWorld = NULL;
+	mbDynamicLightsDirty = true;
+}
+
+//-----------------------------------------------------------------------
+
+cLuxLightLevelGrid::~cLuxLightLevelGrid()
+{
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+void cLuxLightLevelGrid::Build(cLuxMap *apMap)
+{
+	Clear();
+
+	mpWorld = apMap->GetWorld();
+	unsigned long lStartTime = cPlatform::GetApplicationTime();
+	
+	////////////////////////////
+	// Gather static lights
+	cLightListIterator lightIt = mpWorld->GetLightIterator();
+	while(lightIt.HasNext())
+	{
+		iLight *pLight = lightIt.Next();
+		if(IsBakeableLight(pLight)==false) continue;
+		if(mvLights.size() >= 0xFFFF) break;
+
+		cLuxLightLevelGridLight light;
+		light.mpLight = pLight;
+		light.msName = pLight->GetName();
+		light.mvPosition = pLight->GetWorldPosition();
+		light.mvForward = pLight->GetWorldMatrix().GetForward();
+		light.mfRadius = pLight->GetRadius();
+		if(pLight->GetFlickerActive())
+		{
+			light.mfRadius = cMath::Max(light.mfRadius, cMath::Max(pLight->GetFlickerOnRadius(), pLight->GetFlickerOffRadius()));
+		}
+		light.mbCheckShadow = pLight->GetLightType() == eLightType_Spot && pLight->GetCastShadows();
+		light.mbValid = true;
+
+		m_mapLightIndices.insert(std::map<iLight*, int>::value_type(pLight, (int)mvLights.size()));
+		mvLights.push_back(light);
+	}
+
+	////////////////////////////
+	// Load the cache or bake
+	tWString sMapPath = gpBase->mpEngine->GetResources()->GetFileSearcher()->GetFilePath(apMap->GetFileName());
+	tWString sCacheFile = sMapPath != _W("") ? cString::SetFileExtW(sMapPath, _W("light_cache")) : _W("");
+
+	bool bLoaded = false;
+	if(sCacheFile != _W(""))
+	{
+		if(cResources::GetForceCacheLoadingAndSkipSaving() || cPlatform::FileModifiedDate(sMapPath) < cPlatform::FileModifiedDate(sCacheFile))
+		{
+			if(cPlatform::FileExists(sCacheFile)) bLoaded = LoadCache(sCacheFile);
+		}
+	}
+
+	if(bLoaded==false)
+	{
+		BakeLights();
+		if(sCacheFile != _W("") && cResources::GetForceCacheLoadingAndSkipSaving()==false)
+			SaveCache(sCacheFile);
+	}
+
+	mbDynamicLightsDirty = true;
+
+	Log("  Light level grid: %d static lights, %d cells, %d entries. %s in %d ms\n", (int)mvLights.size(), (int)mvCells.size(), (int)mvEntries.size(), 
+		bLoaded ? "Loaded" : "Baked", cPlatform::GetApplicationTime() - lStartTime);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxLightLevelGrid::Clear()
+{
+	mpWorld = NULL;
+
+	mvLights.clear();
+	m_mapLightIndices.clear();
+
+	mvGridOrigin = 0;
+	mvBlockNum = 0;
+	mvBlocks.clear();
+	mvCells.clear();
+	mvEntries.clear();
+
+	mvDynamicLights.clear();
+	mvDynamicNodes.clear();
+	mbDynamicLightsDirty = true;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxLightLevelGrid::GetLightsAtPos(const cVector3f& avPos, tLuxLightLevelSampleVec &avSamples)
+{
+	if(mbDynamicLightsDirty) UpdateDynamicLights();
+
+	////////////////////////////
+	// Static lights
+	cVector3f vLocal = (avPos - mvGridOrigin) / gfLightLevelCellSize;
+	int lX = (int)floor(vLocal.x);
+	int lY = (int)floor(vLocal.y);
+	int lZ = (int)floor(vLocal.z);
+	
+	int lCell = GetCellIndex(lX, lY, lZ);
+	if(lCell >= 0)
+	{
+		const cLuxLightLevelGridCell &cell = mvCells[lCell];
+		
+		for(int i=0; i<cell.mlEntryNum; ++i)
+		{
+			const cLuxLightLevelGridEntry &entry = mvEntries[cell.mlFirstEntry + i];
+			cLuxLightLevelGridLight &light = mvLights[entry.mlLight];
+			if(light.mbValid==false) continue; //Checked as a dynamic light
+			if(LightContainsPoint(light.mpLight, avPos)==false) continue;
+
+			//If static geometry blocks any part of the cell, the line of sight must be checked.
+			float fVisibility = entry.mbUnblocked ? 1.0f : -1.0f;
+
+			avSamples.push_back(cLuxLightLevelSample(light.mpLight, fVisibility));
+		}
+	}
+
+	////////////////////////////
+	// Dynamic lights
+	if(mvDynamicNodes.empty()) return;
+
+	int vStack[64];
+	int lStackSize = 0;
+	vStack[lStackSize++] = 0;
+	while(lStackSize > 0)
+	{
+		const cLuxLightLevelGridNode &node = mvDynamicNodes[vStack[--lStackSize]];
+		if(cMath::CheckPointInAABBIntersection(avPos, node.mvMin, node.mvMax)==false) continue;
+
+		if(node.mlLightNum > 0)
+		{
+			for(int i=node.mlFirst; i<node.mlFirst + node.mlLightNum; ++i)
+			{
+				iLight *pLight = mvDynamicLights[i].mpLight;
+				if(LightContainsPoint(pLight, avPos)==false) continue;
+
+				avSamples.push_back(cLuxLightLevelSample(pLight, -1.0f));
+			}
+		}
+		else if(lStackSize < 62)
+		{
+			vStack[lStackSize++] = node.mlFirst;
+			vStack[lStackSize++] = node.mlFirst+1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------
+
+bool cLuxLightLevelGrid::LightContainsPoint(iLight *apLight, const cVector3f& avPos)
+{
+	if(apLight->IsVisible()==false) return false;
+
+	switch(apLight->GetLightType())
+	{
+	case eLightType_Box:
+		return cMath::CheckPointInBVIntersection(avPos, *apLight->GetBoundingVolume());
+	case eLightType_Point:
+		return cMath::CheckPointInSphereIntersection(avPos, apLight->GetWorldPosition(), apLight->GetRadius());
+	case eLightType_Spot:
+		return static_cast<cLightSpot*>(apLight)->GetFrustum()->CollidePoint(avPos);
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+bool cLuxLightLevelGrid::IsBakeableLight(iLight *apLight)
+{
+	return apLight->IsStatic() && apLight->GetParent()==NULL && apLight->GetEntityParent()==NULL;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxLightLevelGrid::GetBakeBounds(const cLuxLightLevelGridLight& aLight, cVector3f &avMin, cVector3f &avMax)
+{
+	if(aLight.mpLight->GetLightType() == eLightType_Box)
+	{
+		cBoundingVolume *pBV = aLight.mpLight->GetBoundingVolume();
+		avMin = pBV->GetMin();
+		avMax = pBV->GetMax();
+	}
+	else
+	{
+		//Spots use the sphere as well, it contains the frustum.
+		avMin = aLight.mvPosition - cVector3f(aLight.mfRadius);
+		avMax = aLight.mvPosition + cVector3f(aLight.mfRadius);
+	}
+}
+
+//-----------------------------------------------------------------------
+
+static bool CellEntryCompare(const std::pair<int, cLuxLightLevelGridEntry>& aA, const std::pair<int, cLuxLightLevelGridEntry>& aB)
+{
+	return aA.first < aB.first;
+}
+
+void cLuxLightLevelGrid::BakeLights()
+{
+	if(mvLights.empty()) return;
+
+	////////////////////////////
+	// Get grid size
+	cVector3f vMin(100000.0f), vMax(-100000.0f);
+	for(size_t i=0; i<mvLights.size(); ++i)
+	{
+		cVector3f vLightMin, vLightMax;
+		GetBakeBounds(mvLights[i], vLightMin, vLightMax);
+		vMin = cMath::Vector3Min(vMin, vLightMin);
+		vMax = cMath::Vector3Max(vMax, vLightMax);
+	}
+
+	const float fBlockSize = gfLightLevelCellSize * (float)glLightLevelBlockSize;
+	mvGridOrigin = vMin;
+	mvBlockNum.x = (int)ceil((vMax.x - vMin.x) / fBlockSize) + 1;
+	mvBlockNum.y = (int)ceil((vMax.y - vMin.y) / fBlockSize) + 1;
+	mvBlockNum.z = (int)ceil((vMax.z - vMin.z) / fBlockSize) + 1;
+	mvBlocks.assign(mvBlockNum.x * mvBlockNum.y * mvBlockNum.z, -1);
+
+	////////////////////////////
+	// Add the lights to the cells they touch
+	cLuxLightLevelBakeCallback rayCallback;
+	rayCallback.SetCheckShadow(true);
+	iPhysicsWorld *pPhysicsWorld = mpWorld->GetPhysicsWorld();
+
+	std::vector< std::pair<int, cLuxLightLevelGridEntry> > vCellEntries;
+	std::vector<bool> vSampleBlocked;
+
+	for(size_t light=0; light<mvLights.size(); ++light)
+	{
+		cLuxLightLevelGridLight &gridLight = mvLights[light];
+
+		cVector3f vLightMin, vLightMax;
+		GetBakeBounds(gridLight, vLightMin, vLightMax);
+		
+		cVector3l vStart(	(int)floor((vLightMin.x - mvGridOrigin.x) / gfLightLevelCellSize),
+							(int)floor((vLightMin.y - mvGridOrigin.y) / gfLightLevelCellSize),
+							(int)floor((vLightMin.z - mvGridOrigin.z) / gfLightLevelCellSize));
+		cVector3l vEnd(		(int)floor((vLightMax.x - mvGridOrigin.x) / gfLightLevelCellSize),
+							(int)floor((vLightMax.y - mvGridOrigin.y) / gfLightLevelCellSize),
+							(int)floor((vLightMax.z - mvGridOrigin.z) / gfLightLevelCellSize));
+		//Samples are placed every half cell, so each cell has 3x3x3 (corners, edge, face and center points).
+		cVector3l vSampleNum = (vEnd - vStart + cVector3l(1))*2 + cVector3l(1);
+		bool bCheckShadow = gridLight.mbCheckShadow && pPhysicsWorld;
+
+		//////////////////////
+		// Check if static geometry blocks the light at the samples, samples on the edges are shared so calculate them once.
+		// Samples the light does not reach (outside of the spot frustum) count as not blocked.
+		if(bCheckShadow)
+		{
+			cFrustum *pFrustum = static_cast<cLightSpot*>(gridLight.mpLight)->GetFrustum();
+			vSampleBlocked.assign(vSampleNum.x * vSampleNum.y * vSampleNum.z, false);
+			for(int z=0; z<vSampleNum.z; ++z)
+			for(int y=0; y<vSampleNum.y; ++y)
+			for(int x=0; x<vSampleNum.x; ++x)
+			{
+				cVector3f vSample = mvGridOrigin + cVector3f(	(float)vStart.x + (float)x*0.5f, 
+																(float)vStart.y + (float)y*0.5f, 
+																(float)vStart.z + (float)z*0.5f) * gfLightLevelCellSize;
+				if(pFrustum->CollidePoint(vSample)==false) continue;
+
+				rayCallback.Reset();
+				pPhysicsWorld->CastRay(&rayCallback, gridLight.mvPosition, vSample, false, false, false, true);
+				if(rayCallback.GetIntersected()) vSampleBlocked[(z*vSampleNum.y + y)*vSampleNum.x + x] = true;
+			}
+		}
+
+		//////////////////////
+		// Add entries
+		for(int z=vStart.z; z<=vEnd.z; ++z)
+		for(int y=vStart.y; y<=vEnd.y; ++y)
+		for(int x=vStart.x; x<=vEnd.x; ++x)
+		{
+			int lBlock = ((z / glLightLevelBlockSize)*mvBlockNum.y + (y / glLightLevelBlockSize))*mvBlockNum.x + (x / glLightLevelBlockSize);
+			if(mvBlocks[lBlock] < 0)
+			{
+				mvBlocks[lBlock] = (int)mvCells.size();
+				cLuxLightLevelGridCell emptyCell;
+				emptyCell.mlFirstEntry = 0;
+				emptyCell.mlEntryNum = 0;
+				mvCells.resize(mvCells.size() + glLightLevelBlockCells, emptyCell);
+			}
+
+			//Cells that are blocked at all samples are kept as well, a thin beam can pass between them.
+			cLuxLightLevelGridEntry entry;
+			entry.mlLight = (unsigned short)light;
+			entry.mbUnblocked = true;
+			if(bCheckShadow)
+			{
+				int lSX = (x - vStart.x)*2, lSY = (y - vStart.y)*2, lSZ = (z - vStart.z)*2;
+				for(int sz=lSZ; sz<=lSZ+2 && entry.mbUnblocked; ++sz)
+				for(int sy=lSY; sy<=lSY+2 && entry.mbUnblocked; ++sy)
+				for(int sx=lSX; sx<=lSX+2; ++sx)
+				{
+					if(vSampleBlocked[(sz*vSampleNum.y + sy)*vSampleNum.x + sx])
+					{
+						entry.mbUnblocked = false;
+						break;
+					}
+				}
+			}
+
+			vCellEntries.push_back(std::pair<int, cLuxLightLevelGridEntry>(GetCellIndex(x, y, z), entry));
+		}
+	}
+
+	////////////////////////////
+	// Pack entries by cell, lights are added in order so a stable sort keeps the order within a cell.
+	std::stable_sort(vCellEntries.begin(), vCellEntries.end(), CellEntryCompare);
+
+	mvEntries.resize(vCellEntries.size());
+	for(size_t i=0; i<vCellEntries.size(); ++i)
+	{
+		cLuxLightLevelGridCell &cell = mvCells[vCellEntries[i].first];
+		if(cell.mlEntryNum == 0) cell.mlFirstEntry = (int)i;
+		cell.mlEntryNum++;
+
+		mvEntries[i] = vCellEntries[i].second;
+	}
+}
+
+//-----------------------------------------------------------------------
+
+bool cLuxLightLevelGrid::LoadCache(const tWString& asFile)
+{
+	cBinaryBuffer binBuff(asFile);
+	if(binBuff.Load()==false) return false;
+
+	if(binBuff.GetInt32() != LIGHT_LEVEL_CACHE_MAGIC_NUMBER) return false;
+	if(binBuff.GetInt32() != LIGHT_LEVEL_CACHE_VERSION) return false;
+	if(binBuff.GetFloat32() != gfLightLevelCellSize) return false;
+	
+	////////////////////////////
+	// Lights must be the same as the ones in the map
+	int lLightNum = binBuff.GetInt32();
+	if(lLightNum != (int)mvLights.size()) return false;
+
+	for(int i=0; i<lLightNum; ++i)
+	{
+		cLuxLightLevelGridLight &light = mvLights[i];
+		
+		tString sName;
+		cVector3f vPos, vForward;
+		binBuff.GetString(&sName);
+		binBuff.GetVector3f(&vPos);
+		binBuff.GetVector3f(&vForward);
+		float fRadius = binBuff.GetFloat32();
+		bool bCheckShadow = binBuff.GetBool();
+
+		if(	sName != light.msName || vPos != light.mvPosition || vForward != light.mvForward ||
+			fRadius != light.mfRadius || bCheckShadow != light.mbCheckShadow)
+		{
+			return false;
+		}
+	}
+
+	////////////////////////////
+	// Grid
+	binBuff.GetVector3f(&mvGridOrigin);
+	binBuff.GetVector3l(&mvBlockNum);
+	
+	int lBlockNum = binBuff.GetInt32();
+	if(lBlockNum != mvBlockNum.x * mvBlockNum.y * mvBlockNum.z) return false;
+	mvBlocks.resize(lBlockNum);
+	if(lBlockNum > 0) binBuff.GetInt32Array(&mvBlocks[0], lBlockNum);
+
+	int lCellNum = binBuff.GetInt32();
+	mvCells.resize(lCellNum);
+	for(int i=0; i<lCellNum; ++i)
+	{
+		mvCells[i].mlFirstEntry = binBuff.GetInt32();
+		mvCells[i].mlEntryNum = binBuff.GetInt32();
+	}
+
+	int lEntryNum = binBuff.GetInt32();
+	mvEntries.resize(lEntryNum);
+	for(int i=0; i<lEntryNum; ++i)
+	{
+		mvEntries[i].mlLight = binBuff.GetUnsignedShort16();
+		mvEntries[i].mbUnblocked = binBuff.GetBool();
+	}
+	
+	return binBuff.IsEOF();
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxLightLevelGrid::SaveCache(const tWString& asFile)
+{
+	cBinaryBuffer binBuff(asFile);
+
+	binBuff.AddInt32(LIGHT_LEVEL_CACHE_MAGIC_NUMBER);
+	binBuff.AddInt32(LIGHT_LEVEL_CACHE_VERSION);
+	binBuff.AddFloat32(gfLightLevelCellSize);
+
+	////////////////////////////
+	// Lights
+	binBuff.AddInt32((int)mvLights.size());
+	for(size_t i=0; i<mvLights.size(); ++i)
+	{
+		cLuxLightLevelGridLight &light = mvLights[i];
+		
+		binBuff.AddString(light.msName);
+		binBuff.AddVector3f(light.mvPosition);
+		binBuff.AddVector3f(light.mvForward);
+		binBuff.AddFloat32(light.mfRadius);
+		binBuff.AddBool(light.mbCheckShadow);
+	}
+
+	////////////////////////////
+	// Grid
+	binBuff.AddVector3f(mvGridOrigin);
+	binBuff.AddVector3l(mvBlockNum);
+	
+	binBuff.AddInt32((int)mvBlocks.size());
+	if(mvBlocks.empty()==false) binBuff.AddInt32Array(&mvBlocks[0], mvBlocks.size());
+	
+	binBuff.AddInt32((int)mvCells.size());
+	for(size_t i=0; i<mvCells.size(); ++i)
+	{
+		binBuff.AddInt32(mvCells[i].mlFirstEntry);
+		binBuff.AddInt32(mvCells[i].mlEntryNum);
+	}
+
+	binBuff.AddInt32((int)mvEntries.size());
+	for(size_t i=0; i<mvEntries.size(); ++i)
+	{
+		binBuff.AddUnsignedShort16(mvEntries[i].mlLight);
+		binBuff.AddBool(mvEntries[i].mbUnblocked);
+	}
+
+	if(binBuff.Save()==false)
+	{
+		Warning("Could not save light level cache '%s'\n", cString::To8Char(asFile).c_str());
+	}
+}
+
+//-----------------------------------------------------------------------
+
+int cLuxLightLevelGrid::GetCellIndex(int alX, int alY, int alZ)
+{
+	if(alX < 0 || alY < 0 || alZ < 0) return -1;
+
+	int lBlockX = alX / glLightLevelBlockSize;
+	int lBlockY = alY / glLightLevelBlockSize;
+	int lBlockZ = alZ / glLightLevelBlockSize;
+	if(lBlockX >= mvBlockNum.x || lBlockY >= mvBlockNum.y || lBlockZ >= mvBlockNum.z) return -1;
+
+	int lFirstCell = mvBlocks[(lBlockZ*mvBlockNum.y + lBlockY)*mvBlockNum.x + lBlockX];
+	if(lFirstCell < 0) return -1;
+
+	int lX = alX % glLightLevelBlockSize;
+	int lY = alY % glLightLevelBlockSize;
+	int lZ = alZ % glLightLevelBlockSize;
+
+	return lFirstCell + (lZ*glLightLevelBlockSize + lY)*glLightLevelBlockSize + lX;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxLightLevelGrid::UpdateDynamicLights()
+{
+	mbDynamicLightsDirty = false;
+	mvDynamicLights.resize(0);
+	mvDynamicNodes.resize(0);
+	if(mpWorld==NULL) return;
+
+	////////////////////////////
+	// Static lights that are not found (destroyed) are no longer valid.
+	std::vector<bool> vFound(mvLights.size(), false);
+
+	cLightListIterator lightIt = mpWorld->GetLightIterator();
+	while(lightIt.HasNext())
+	{
+		iLight *pLight = lightIt.Next();
+
+		////////////////////
+		// Check if the baked data still is valid
+		std::map<iLight*, int>::iterator it = m_mapLightIndices.find(pLight);
+		if(it != m_mapLightIndices.end())
+		{
+			cLuxLightLevelGridLight &light = mvLights[it->second];
+			vFound[it->second] = true;
+			if(light.mbValid)
+			{
+				light.mbValid =	pLight->GetRadius() <= light.mfRadius && 
+								cMath::Vector3DistSqr(pLight->GetWorldPosition(), light.mvPosition) < 0.0001f &&
+								(pLight->GetLightType() != eLightType_Spot ||
+								 cMath::Vector3DistSqr(pLight->GetWorldMatrix().GetForward(), light.mvForward) < 0.0001f);
+			}
+			if(light.mbValid) continue;
+		}
+
+		////////////////////
+		// Add as dynamic
+		cBoundingVolume *pBV = pLight->GetBoundingVolume();
+
+		cLuxLightLevelGridDynamicLight dynLight;
+		dynLight.mpLight = pLight;
+		dynLight.mvMin = pBV->GetMin();
+		dynLight.mvMax = pBV->GetMax();
+		mvDynamicLights.push_back(dynLight);
+	}
+
+	for(size_t i=0; i<vFound.size(); ++i)
+	{
+		if(vFound[i]==false) mvLights[i].mbValid = false;
+	}
+
+	////////////////////////////
+	// Build BVH
+	if(mvDynamicLights.empty()) return;
+
+	mvDynamicNodes.reserve(mvDynamicLights.size()*2);
+	mvDynamicNodes.resize(1);
+	BuildDynamicNode(0, 0, (int)mvDynamicLights.size());
+}
+
+//-----------------------------------------------------------------------
+
+class cLuxDynamicLightCompare
+{
+public:
+	cLuxDynamicLightCompare(int alAxis) : mlAxis(alAxis){}
+
+	bool operator()(const cLuxLightLevelGridDynamicLight& aA, const cLuxLightLevelGridDynamicLight& aB) const
+	{
+		return aA.mvMin.v[mlAxis] + aA.mvMax.v[mlAxis] < aB.mvMin.v[mlAxis] + aB.mvMax.v[mlAxis];
+	}
+
+	int mlAxis;
+};
+
+void cLuxLightLevelGrid::BuildDynamicNode(int alNode, int alFirst, int alLightNum)
+{
+	cVector3f vMin = mvDynamicLights[alFirst].mvMin;
+	cVector3f vMax = mvDynamicLights[alFirst].mvMax;
+	for(int i=alFirst+1; i<alFirst+alLightNum; ++i)
+	{
+		vMin = cMath::Vector3Min(vMin, mvDynamicLights[i].mvMin);
+		vMax = cMath::Vector3Max(vMax, mvDynamicLights[i].mvMax);
+	}
+	mvDynamicNodes[alNode].mvMin = vMin;
+	mvDynamicNodes[alNode].mvMax = vMax;
+
+	////////////////////////////
+	// Leaf
+	if(alLightNum <= glLightLevelNodeMaxLights)
+	{
+		mvDynamicNodes[alNode].mlFirst = alFirst;
+		mvDynamicNodes[alNode].mlLightNum = alLightNum;
+		return;
+	}
+
+	////////////////////////////
+	// Split at the median along the longest axis
+	cVector3f vSize = vMax - vMin;
+	int lAxis = 0;
+	if(vSize.y > vSize.v[lAxis]) lAxis = 1;
+	if(vSize.z > vSize.v[lAxis]) lAxis = 2;
+
+	int lHalf = alLightNum/2;
+	std::nth_element(	mvDynamicLights.begin()+alFirst, mvDynamicLights.begin()+alFirst+lHalf, 
+						mvDynamicLights.begin()+alFirst+alLightNum, cLuxDynamicLightCompare(lAxis));
+
+	int lChild = (int)mvDynamicNodes.size();
+	mvDynamicNodes[alNode].mlFirst = lChild;
+	mvDynamicNodes[alNode].mlLightNum = 0;
+	mvDynamicNodes.resize(mvDynamicNodes.size()+2);
+
+	BuildDynamicNode(lChild, alFirst, lHalf);
+	BuildDynamicNode(lChild+1, alFirst+lHalf, alLightNum - lHalf);
+}
+
+//-----------------------------------------------------------------------
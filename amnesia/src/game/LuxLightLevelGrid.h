@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ * 
+ * This file is part of Amnesia: The Dark Descent.
+ * 
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version. 
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUX_LIGHT_LEVEL_GRID_H
+#define LUX_LIGHT_LEVEL_GRID_H
+
+//----------------------------------------------
+
+#include "LuxBase.h"
+
+//----------------------------------------------
+
+class cLuxMap;
+
+//----------------------------------------------
+
+class cLuxLightLevelSample
+{
+public:
+	cLuxLightLevelSample(){}
+	cLuxLightLevelSample(iLight *apLight, float afVisibility) : mpLight(apLight), mfVisibility(afVisibility){}
+
+	iLight *mpLight;
+	float mfVisibility;	//Amount of light that reaches the position, negative means line of sight must be checked.
+};
+
+typedef std::vector<cLuxLightLevelSample> tLuxLightLevelSampleVec;
+
+//----------------------------------------------
+
+class cLuxLightLevelGridLight
+{
+public:
+	iLight *mpLight;
+	tString msName;
+	cVector3f mvPosition;
+	cVector3f mvForward;
+	float mfRadius;
+	bool mbCheckShadow;
+
+	bool mbValid;
+};
+
+//----------------------------------------------
+
+class cLuxLightLevelGridEntry
+{
+public:
+	unsigned short mlLight;
+	bool mbUnblocked; //True if static geometry does not block the light anywhere in the cell.
+};
+
+//----------------------------------------------
+
+class cLuxLightLevelGridCell
+{
+public:
+	int mlFirstEntry;
+	int mlEntryNum;
+};
+
+//----------------------------------------------
+
+class cLuxLightLevelGridDynamicLight
+{
+public:
+	iLight *mpLight;
+	cVector3f mvMin;
+	cVector3f mvMax;
+};
+
+//----------------------------------------------
+
+class cLuxLightLevelGridNode
+{
+public:
+	cVector3f mvMin;
+	cVector3f mvMax;
+	int mlFirst; //First light if leaf, else first child (the other child is next to it).
+	int mlLightNum; //0 if not a leaf.
+};
+
+//----------------------------------------------
+
+/**
+ * Speeds up light level checks by saving what static lights affect which part of the map.
+ * Static lights (lights that are static and not attached to anything) are baked into a sparse grid
+ * when the map is entered. For shadow casting lights, every cell is tested at 27 points and cells where
+ * static geometry blocks none of them need no line of sight check when looked up. The grid is 
+ * cached next to the map file. All other lights, and static lights that have been moved, are put 
+ * in a small BVH that is rebuilt once per frame.
+ */
+class cLuxLightLevelGrid
+{
+public:
+	cLuxLightLevelGrid();
+	~cLuxLightLevelGrid();
+
+	void Build(cLuxMap *apMap);
+	void Clear();
+
+	bool IsBuiltForWorld(cWorld *apWorld){ return mpWorld == apWorld && mpWorld != NULL;}
+
+	/**
+	 * Must be called every frame so that moving lights are updated.
+	 */
+	void SetDynamicLightsDirty(){ mbDynamicLightsDirty = true;}
+
+	/**
+	 * Gets all visible lights that contain the position.
+	 */
+	void GetLightsAtPos(const cVector3f& avPos, tLuxLightLevelSampleVec &avSamples);
+
+	static bool LightContainsPoint(iLight *apLight, const cVector3f& avPos);
+
+private:
+	bool IsBakeableLight(iLight *apLight);
+	void GetBakeBounds(const cLuxLightLevelGridLight& aLight, cVector3f &avMin, cVector3f &avMax);
+
+	void BakeLights();
+	bool LoadCache(const tWString& asFile);
+	void SaveCache(const tWString& asFile);
+
+	int GetCellIndex(int alX, int alY, int alZ);
+
+	void UpdateDynamicLights();
+	void BuildDynamicNode(int alNode, int alFirst, int alLightNum);
+	
+	cWorld *mpWorld;
+	
+	std::vector<cLuxLightLevelGridLight> mvLights;
+	std::map<iLight*, int> m_mapLightIndices;
+
+	cVector3f mvGridOrigin;
+	cVector3l mvBlockNum;
+	std::vector<int> mvBlocks; //Index of first cell in block, -1 if empty.
+	std::vector<cLuxLightLevelGridCell> mvCells;
+	std::vector<cLuxLightLevelGridEntry> mvEntries;
+
+	bool mbDynamicLightsDirty;
+	std::vector<cLuxLightLevelGridDynamicLight> mvDynamicLights;
+	std::vector<cLuxLightLevelGridNode> mvDynamicNodes;
+};
+
+//----------------------------------------------
+
+#endif // LUX_LIGHT_LEVEL_GRID_H
@@ -23,8 +23,118 @@
 #include "LuxInputHandler.h"
 #include "LuxProgressLogHandler.h"
 
-//////////////////////////////////////////////
-// TODO - add a snapshot view?
+#include "system/Semaphore.h"
+
+//-----------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////
+// SNAPSHOT LOADER
+//////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------
+
+cLuxSnapshotLoader::cLuxSnapshotLoader()
+{
+	mpThread = NULL;
+	mpMutex = cPlatform::CreateMutEx();
+	mpSemaphore = cPlatform::CreateSemaPhore(0);
+	mbExiting = false;
+
+	mbHasRequest = false;
+	mpLoadedBitmap = NULL;
+}
+
+cLuxSnapshotLoader::~cLuxSnapshotLoader()
+{
+	//Wake the thread up so it can see that we are exiting.
+	if(mpThread)
+	{
+		mpMutex->Lock();
+		mbExiting = true;
+		mpMutex->Unlock();
+		mpSemaphore->Signal();
+
+		mpThread->Stop();
+		hplDelete(mpThread);
+	}
+
+	if(mpLoadedBitmap) hplDelete(mpLoadedBitmap);
+
+	hplDelete(mpSemaphore);
+	hplDelete(mpMutex);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxSnapshotLoader::Request(const tWString& asFile)
+{
+	if(mpThread==NULL)
+	{
+		mpThread = cPlatform::CreateThread(this);
+		mpThread->SetPriority(eThreadPrio_Low);
+		mpThread->SetSleepTime(0);
+		mpThread->Start();
+	}
+
+	mpMutex->Lock();
+	mbHasRequest = true;
+	msRequestedFile = asFile;
+	mpMutex->Unlock();
+
+	mpSemaphore->Signal();
+}
+
+//-----------------------------------------------------------------------
+
+cBitmap* cLuxSnapshotLoader::PopLoadedBitmap(tWString& asFile)
+{
+	mpMutex->Lock();
+	cBitmap *pBitmap = mpLoadedBitmap;
+	asFile = msLoadedFile;
+	mpLoadedBitmap = NULL;
+	mpMutex->Unlock();
+
+	return pBitmap;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxSnapshotLoader::UpdateThread()
+{
+	mpSemaphore->Wait();
+
+	/////////////////////////
+	// Get request
+	mpMutex->Lock();
+	if(mbExiting)
+	{
+		mpMutex->Unlock();
+		mpSemaphore->Signal();
+		return;
+	}
+	if(mbHasRequest==false)
+	{
+		mpMutex->Unlock();
+		return;
+	}
+	tWString sFile = msRequestedFile;
+	mbHasRequest = false;
+	mpMutex->Unlock();
+
+	/////////////////////////
+	// Load (file decoding is the slow part)
+	cBitmap *pBitmap = NULL;
+	if(cPlatform::FileExists(sFile))
+		pBitmap = gpBase->mpEngine->GetResources()->GetBitmapLoaderHandler()->LoadBitmap(sFile,0);
+
+	/////////////////////////
+	// Hand over, replacing any result that was never picked up
+	mpMutex->Lock();
+	if(mpLoadedBitmap) hplDelete(mpLoadedBitmap);
+	mpLoadedBitmap = pBitmap;
+	msLoadedFile = sFile;
+	mpMutex->Unlock();
+}
 
 //-----------------------------------------------------------------------
 
@@ -37,6 +147,8 @@
 cLuxMainMenu_LoadGame::cLuxMainMenu_LoadGame(cGuiSet *apGuiSet, cGuiSkin *apGuiSkin) : iLuxMainMenuWindow(apGuiSet, apGuiSkin)
 {
 	mvWindowSize = cVector2f(600,440);
+
+	mpSnapShotGfx = NULL;
 }
 
 //-----------------------------------------------------------------------
@@ -131,6 +243,7 @@ void cLuxMainMenu_LoadGame::OnSetActive(bool abX)
 {
 	if(abX)
 	{
+		msSnapShotFile = _W("");
 		PopulateSavedGameList();
 
 		mpGuiSet->SetDefaultFocusNavWidget(mpLBSavedGames);
@@ -141,6 +254,10 @@ void cLuxMainMenu_LoadGame::OnSetActive(bool abX)
 			mpLBSavedGames->SetIsLocked(true);
 		}
 	}
+	else
+	{
+		DestroySnapShot();
+	}
 }
 
 //-----------------------------------------------------------------------
@@ -185,6 +302,60 @@ void cLuxMainMenu_LoadGame::PopulateSavedGameList()
 
 //-----------------------------------------------------------------------
 
+void cLuxMainMenu_LoadGame::UpdateSnapShot()
+{
+	/////////////////////////////////
+	// Request the snapshot of the selected save when selection changes
+	int lSelected = mpLBSavedGames->GetSelectedItem();
+	tWString sFile;
+	if(lSelected >= 0 && lSelected < (int)mvSavedGameFileNames.size())
+		sFile = gpBase->mpSaveHandler->GetSnapshotFile(gpBase->msProfileSavePath + mvSavedGameFileNames[lSelected]);
+
+	if(sFile != msSnapShotFile)
+	{
+		msSnapShotFile = sFile;
+		DestroySnapShot();
+		if(sFile != _W("")) mSnapshotLoader.Request(sFile);
+	}
+
+	/////////////////////////////////
+	// Upload finished snapshot, texture creation must be done on this thread
+	tWString sLoadedFile;
+	cBitmap *pBmp = mSnapshotLoader.PopLoadedBitmap(sLoadedFile);
+	if(pBmp==NULL) return;
+
+	if(sLoadedFile == msSnapShotFile)
+	{
+		DestroySnapShot();
+
+		iTexture *pTexture = gpBase->mpEngine->GetGraphics()->GetLowLevel()->CreateTexture(cString::To8Char(sLoadedFile), eTextureType_2D, eTextureUsage_Normal);
+		if(pTexture->CreateFromBitmap(pBmp))
+		{
+			mpSnapShotGfx = gpBase->mpEngine->GetGui()->CreateGfxTexture(pTexture, true, eGuiMaterial_Alpha);
+			mpISavedGameSnapShot->SetImage(mpSnapShotGfx);
+		}
+		else
+		{
+			hplDelete(pTexture);
+		}
+	}
+
+	hplDelete(pBmp);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMainMenu_LoadGame::DestroySnapShot()
+{
+	if(mpSnapShotGfx==NULL) return;
+
+	mpISavedGameSnapShot->SetImage(NULL);
+	gpBase->mpEngine->GetGui()->DestroyGfx(mpSnapShotGfx);
+	mpSnapShotGfx = NULL;
+}
+
+//-----------------------------------------------------------------------
+
 void cLuxMainMenu_LoadGame::LoadGame(int alIdx)
 {
 	ExitCallback(NULL, cGuiMessageData(0));
@@ -203,6 +374,8 @@ void cLuxMainMenu_LoadGame::LoadGame(int alIdx)
 
 bool cLuxMainMenu_LoadGame::WindowOnUpdate(iWidget* apWidget, const cGuiMessageData& aData)
 {
+	UpdateSnapShot();
+
 	return true; 
 }
 kGuiCallbackDeclaredFuncEnd(cLuxMainMenu_LoadGame, WindowOnUpdate);
@@ -26,6 +26,38 @@
 
 //----------------------------------------------
 
+/**
+ * Loads save game snapshots on a thread. Only the latest request is of interest, older ones are skipped.
+ */
+class cLuxSnapshotLoader : public iThreadClass
+{
+public:
+	cLuxSnapshotLoader();
+	~cLuxSnapshotLoader();
+
+	void Request(const tWString& asFile);
+	/**
+	 * Returns the loaded bitmap (caller takes ownership) and sets asFile to the file it was loaded from. NULL if none.
+	 */
+	cBitmap* PopLoadedBitmap(tWString& asFile);
+
+	void UpdateThread();
+
+private:
+	iThread* mpThread;
+	iMutex* mpMutex;
+	iSemaphore* mpSemaphore;
+	bool mbExiting;
+
+	bool mbHasRequest;
+	tWString msRequestedFile;
+
+	cBitmap* mpLoadedBitmap;
+	tWString msLoadedFile;
+};
+
+//----------------------------------------------
+
 class cLuxMainMenu_LoadGame : public iLuxMainMenuWindow
 {
 	friend class cLuxInputMenuEntry;
@@ -42,12 +74,19 @@ private:
 
 	void PopulateSavedGameList();
 
+	void UpdateSnapShot();
+	void DestroySnapShot();
+
 	////////////////////////
 	// Properties
 	cVector2f mvWindowSize;
 
 	tWStringVec mvSavedGameFileNames;
 
+	cLuxSnapshotLoader mSnapshotLoader;
+	tWString msSnapShotFile;
+	cGuiGfxElement* mpSnapShotGfx;
+
 	////////////////////////
 	// Layout
 	cWidgetListBox* mpLBSavedGames;
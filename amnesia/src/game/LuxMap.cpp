@@ -88,6 +88,8 @@ cLuxMap::cLuxMap(const tString& asName)
 	mbDeletingAllWorldEntities = false;
 
 	mbCommentaryIconsActive = false;
+
+	mbEntityNameIndexBuilt = false;
 }
 
 //-----------------------------------------------------------------------
@@ -572,6 +574,7 @@ void cLuxMap::DestroyAllEntities()
 	
 	m_mapEntitiesByID.clear();
 	m_mapEntitiesByName.clear();
+	InvalidateEntityNameIndex();
 	mlstToBeDestroyedEntities.clear();
 	mpLatestAddedEntity = NULL;
 	mlstEnemies.clear();
@@ -587,6 +590,7 @@ void cLuxMap::AddEntity(iLuxEntity *apEntity)
 	m_mapEntitiesByName.insert(tLuxEntityNameMap::value_type(cString::ToLowerCase(apEntity->GetName()), apEntity));
 	m_mapEntitiesByID.insert(tLuxEntityIDMap::value_type(apEntity->GetID(), apEntity));
 	mlstEntities.push_back(apEntity);
+	InvalidateEntityNameIndex();
 
 	mpLatestAddedEntity = apEntity;
 
@@ -628,6 +632,22 @@ iLuxEntity *cLuxMap::GetEntityByName(const tString& asName, eLuxEntityType aType
 	return pEntity;
 }
 
+void cLuxMap::GetEntitiesByWildcard(const tString& asPattern, tLuxEntityList &alstEntities, eLuxEntityType aType, int alSubType)
+{
+	tLuxEntityPatternMapIt it = m_mapWildcardResults.find(asPattern);
+	if(it == m_mapWildcardResults.end())
+	{
+		it = m_mapWildcardResults.insert(tLuxEntityPatternMap::value_type(asPattern, std::vector<iLuxEntity*>())).first;
+		FindEntitiesByWildcard(asPattern, it->second);
+	}
+
+	const std::vector<iLuxEntity*> &vEntities = it->second;
+	for(size_t i=0; i<vEntities.size(); ++i)
+	{
+		if(LuxIsCorrectType(vEntities[i], aType, alSubType)) alstEntities.push_back(vEntities[i]);
+	}
+}
+
 iLuxEntity *cLuxMap::GetEntityByID(int alID, eLuxEntityType aType, int alSubType)
 {
 	tLuxEntityIDMapIt it = m_mapEntitiesByID.find(alID);
@@ -1283,6 +1303,108 @@ int cLuxMap::GetFreeEntityID()
 
 //-----------------------------------------------------------------------
 
+static inline unsigned int GetNameTrigram(const char *apChars)
+{
+	return	((unsigned int)(unsigned char)apChars[0] << 16) |
+			((unsigned int)(unsigned char)apChars[1] << 8) |
+			 (unsigned int)(unsigned char)apChars[2];
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMap::InvalidateEntityNameIndex()
+{
+	if(mbEntityNameIndexBuilt==false && m_mapWildcardResults.empty()) return;
+
+	mbEntityNameIndexBuilt = false;
+	mvNameIndexEntities.clear();
+	m_mapNameIndexTrigrams.clear();
+	m_mapWildcardResults.clear();
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMap::BuildEntityNameIndex()
+{
+	mbEntityNameIndexBuilt = true;
+
+	//////////////////////////
+	// Entities are indexed in list order, so results keep the same order as when iterating the list.
+	mvNameIndexEntities.reserve(mlstEntities.size());
+	for(tLuxEntityListIt entityIt = mlstEntities.begin(); entityIt != mlstEntities.end(); ++entityIt)
+	{
+		int lIdx = (int)mvNameIndexEntities.size();
+		mvNameIndexEntities.push_back(*entityIt);
+
+		//////////////////////////
+		// Add to the list of every three char sequence in the name
+		const tString& sName = (*entityIt)->GetName();
+		for(size_t i=0; i+3<=sName.size(); ++i)
+		{
+			std::vector<int> &vIndices = m_mapNameIndexTrigrams[GetNameTrigram(&sName[i])];
+			if(vIndices.empty() || vIndices.back() != lIdx) vIndices.push_back(lIdx);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMap::FindEntitiesByWildcard(const tString& asPattern, std::vector<iLuxEntity*> &avEntities)
+{
+	if(mbEntityNameIndexBuilt==false) BuildEntityNameIndex();
+
+	//////////////////////////
+	// Get the parts between the '*', empty parts are skipped.
+	tStringVec vParts;
+	size_t lStart = 0;
+	while(lStart <= asPattern.size())
+	{
+		size_t lEnd = asPattern.find('*', lStart);
+		if(lEnd == tString::npos) lEnd = asPattern.size();
+		if(lEnd > lStart) vParts.push_back(asPattern.substr(lStart, lEnd - lStart));
+		lStart = lEnd+1;
+	}
+
+	//////////////////////////
+	// Use the shortest index list among the three char sequences of the parts as candidates.
+	// If no part is long enough, all entities are candidates.
+	const std::vector<int> *pCandidates = NULL;
+	for(size_t i=0; i<vParts.size(); ++i)
+	{
+		const tString& sPart = vParts[i];
+		for(size_t j=0; j+3<=sPart.size(); ++j)
+		{
+			tLuxEntityTrigramMapIt it = m_mapNameIndexTrigrams.find(GetNameTrigram(&sPart[j]));
+			if(it == m_mapNameIndexTrigrams.end()) return; //No name contains this, so nothing matches.
+
+			if(pCandidates==NULL || it->second.size() < pCandidates->size()) pCandidates = &it->second;
+		}
+	}
+
+	//////////////////////////
+	// Check that each candidate contains all parts
+	size_t lNumCandidates = pCandidates ? pCandidates->size() : mvNameIndexEntities.size();
+	for(size_t i=0; i<lNumCandidates; ++i)
+	{
+		iLuxEntity *pEntity = mvNameIndexEntities[pCandidates ? (*pCandidates)[i] : (int)i];
+		const tString& sName = pEntity->GetName();
+
+		bool bContainsStrings = true;
+		for(size_t j=0; j<vParts.size(); ++j)
+		{
+			if(sName.find(vParts[j]) == tString::npos)
+			{
+				bContainsStrings = false;
+				break;
+			}
+		}
+
+		if(bContainsStrings) avEntities.push_back(pEntity);
+	}
+}
+
+//-----------------------------------------------------------------------
+
 void cLuxMap::UpdateToBeDesotroyedEntities(bool abUseCallbacks)
 {
 	tLuxEntityListIt entityIt = mlstToBeDestroyedEntities.begin();
@@ -1299,6 +1421,7 @@ void cLuxMap::UpdateToBeDesotroyedEntities(bool abUseCallbacks)
 		STLFindAndRemove(mlstEntities, pEntity);
 		STLMapFindAndRemove(m_mapEntitiesByName, pEntity);
 		STLMapFindAndRemove(m_mapEntitiesByID, pEntity);
+		InvalidateEntityNameIndex();
 
 		//Extra remove for enemies
 		if(pEntity->GetEntityType() == eLuxEntityType_Enemy)
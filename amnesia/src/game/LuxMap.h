@@ -112,6 +112,11 @@ public:
 	 */
 	void DestroyEntity(iLuxEntity *apEntity);
 	iLuxEntity *GetEntityByName(const tString& asName, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
+	/**
+	 * Gets entities whose names contain all of the '*' separated parts of asPattern. The matches of a pattern
+	 * are cached until an entity is added or removed.
+	 */
+	void GetEntitiesByWildcard(const tString& asPattern, tLuxEntityList &alstEntities, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
 	iLuxEntity *GetEntityByID(int alID, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
 	iLuxEntity *GetLatestEntity(){ return mpLatestAddedEntity;}
 	void ResetLatestEntity(){ mpLatestAddedEntity=NULL;}
@@ -194,6 +199,10 @@ private:
 
 	int GetFreeEntityID();
 
+	void InvalidateEntityNameIndex();
+	void BuildEntityNameIndex();
+	void FindEntitiesByWildcard(const tString& asPattern, std::vector<iLuxEntity*> &avEntities);
+
 	void UpdateToBeDesotroyedEntities(bool abUseCallbacks);
 	void UpdateTimers(float afTimeStep);
 	void UpdateDissolveEntities(float afTimeStep);
@@ -244,6 +253,11 @@ private:
 	iLuxEntity *mpLatestAddedEntity;
 	tLuxArea_StickyList mlstStickyAreas;
 
+	bool mbEntityNameIndexBuilt;
+	std::vector<iLuxEntity*> mvNameIndexEntities;
+	tLuxEntityTrigramMap m_mapNameIndexTrigrams;
+	tLuxEntityPatternMap m_mapWildcardResults;
+
 	tLuxPlayerStartMap m_mapPlayerStartNodes;
 	std::vector<cLuxNode_PlayerStart*> mvPlayerStartNodes;
 
@@ -251,13 +251,28 @@ void cLuxMapHelper::OnStart()
 
 void cLuxMapHelper::Update(float afTimeStep)
 {
+	mLightLevelGrid.SetDynamicLightsDirty();
 }
 
 //-----------------------------------------------------------------------
 
 void cLuxMapHelper::Reset()
 {
+	mLightLevelGrid.Clear();
+}
+
+//-----------------------------------------------------------------------
 
+void cLuxMapHelper::OnMapEnter(cLuxMap *apMap)
+{
+	mLightLevelGrid.Build(apMap);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMapHelper::OnMapLeave(cLuxMap *apMap)
+{
+	mLightLevelGrid.Clear();
 }
 
 //-----------------------------------------------------------------------
@@ -463,6 +478,91 @@ bool cLuxMapHelper::CheckLineOfSight(const cVector3f& avStart, const cVector3f&
 
 	return mLineOfSightCallback.GetIntersected()==false;
 }
+
+//-----------------------------------------------------------------------
+
+int cLuxMapHelper::CheckLineOfSightBundle(	const cVector3f* apStarts, const cVector3f* apEnds, int alRayNum, int alRequiredFree, 
+											bool abCheckShadows, int *apRaysCast)
+{
+	if(apRaysCast) *apRaysCast = 0;
+	if(alRayNum <= 0) return 0;
+
+	////////////////////////////
+	//Check so there really is a world
+	cLuxMap *pCurrentMap = gpBase->mpMapHandler->GetCurrentMap();
+	if(pCurrentMap==NULL) return 0;
+
+	iPhysicsWorld *pPhysicsWorld = pCurrentMap->GetPhysicsWorld();
+
+	////////////////////////////
+	//Get the bounds of all rays
+	cVector3f vMin = apStarts[0];
+	cVector3f vMax = apStarts[0];
+	for(int i=0; i<alRayNum; ++i)
+	{
+		vMin = cMath::Vector3Min(vMin, cMath::Vector3Min(apStarts[i], apEnds[i]));
+		vMax = cMath::Vector3Max(vMax, cMath::Vector3Max(apStarts[i], apEnds[i]));
+	}
+
+	cBoundingVolume bundleBV;
+	bundleBV.SetLocalMinMax(vMin, vMax);
+
+	////////////////////////////
+	//Gather bodies and filter them once, using the same filter as a single ray
+	mvLineOfSightBodies.resize(0);
+	pPhysicsWorld->GetBodiesInBV(&bundleBV, &mvLineOfSightBodies);
+
+	mLineOfSightCallback.Reset();
+	mLineOfSightCallback.SetCheckShadow(abCheckShadows);
+
+	size_t lBodyNum =0;
+	for(size_t i=0; i<mvLineOfSightBodies.size(); ++i)
+	{
+		iPhysicsBody *pBody = mvLineOfSightBodies[i];
+		if(pBody->IsActive()==false || mLineOfSightCallback.BeforeIntersect(pBody)==false) continue;
+		
+		mvLineOfSightBodies[lBodyNum++] = pBody;
+	}
+	mvLineOfSightBodies.resize(lBodyNum);
+
+	////////////////////////////
+	//Test each ray against the bodies
+	int lFree =0;
+	for(int ray=0; ray<alRayNum; ++ray)
+	{
+		if(apRaysCast) (*apRaysCast)++;
+
+		const cVector3f &vStart = apStarts[ray];
+		const cVector3f &vEnd = apEnds[ray];
+		cVector3f vRayMin = cMath::Vector3Min(vStart, vEnd);
+		cVector3f vRayMax = cMath::Vector3Max(vStart, vEnd);
+
+		bool bBlocked = false;
+		for(size_t i=0; i<mvLineOfSightBodies.size(); ++i)
+		{
+			iPhysicsBody *pBody = mvLineOfSightBodies[i];
+			cBoundingVolume *pBV = pBody->GetBoundingVolume();
+			if(cMath::CheckAABBIntersection(vRayMin, vRayMax, pBV->GetMin(), pBV->GetMax())==false) continue;
+
+			if(pPhysicsWorld->CheckRayBodyIntersection(pBody, vStart, vEnd))
+			{
+				bBlocked = true;
+				break;
+			}
+		}
+
+		if(bBlocked==false)
+		{
+			lFree++;
+			if(lFree >= alRequiredFree) break;
+		}
+		
+		//Not enough rays left to be a success.
+		if(lFree + (alRayNum - ray - 1) < alRequiredFree) break;
+	}
+
+	return lFree;
+}
 //-----------------------------------------------------------------------
 
 bool cLuxMapHelper::GetClosestEntity(	const cVector3f& avStart,const cVector3f& avDir, float afRayLength,
@@ -529,26 +629,35 @@ float cLuxMapHelper::GetLightLevelAtPos(const cVector3f& avPos, std::vector<iLig
 	
 	////////////////////////////
 	//Setup data
-	tLightList lstIntersectingLights; 
-
 	cWorld *pWorld = pCurrentMap->GetWorld();
-	iPhysicsWorld *pPhysicsWorld = pCurrentMap->GetPhysicsWorld();
 	
 	float fLightLevel =0;
 
 	iLight *pPlayerAmbLight = gpBase->mpPlayer->GetHelperInDarkness()->GetAmbientLight();
 	
 	////////////////////////////
-	//Get lights from world
-	GetLightsAtNode(pWorld->GetRenderableContainer(eWorldContainerType_Static)->GetRoot(), lstIntersectingLights, avPos);
-	GetLightsAtNode(pWorld->GetRenderableContainer(eWorldContainerType_Dynamic)->GetRoot(), lstIntersectingLights, avPos);
+	//Get lights from the light level grid, or from world if not built
+	mvLightLevelSamples.resize(0);
+	if(mLightLevelGrid.IsBuiltForWorld(pWorld))
+	{
+		mLightLevelGrid.GetLightsAtPos(avPos, mvLightLevelSamples);
+	}
+	else
+	{
+		tLightList lstIntersectingLights; 
+		GetLightsAtNode(pWorld->GetRenderableContainer(eWorldContainerType_Static)->GetRoot(), lstIntersectingLights, avPos);
+		GetLightsAtNode(pWorld->GetRenderableContainer(eWorldContainerType_Dynamic)->GetRoot(), lstIntersectingLights, avPos);
+		
+		for(tLightListIt it = lstIntersectingLights.begin(); it != lstIntersectingLights.end(); ++it)
+			mvLightLevelSamples.push_back(cLuxLightLevelSample(*it, -1.0f));
+	}
 
 	////////////////////////////
 	//Iterate lights and get lightlevel from each
-	tLightListIt it = lstIntersectingLights.begin();
-	for(; it != lstIntersectingLights.end(); ++it)
+	for(size_t sample=0; sample<mvLightLevelSamples.size(); ++sample)
 	{
-		iLight *pLight = *it;
+		iLight *pLight = mvLightLevelSamples[sample].mpLight;
+		float fVisibility = mvLightLevelSamples[sample].mfVisibility;
 
 		if(pLight == pPlayerAmbLight) continue;
 		
@@ -580,8 +689,8 @@ float cLuxMapHelper::GetLightLevelAtPos(const cVector3f& avPos, std::vector<iLig
 		//Spot and Point
 		else
 		{
-			//Check line of sight
-			if(	pLight->GetLightType() == eLightType_Spot && pLight->GetCastShadows() &&
+			//Check line of sight, unless already known
+			if(	fVisibility < 0 && pLight->GetLightType() == eLightType_Spot && pLight->GetCastShadows() &&
 				CheckLineOfSight(pLight->GetWorldPosition(),avPos, true)==false)
 			{
 				continue;
@@ -589,6 +698,7 @@ float cLuxMapHelper::GetLightLevelAtPos(const cVector3f& avPos, std::vector<iLig
 
 			//Get highest value of rg b
 			float fAmount = GetMaxRGB(pLight->GetDiffuseColor());
+			if(fVisibility >= 0) fAmount *= fVisibility;
 
 			//Get distance to the light
 			float fDist = cMath::Vector3Dist(pLight->GetWorldPosition(), avPos);
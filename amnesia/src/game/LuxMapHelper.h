@@ -23,6 +23,7 @@
 //----------------------------------------------
 
 #include "LuxBase.h"
+#include "LuxLightLevelGrid.h"
 
 //----------------------------------------------
 
@@ -103,6 +104,9 @@ public:
 	void Update(float afTimeStep);
 	void Reset();
 
+	void OnMapEnter(cLuxMap *apMap);
+	void OnMapLeave(cLuxMap *apMap);
+
 	bool ShapeDamage(	iCollideShape *apShape, const cMatrixf& a_mtxTransform, const cVector3f &avOrigin,
 						float afMinDamage, float afMaxDamage, float afForce, float afMaxImpulse,
 						int alStrength, float afHitSpeed, eLuxDamageType aDamageType,eLuxWeaponHitType aWeaponHitType,
@@ -110,6 +114,15 @@ public:
 						bool *apHitPlayer=NULL);
 
 	bool CheckLineOfSight(const cVector3f& avStart, const cVector3f& avEnd, bool abCheckShadows);
+	
+	/**
+	 * Checks many rays at once, the bodies in the area of all rays are gathered and filtered once and then
+	 * each ray is tested against them. Stops as soon as alRequiredFree rays are free or it is no longer possible.
+	 * \param apRaysCast set to the number of rays actually tested.
+	 * \return the number of rays with a free line of sight.
+	 */
+	int CheckLineOfSightBundle(	const cVector3f* apStarts, const cVector3f* apEnds, int alRayNum, int alRequiredFree, 
+								bool abCheckShadows, int *apRaysCast=NULL);
 
 	bool GetClosestEntity(	const cVector3f& avStart,const cVector3f& avDir, float afRayLength,
 							float *afDistance, iPhysicsBody** apBody, iLuxEntity **apEntity);
@@ -122,6 +135,11 @@ public:
 private:
 	void GetLightsAtNode(iRenderableContainerNode *apNode, tLightList &alstLights, const cVector3f& avPos);	
 
+	std::vector<iPhysicsBody*> mvLineOfSightBodies;
+
+	cLuxLightLevelGrid mLightLevelGrid;
+	tLuxLightLevelSampleVec mvLightLevelSamples;
+
 	cLuxLineOfSightCallback mLineOfSightCallback;
 	cLuxClosestEntityCallback mClosestEntityCallback;
 	cLuxClosestCharColliderCallback mClosestharColliderCallback;
@@ -87,15 +87,20 @@ void cLuxSaveHandlerThreadClass::SetUpThread()
 
 //-----------------------------------------------------------------------
 
-void cLuxSaveHandlerThreadClass::Save(cLuxSaveGame_SaveData* apSaveData, const tWString& asFile)
+void cLuxSaveHandlerThreadClass::Save(cLuxSaveGame_SaveData* apSaveData, const tWString& asFile, cBitmap* apSnapshot, const tWString& asSnapshotFile)
 {
 	if(apSaveData==NULL)
+	{
+		if(apSnapshot) hplDelete(apSnapshot);
 		return;
+	}
 
 	mpSaveMutex->Lock();
 
 	mvSaveData.push_back(apSaveData);
 	mvSaveFileNames.push_back(asFile);
+	mvSnapshots.push_back(apSnapshot);
+	mvSnapshotFileNames.push_back(asSnapshotFile);
 
 	mpSaveMutex->Unlock();
 }
@@ -106,15 +111,21 @@ void cLuxSaveHandlerThreadClass::ProcessPendingSaves()
 {
 	std::vector<cLuxSaveGame_SaveData*> vSaveDataCopy;
 	std::vector<tWString> vSaveFileNamesCopy;
+	std::vector<cBitmap*> vSnapshotsCopy;
+	std::vector<tWString> vSnapshotFileNamesCopy;
 
 	mpSaveMutex->Lock();
 	if(mvSaveData.empty()==false)
 	{
 		vSaveDataCopy = mvSaveData;
 		vSaveFileNamesCopy = mvSaveFileNames;
+		vSnapshotsCopy = mvSnapshots;
+		vSnapshotFileNamesCopy = mvSnapshotFileNames;
 
 		mvSaveData.clear();
 		mvSaveFileNames.clear();
+		mvSnapshots.clear();
+		mvSnapshotFileNames.clear();
 	}
 	mpSaveMutex->Unlock();
 
@@ -127,8 +138,9 @@ void cLuxSaveHandlerThreadClass::ProcessPendingSaves()
 			cLuxSaveGame_SaveData* pData = vSaveDataCopy[i];
 			const tWString& sFile = vSaveFileNamesCopy[i];
 
-			//Need to set saved maps before saving!
+			//Need to set saved maps before saving! Only maps changed since last save are serialized again.
 			pData->mpSavedMaps = gpBase->mpMapHandler->GetSavedMapCollection();
+			pData->mpSavedMaps->UpdateSerializeCache();
 
 			cSerializeClass::SaveToFile(pData,sFile,"SaveGame");
 
@@ -136,6 +148,18 @@ void cLuxSaveHandlerThreadClass::ProcessPendingSaves()
 		}
 	}
 	pMutex->Unlock();
+
+	////////////////////////////////
+	// Encode and write snapshots, does not need the saved game lock
+	cBitmapLoaderHandler *pBitmapLoaderHandler = gpBase->mpEngine->GetResources()->GetBitmapLoaderHandler();
+	for(int i=0;i<(int)vSnapshotsCopy.size();++i)
+	{
+		cBitmap *pBmp = vSnapshotsCopy[i];
+		if(pBmp==NULL) continue;
+
+		pBitmapLoaderHandler->SaveBitmap(pBmp,vSnapshotFileNamesCopy[i],0);
+		hplDelete(pBmp);
+	}
 }
 
 //-----------------------------------------------------------------------
@@ -159,6 +183,7 @@ cLuxSaveHandler::cLuxSaveHandler() : iLuxUpdateable("LuxSaveHandler")
 	mbStartThread = false;
 
 	mlMaxAutoSaves =  gpBase->mpGameCfg->GetInt("Saving","MaxAutoSaves",20);
+	mvSnapshotSize = gpBase->mpGameCfg->GetVector2l("Saving","SnapshotSize",cVector2l(256,256));
 	mlSaveNameCount =0;
 }
 
@@ -206,27 +231,36 @@ void cLuxSaveHandler::SaveGameToFile(const tWString& asFile, bool abSaveSnapshot
 
 	cLuxSaveGame_SaveData* pData = CreateSaveGameData();
 
+	////////////////////////////////
+	// Snapshot, the frame buffer must be read here but is shrunk right away so encoding is cheap
+	cBitmap *pSnapshot = NULL;
+	tWString sSnapshotFile;
+	if(abSaveSnapshot)
+	{
+		sSnapshotFile = GetSnapshotFile(asFile);
+
+		cBitmap *pFullBmp = gpBase->mpEngine->GetGraphics()->GetLowLevel()->CopyFrameBufferToBitmap();
+		pSnapshot = pFullBmp->CreateDownscaledCopy(mvSnapshotSize);
+		if(pSnapshot)	hplDelete(pFullBmp);
+		else			pSnapshot = pFullBmp;
+	}
+
+	////////////////////////////////
+	// Save data and snapshot
 	if(mSaveHandlerThreadClass.IsRunning())
-		mSaveHandlerThreadClass.Save(pData, asFile);
+		mSaveHandlerThreadClass.Save(pData, asFile, pSnapshot, sSnapshotFile);
 	else
 	{
 		pData->mpSavedMaps = gpBase->mpMapHandler->GetSavedMapCollection();
+		pData->mpSavedMaps->UpdateSerializeCache();
 		cSerializeClass::SaveToFile(pData,asFile,"SaveGame");
 		hplDelete(pData);
-	}
-
 
-	// Save snapshot?
-	if(abSaveSnapshot)
-	{
-		tWString sFileExt = cString::GetFileExtW(asFile);
-		tWString sFileName = cString::SubW(asFile,0, (int)asFile.size()-((int)sFileExt.size()+1)) +  _W(".jpg");
-		
-		cEngine *pEngine = gpBase->mpEngine;
-		
-		cBitmap *pBmp = pEngine->GetGraphics()->GetLowLevel()->CopyFrameBufferToBitmap();
-		pEngine->GetResources()->GetBitmapLoaderHandler()->SaveBitmap(pBmp,sFileName,0);
-		hplDelete(pBmp);
+		if(pSnapshot)
+		{
+			gpBase->mpEngine->GetResources()->GetBitmapLoaderHandler()->SaveBitmap(pSnapshot,sSnapshotFile,0);
+			hplDelete(pSnapshot);
+		}
 	}
 
 	Log("-------- END SAVE ---------\n");
@@ -520,6 +554,14 @@ tWString cLuxSaveHandler::GetProperSaveName(const tWString &asFile)
 
 //-----------------------------------------------------------------------
 
+tWString cLuxSaveHandler::GetSnapshotFile(const tWString& asFile)
+{
+	tWString sFileExt = cString::GetFileExtW(asFile);
+	return cString::SubW(asFile,0, (int)asFile.size()-((int)sFileExt.size()+1)) +  _W(".jpg");
+}
+
+//-----------------------------------------------------------------------
+
 //////////////////////////////////////////////////////////////////////////
 // PRIVATE METHODS
 //////////////////////////////////////////////////////////////////////////
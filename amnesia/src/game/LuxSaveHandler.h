@@ -39,7 +39,10 @@ public:
 	bool IsRunning();
 
 	void SetUpThread();
-	void Save(cLuxSaveGame_SaveData* apSaveData, const tWString& asFile);
+	/**
+	 * apSnapshot is optional and is encoded and written to asSnapshotFile on the thread. The class takes ownership of it.
+	 */
+	void Save(cLuxSaveGame_SaveData* apSaveData, const tWString& asFile, cBitmap* apSnapshot=NULL, const tWString& asSnapshotFile=_W(""));
 
 	void ProcessPendingSaves();
 
@@ -50,6 +53,8 @@ protected:
 	iThread* mpThread;
 	std::vector<cLuxSaveGame_SaveData*> mvSaveData;
 	tWStringVec mvSaveFileNames;
+	std::vector<cBitmap*> mvSnapshots;
+	tWStringVec mvSnapshotFileNames;
 };
 
 //----------------------------------------------
@@ -83,6 +88,7 @@ public:
 	void LoadSaveGameData(cLuxSaveGame_SaveData *apSave);
 
 	tWString GetProperSaveName(const tWString& asFile);
+	tWString GetSnapshotFile(const tWString& asFile);
 
 	cLuxSaveHandlerThreadClass* GetThreadClass() { return &mSaveHandlerThreadClass; }
 private:
@@ -96,6 +102,7 @@ private:
 	cDate mLatestSaveDate;
 	int mlMaxAutoSaves;
 	int mlSaveNameCount;
+	cVector2l mvSnapshotSize;
 
 	cLuxSaveHandlerThreadClass mSaveHandlerThreadClass;
 };
@@ -32,6 +32,8 @@
 #include "LuxPlayer.h"
 #include "LuxInteractConnections.h"
 
+#include "impl/tinyXML/tinyxml.h"
+
 //////////////////////////////////////////////////////////////////////////
 // ENTITY
 //////////////////////////////////////////////////////////////////////////
@@ -211,12 +213,14 @@ void cLuxSavedGameEnemy::ToEnemy(cLuxMap *apMap, iLuxEnemy *apEnemy)
 
 cLuxSavedGameMap::cLuxSavedGameMap()
 {
-
+	mpSerializeCache = NULL;
+	mbSerializeCacheChanged = true;
 }
 
 cLuxSavedGameMap::~cLuxSavedGameMap()
 {
     DestroyAll();
+	DestroySerializeCache();
 }
 
 //-----------------------------------------------------------------------
@@ -1081,6 +1085,38 @@ bool cLuxSavedGameMap::EntitySaveDataExists(int alID)
 	return false;
 }
 
+//-----------------------------------------------------------------------
+
+void cLuxSavedGameMap::UpdateSerializeCache()
+{
+	if(mpSerializeCache && mbSerializeCacheChanged==false) return;
+
+	DestroySerializeCache();
+
+	//Cache is NULL here, so all members are saved. The holder element is kept and the map element is its only child.
+	mpSerializeCache = hplNew( TiXmlElement, ("cache") );
+	cSerializeClass::SaveToElement(this, "", mpSerializeCache, true);
+
+	mbSerializeCacheChanged = false;
+}
+
+//-----------------------------------------------------------------------
+
+const TiXmlElement* cLuxSavedGameMap::Serialize_GetCachedElement()
+{
+	if(mpSerializeCache==NULL || mbSerializeCacheChanged) return NULL;
+
+	return mpSerializeCache->FirstChildElement();
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxSavedGameMap::DestroySerializeCache()
+{
+	if(mpSerializeCache) hplDelete(mpSerializeCache);
+	mpSerializeCache = NULL;
+}
+
 
 //-----------------------------------------------------------------------
 
@@ -1125,6 +1161,7 @@ void cLuxSavedGameMapCollection::SaveMap(cLuxMap *apMap)
 
 	pSavedMap->DestroyAll();
 	pSavedMap->FromMap(apMap);
+	pSavedMap->SetChanged();
 	//cSerializeClass::SaveToFile(pSavedMap, cString::To16Char(apMap->GetName())+_W(".testsave"), "SavedMap");
 }
 
@@ -1160,7 +1197,12 @@ cLuxSavedGameMap* cLuxSavedGameMapCollection::GetSavedMap(const tString& asName,
 	while(it.HasNext())
 	{
 		cLuxSavedGameMap *pSaveMap = it.Next();
-		if(pSaveMap->msName == asName) return pSaveMap;
+		if(pSaveMap->msName == asName)
+		{
+			//Caller wants to write to it, so the cached save must be rebuilt.
+			if(abCreateNew) pSaveMap->SetChanged();
+			return pSaveMap;
+		}
 	}
 
 	if(abCreateNew==false) return NULL;
@@ -1173,6 +1215,17 @@ cLuxSavedGameMap* cLuxSavedGameMapCollection::GetSavedMap(const tString& asName,
 
 //-----------------------------------------------------------------------
 
+void cLuxSavedGameMapCollection::UpdateSerializeCache()
+{
+	cContainerListIterator<cLuxSavedGameMap*> it = mlstMaps.GetIterator();
+	while(it.HasNext())
+	{
+		it.Next()->UpdateSerializeCache();
+	}
+}
+
+//-----------------------------------------------------------------------
+
 //////////////////////////////////////////////////////////////////////////
 // SERIALIZABLE
 //////////////////////////////////////////////////////////////////////////
@@ -35,6 +35,7 @@
 class iLuxEntity_SaveData;
 class iLuxInteractConnection_SaveData;
 class cLuxMap;
+class TiXmlElement;
 
 //----------------------------------------------
 
@@ -101,6 +102,14 @@ public:
 
 	void FromMap(cLuxMap *apMap);
 	void ToMap(cLuxMap *apMap);
+
+	/**
+	 * Call when the data has been altered, so the cached save element is rebuilt on next save.
+	 */
+	void SetChanged(){ mbSerializeCacheChanged = true;}
+	void UpdateSerializeCache();
+
+	const TiXmlElement* Serialize_GetCachedElement();
 	
 	tString msName;
 	tString msDisplayNameEntry;
@@ -151,6 +160,10 @@ public:
 	cContainerList<int> mlstUnlitLamps;
 private:
 	bool EntitySaveDataExists(int alID);
+	void DestroySerializeCache();
+
+	TiXmlElement *mpSerializeCache;
+	bool mbSerializeCacheChanged;
 };
 
 //----------------------------------------------
@@ -169,7 +182,15 @@ public:
 
 	bool MapExists(const tString& asName);
 	
+	/**
+	 * If abCreateNew is true, the map is assumed to be altered and is marked as changed.
+	 */
 	cLuxSavedGameMap* GetSavedMap(const tString& asName, bool abCreateNew);
+
+	/**
+	 * Rebuilds the cached save elements of the maps that have changed since last save.
+	 */
+	void UpdateSerializeCache();
 	
 public:
 	cContainerList<cLuxSavedGameMap*> mlstMaps;
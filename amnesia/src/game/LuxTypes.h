@@ -520,6 +520,12 @@ typedef tLuxEntityList::iterator tLuxEntityListIt;
 
 typedef cSTLIterator<iLuxEntity*, tLuxEntityList, tLuxEntityListIt> cLuxEntityIterator;
 
+typedef std::map<unsigned int, std::vector<int> > tLuxEntityTrigramMap;
+typedef tLuxEntityTrigramMap::iterator tLuxEntityTrigramMapIt;
+
+typedef std::map<tString, std::vector<iLuxEntity*> > tLuxEntityPatternMap;
+typedef tLuxEntityPatternMap::iterator tLuxEntityPatternMapIt;
+
 //----------------------------------------------
 
 class iLuxEnemy;